@@ -1,4 +1,6 @@
 #include <bits/stdc++.h>
+#include "aura_matrix.h"
+#include "aura_hex.h"
 using namespace std;
 
 static constexpr int ROWS = 512;
@@ -9,7 +11,9 @@ static constexpr float SCALE = 1.0f / sqrt((float)COLS);   // same as FP32
 // -----------------------------------------------------
 // Read INT8 .mem  (MSB-first byte order per line)
 // -----------------------------------------------------
-vector<vector<int8_t>> read_int8_mem(const string &filename) {
+Matrix<int8_t> read_int8_mem(const string &filename) {
+    StatScope scope("parse");
+    stats_count_file(filename);
     ifstream fin(filename);
     if (!fin) throw runtime_error("Cannot open " + filename);
 
@@ -27,37 +31,24 @@ vector<vector<int8_t>> read_int8_mem(const string &filename) {
     if (data.size() != ROWS * COLS)
         throw runtime_error("Unexpected number of int8 values in " + filename);
 
-    vector<vector<int8_t>> M(ROWS, vector<int8_t>(COLS));
-    for (int r = 0; r < ROWS; ++r)
-        for (int c = 0; c < COLS; ++c)
-            M[r][c] = data[r * COLS + c];
-
-    return M;
+    return Matrix<int8_t>::from_flat(data.data(), ROWS, COLS);
 }
 
 // -----------------------------------------------------
 // Write INT8 .mem (LSB-first in 64-bit word)
 // -----------------------------------------------------
-void write_int8_mem(const string &filename, const vector<vector<int8_t>> &M) {
-    ofstream fout(filename);
-    if (!fout) throw runtime_error("Cannot open for writing " + filename);
-
-    for (int r = 0; r < ROWS; ++r) {
-        for (int l = 0; l < LINES_PER_ROW; ++l) {
-            uint64_t packed = 0;
-            for (int b = 0; b < 8; ++b) {
-                uint64_t byte = uint64_t(uint8_t(M[r][l*8 + b]));
-                packed |= (byte & 0xFFULL) << (8 * b);  // LSB-first packing
-            }
+void write_int8_mem(const string &filename, const Matrix<int8_t> &M) {
+    HexWriter out(filename, ROWS * LINES_PER_ROW * 17);
 
-            fout << uppercase << hex << setw(16) << setfill('0') << packed << "\n";
-        }
-    }
+    for (int r = 0; r < ROWS; ++r)
+        for (int l = 0; l < LINES_PER_ROW; ++l)
+            out.word64(pack_word(M.row(r) + l * 8));  // LSB-first packing
+    out.close();
 }
 
 
 // Dot product with integer inputs (with float accumulation)
-inline float dot64(const vector<int8_t> &a, const vector<int8_t> &b) {
+inline float dot64(const int8_t *a, const int8_t *b) {
     float s = 0.0f;
     for (int i = 0; i < COLS; ++i)
         s += float(a[i]) * float(b[i]) / 128.f / 128.f;   // convert products to float
@@ -68,6 +59,7 @@ inline float dot64(const vector<int8_t> &a, const vector<int8_t> &b) {
 // Main – int8 full attention
 // -----------------------------------------------------
 int main(int argc, char **argv) {
+    stats_init(argc, argv);
     ios::sync_with_stdio(false);
 
     string qfile = "../mem/Q_8.mem";
@@ -86,14 +78,18 @@ int main(int argc, char **argv) {
         cerr << "Reading V...\n";
         auto V = read_int8_mem(vfile);
 
-        vector<vector<int8_t>> O(ROWS, vector<int8_t>(COLS));
-        vector<float> scores(ROWS), weights(ROWS);
+        Matrix<int8_t> O(ROWS, COLS);
+        ScratchScope scratch;
+        float *scores = scratch.alloc<float>(ROWS), *weights = scratch.alloc<float>(ROWS),
+              *out = scratch.alloc<float>(COLS);
 
         for (int i = 0; i < ROWS; ++i) {
+            StatScope scope("reference");
+            stats_count(STAT_ROWS, 1);
             // attention scores
             float max_score = -numeric_limits<float>::infinity();
             for (int j = 0; j < ROWS; ++j) {
-                float s = dot64(Q[i], K[j]) * SCALE;
+                float s = dot64(Q.row(i), K.row(j)) * SCALE;
                 scores[j] = s;
                 max_score = max(max_score, s);
             }
@@ -109,17 +105,19 @@ int main(int argc, char **argv) {
             for (int j = 0; j < ROWS; ++j) weights[j] /= sumexp;
 
             // weighted sum
-            vector<float> out(COLS, 0.0f);
-            for (int j = 0; j < ROWS; ++j)
+            fill(out, out + COLS, 0.0f);
+            for (int j = 0; j < ROWS; ++j) {
+                const int8_t *vj = V.row(j);
                 for (int d = 0; d < COLS; ++d)
-                    out[d] += weights[j] * (float(V[j][d]) / 128.f);
+                    out[d] += weights[j] * (float(vj[d]) / 128.f);
+            }
 
             // requantize → int8
             for (int d = 0; d < COLS; ++d) {
                 float q = round(out[d] * 128.f);
                 if (q > 127) q = 127;
                 if (q < -128) q = -128;
-                O[i][d] = (int8_t)q;
+                O(i, d) = (int8_t)q;
             }
 
             if (i % 64 == 0)
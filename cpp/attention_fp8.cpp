@@ -0,0 +1,141 @@
+#include <bits/stdc++.h>
+#include "aura_fp8.h"
+#include "aura_matrix.h"
+#include "aura_hex.h"
+using namespace std;
+
+static constexpr int ROWS = 512;
+static constexpr int COLS = 64;
+static constexpr int LINES_PER_ROW = COLS / 8;
+static constexpr float SCALE = 1.0f / sqrt((float)COLS);   // same as FP32
+
+// -----------------------------------------------------
+// Read FP8 .mem (LSB-first in 64-bit word) and decode to float
+// -----------------------------------------------------
+Matrix<float> read_fp8_mem(const string &filename, Fp8Format fmt) {
+    StatScope scope("parse");
+    stats_count_file(filename);
+    ifstream fin(filename);
+    if (!fin) throw runtime_error("Cannot open " + filename);
+
+    vector<uint8_t> codes;
+    string line;
+    while (getline(fin, line)) {
+        line.erase(remove_if(line.begin(), line.end(), ::isspace), line.end());
+        if (line.empty()) continue;
+        uint64_t packed = stoull(line, nullptr, 16);
+        for (int b = 0; b < 8; ++b)
+            codes.push_back((uint8_t)(packed >> (8 * b)));
+    }
+
+    if (codes.size() != ROWS * COLS)
+        throw runtime_error("Unexpected number of FP8 values in " + filename);
+
+    Matrix<float> M(ROWS, COLS);
+    for (int r = 0; r < ROWS; ++r)
+        fp8_to_fp32_n(&codes[r * COLS], M.row(r), COLS, fmt);
+
+    return M;
+}
+
+// -----------------------------------------------------
+// Write INT8 .mem (LSB-first in 64-bit word)
+// -----------------------------------------------------
+void write_int8_mem(const string &filename, const Matrix<int8_t> &M) {
+    HexWriter out(filename, ROWS * LINES_PER_ROW * 17);
+
+    for (int r = 0; r < ROWS; ++r)
+        for (int l = 0; l < LINES_PER_ROW; ++l)
+            out.word64(pack_word(M.row(r) + l * 8));  // LSB-first packing
+    out.close();
+}
+
+inline float dot64(const float *a, const float *b) {
+    float s = 0.0f;
+    for (int i = 0; i < COLS; ++i) s += a[i] * b[i];
+    return s;
+}
+
+// -----------------------------------------------------
+// Main – attention on FP8 decoded inputs, Q0.7 output
+// -----------------------------------------------------
+// The output uses the same Q0.7 packing as O_fixed_correct.mem so that
+// precision_measure can compare FP8-input and Q0.7-input runs directly.
+int main(int argc, char **argv) {
+    stats_init(argc, argv);
+    ios::sync_with_stdio(false);
+
+    if (argc != 6) {
+        cerr << "Usage: " << argv[0]
+             << " <e4m3|e5m2> <Q.mem> <K.mem> <V.mem> <O_int8.mem>\n";
+        return 1;
+    }
+
+    try {
+        Fp8Format fmt = parse_fp8_format(argv[1]);
+        string qfile = argv[2];
+        string kfile = argv[3];
+        string vfile = argv[4];
+        string outfile = argv[5];
+
+        cerr << "Reading Q (" << fp8_name(fmt) << ")...\n";
+        auto Q = read_fp8_mem(qfile, fmt);
+        cerr << "Reading K (" << fp8_name(fmt) << ")...\n";
+        auto K = read_fp8_mem(kfile, fmt);
+        cerr << "Reading V (" << fp8_name(fmt) << ")...\n";
+        auto V = read_fp8_mem(vfile, fmt);
+
+        Matrix<int8_t> O(ROWS, COLS);
+        ScratchScope scratch;
+        float *scores = scratch.alloc<float>(ROWS), *weights = scratch.alloc<float>(ROWS),
+              *out = scratch.alloc<float>(COLS);
+
+        for (int i = 0; i < ROWS; ++i) {
+            StatScope scope("reference");
+            stats_count(STAT_ROWS, 1);
+            float max_score = -numeric_limits<float>::infinity();
+            for (int j = 0; j < ROWS; ++j) {
+                float s = dot64(Q.row(i), K.row(j)) * SCALE;
+                scores[j] = s;
+                max_score = max(max_score, s);
+            }
+
+            float sumexp = 0.0f;
+            for (int j = 0; j < ROWS; ++j) {
+                float e = exp(scores[j] - max_score);
+                weights[j] = e;
+                sumexp += e;
+            }
+            if (sumexp == 0.0f) sumexp = 1e-12f;
+            for (int j = 0; j < ROWS; ++j) weights[j] /= sumexp;
+
+            fill(out, out + COLS, 0.0f);
+            for (int j = 0; j < ROWS; ++j) {
+                const float *vj = V.row(j);
+                for (int d = 0; d < COLS; ++d)
+                    out[d] += weights[j] * vj[d];
+            }
+
+            // requantize → Q0.7
+            for (int d = 0; d < COLS; ++d) {
+                float q = round(out[d] * 128.f);
+                if (q > 127) q = 127;
+                if (q < -128) q = -128;
+                O(i, d) = (int8_t)q;
+            }
+
+            if (i % 64 == 0)
+                cerr << "Computed row " << i << "/" << ROWS << "\n";
+        }
+
+        cerr << "Writing output to " << outfile << "...\n";
+        write_int8_mem(outfile, O);
+        cerr << "Done.\n";
+
+    } catch (const exception &e) {
+        cerr << "ERROR: " << e.what() << endl;
+        return 1;
+    }
+
+    return 0;
+}
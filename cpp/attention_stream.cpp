@@ -0,0 +1,193 @@
+#include "aura_mem.h"
+#include "aura_tensor.h"
+
+// -----------------------------------------------------
+// Out-of-core FP64 attention for very long sequences.
+//
+// K and V are mmapped .bin tensors and are consumed in blocks of --block rows
+// with an online softmax, so the working set is a query tile plus one K/V block
+// per worker whatever the sequence length:
+//   m'   = max(m, max_j s_j)
+//   l'   = l * e^(m - m') + sum_j e^(s_j - m')
+//   acc' = acc * e^(m - m') + sum_j e^(s_j - m') v_j
+//   o    = acc / l
+// Only query rows [begin, end) are evaluated, which keeps golden outputs for
+// 64K-1M token contexts affordable.
+// -----------------------------------------------------
+
+static constexpr int TILE = 16;  // query rows sharing one pass over K/V
+
+struct StreamOptions {
+    size_t block = 4096;
+    int threads = default_threads();
+    size_t begin = 0, end = SIZE_MAX;
+    TensorDType out_dtype = TensorDType::FP32;
+};
+
+static void usage(const char *prog) {
+    cerr << "Usage: " << prog << " [options] <Q.bin> <K.bin> <V.bin> <O.bin|O.mem>\n"
+         << "  --block N        K/V rows per block (default 4096)\n"
+         << "  --rows B:E       only query rows [B, E) (default all)\n"
+         << "  --out fp32|fp64  output dtype for .bin outputs (default fp32)\n"
+         << "  -j N             worker threads (default " << default_threads() << ")\n";
+}
+
+// One tile of query rows against the whole K/V stream
+static void attend_tile(const MappedTensor &Q, const MappedTensor &K, const MappedTensor &V,
+                        size_t q0, int nq, size_t block, double *out) {
+    StatScope stat("reference");
+    stats_count(STAT_ROWS, nq);
+    const size_t dk = K.cols(), n = K.rows();
+    const double scale = 1.0 / sqrt((double)dk);
+
+    // raw FP64 K/V are used in place; other dtypes, and compressed tensors, are
+    // converted (decoded) a block at a time
+    const bool in_place = K.dtype() == TensorDType::FP64 && V.dtype() == TensorDType::FP64 &&
+                          !K.compressed() && !V.compressed();
+    ScratchScope scratch;
+    double *q = scratch.alloc<double>(nq * dk), *s = scratch.alloc<double>(block);
+    double *kbuf = in_place ? nullptr : scratch.alloc<double>(block * dk);
+    double *vbuf = in_place ? nullptr : scratch.alloc<double>(block * dk);
+    double *m = scratch.alloc<double>(nq), *l = scratch.alloc<double>(nq);
+    double *acc = scratch.alloc<double>(nq * dk);
+    fill(m, m + nq, -numeric_limits<double>::infinity());
+    fill(l, l + nq, 0.0);
+    fill(acc, acc + nq * dk, 0.0);
+    Q.read_rows(q0, nq, q);
+
+    for (size_t b0 = 0; b0 < n; b0 += block) {
+        size_t nb = min(block, n - b0);
+        const double *kb, *vb;
+        if (in_place) {
+            kb = K.view<double>().row(b0);
+            vb = V.view<double>().row(b0);
+        } else {
+            K.read_rows(b0, nb, kbuf);
+            V.read_rows(b0, nb, vbuf);
+            kb = kbuf;
+            vb = vbuf;
+        }
+
+        for (int i = 0; i < nq; ++i) {
+            const double *qi = &q[i * dk];
+            double bmax = -numeric_limits<double>::infinity();
+            for (size_t j = 0; j < nb; ++j) {
+                const double *kj = &kb[j * dk];
+                double dot = 0.0;
+                for (size_t d = 0; d < dk; ++d) dot += qi[d] * kj[d];
+                s[j] = dot * scale;
+                bmax = max(bmax, s[j]);
+            }
+
+            double m_new = max(m[i], bmax);
+            double corr = exp(m[i] - m_new);  // 0 on the first block
+            double *ai = &acc[i * dk];
+            double li = l[i] * corr;
+            for (size_t d = 0; d < dk; ++d) ai[d] *= corr;
+            for (size_t j = 0; j < nb; ++j) {
+                double p = exp(s[j] - m_new);
+                li += p;
+                const double *vj = &vb[j * dk];
+                for (size_t d = 0; d < dk; ++d) ai[d] += p * vj[d];
+            }
+            l[i] = li;
+            m[i] = m_new;
+        }
+    }
+
+    for (int i = 0; i < nq; ++i) {
+        double li = l[i] == 0.0 ? 1e-12 : l[i];
+        for (size_t d = 0; d < dk; ++d) out[i * dk + d] = acc[i * dk + d] / li;
+    }
+}
+
+int main(int argc, char **argv) {
+    stats_init(argc, argv);
+    ios::sync_with_stdio(false);
+
+    StreamOptions o;
+    vector<string> files;
+    try {
+        for (int i = 1; i < argc; ++i) {
+            string a = argv[i];
+            auto need = [&]() -> string {
+                if (i + 1 >= argc) throw runtime_error("Missing value for " + a);
+                return argv[++i];
+            };
+            if (a == "--block") o.block = max<size_t>(1, stoull(need()));
+            else if (a == "--rows") {
+                string r = need();
+                size_t c = r.find(':');
+                if (c == string::npos) throw runtime_error("--rows expects B:E");
+                o.begin = stoull(r.substr(0, c));
+                if (c + 1 < r.size()) o.end = stoull(r.substr(c + 1));
+            }
+            else if (a == "--out") o.out_dtype = parse_dtype(need());
+            else if (a == "-j") o.threads = max(1, stoi(need()));
+            else files.push_back(a);
+        }
+    } catch (const exception &e) {
+        cerr << "ERROR: " << e.what() << "\n";
+        return 1;
+    }
+    if (files.size() != 4) {
+        usage(argv[0]);
+        return 1;
+    }
+
+    try {
+        MappedTensor Q(files[0]), K(files[1]), V(files[2]);
+        const string &outfile = files[3];
+        if (Q.cols() != K.cols() || K.cols() != V.cols() || K.rows() != V.rows())
+            throw runtime_error("Q/K/V shapes do not match");
+        K.advise_sequential();
+        V.advise_sequential();
+
+        const size_t dk = K.cols();
+        o.end = min(o.end, Q.rows());
+        if (o.begin >= o.end) throw runtime_error("Empty query row range");
+        if (o.out_dtype == TensorDType::INT8_Q07) throw runtime_error("--out must be fp32 or fp64");
+        const size_t rows = o.end - o.begin;
+        const int tiles = (int)((rows + TILE - 1) / TILE);
+
+        cerr << "Streaming " << rows << " queries over " << K.rows() << " keys ("
+             << dtype_name(K.dtype()) << ", block " << o.block << ", " << o.threads
+             << " threads)\n";
+
+        bool to_mem = outfile.size() >= 4 && outfile.substr(outfile.size() - 4) == ".mem";
+        if (to_mem && dk != (size_t)AURA_DK) throw runtime_error(".mem output needs 64 columns");
+        vector<float> mem_out(to_mem ? rows * dk : 0);
+        unique_ptr<TensorWriter> writer;
+        if (!to_mem) writer = make_unique<TensorWriter>(outfile, o.out_dtype, rows, dk);
+
+        atomic<int> done{0};
+        parallel_rows(tiles, o.threads, [&](int t) {
+            size_t r0 = (size_t)t * TILE;
+            int nq = (int)min<size_t>(TILE, rows - r0);
+            const size_t count = nq * dk;
+            ScratchScope scratch;
+            double *out = scratch.alloc<double>(count);
+            attend_tile(Q, K, V, o.begin + r0, nq, o.block, out);
+
+            if (to_mem) {
+                copy(out, out + count, mem_out.begin() + r0 * dk);
+            } else if (o.out_dtype == TensorDType::FP64) {
+                writer->write_rows(r0, nq, out);
+            } else {
+                float *f = scratch.alloc<float>(count);
+                copy(out, out + count, f);
+                writer->write_rows(r0, nq, f);
+            }
+            int d = ++done;
+            if (d % 64 == 0) cerr << "Computed tile " << d << "/" << tiles << "\n";
+        });
+
+        if (to_mem) write_fp32_mem(outfile, mem_out);
+        cerr << "Done.\n";
+
+    } catch (const exception &e) {
+        cerr << "ERROR: " << e.what() << "\n";
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,233 @@
+#include "aura_mem.h"
+#include "aura_attribution.h"
+#include "aura_reference.h"
+#include "aura_metrics.h"
+
+// -----------------------------------------------------
+// Which datapath stage does the error come from?
+//
+// Runs the fixed-point model with every combination of exact and RTL stages
+// (aura_attribution.h) over the same Q0.7 inputs and compares each against the
+// reference. Reports the metrics of every combination, each stage's Shapley
+// contribution to MAE / RMSE / top-1 (overall and, with --rows, per row), and
+// for every row the first stage, in datapath order, after which the row's
+// error exceeds --tol.
+// -----------------------------------------------------
+
+struct AttribOptions {
+    string q, k, v;
+    string expected;   // reference .mem (default: fp64 attention of the Q0.7 inputs)
+    string rows_csv;   // per-row report
+    int row = -1;      // detailed report for one row
+    int tol = 1;       // row diverges when its max abs error exceeds tol LSB
+    int threads = default_threads();
+    ModelConfig cfg;
+};
+
+static void usage(const char *prog) {
+    cerr << "Usage: " << prog << " [options]\n"
+         << "  --test NAME           Q/K/V.mem from models/NAME/\n"
+         << "  --q F --k F --v F     Q0.7 inputs\n"
+         << "  --expected F          Q0.7 reference (default: fp64 attention of the inputs)\n"
+         << "  --guard-bits N        extra Log2Exp fraction bits (default 0)\n"
+         << "  --tol N               a row diverges when its max abs error exceeds N LSB (default 1)\n"
+         << "  --row R               show how row R degrades stage by stage\n"
+         << "  --rows FILE           per-row contributions and first divergent stage as CSV\n"
+         << "  -j N                  worker threads (default " << default_threads() << ")\n";
+}
+
+static AttribOptions parse_args(int argc, char **argv) {
+    AttribOptions o;
+    auto need = [&](int &i) -> string {
+        if (i + 1 >= argc) throw runtime_error(string("Missing value for ") + argv[i]);
+        return argv[++i];
+    };
+    for (int i = 1; i < argc; ++i) {
+        string a = argv[i];
+        if (a == "--test") {
+            string dir = "models/" + need(i) + "/";
+            o.q = dir + "Q.mem"; o.k = dir + "K.mem"; o.v = dir + "V.mem";
+        }
+        else if (a == "--q") o.q = need(i);
+        else if (a == "--k") o.k = need(i);
+        else if (a == "--v") o.v = need(i);
+        else if (a == "--expected") o.expected = need(i);
+        else if (a == "--guard-bits") o.cfg.log2e_guard_bits = stoi(need(i));
+        else if (a == "--tol") o.tol = max(0, stoi(need(i)));
+        else if (a == "--row") o.row = stoi(need(i));
+        else if (a == "--rows") o.rows_csv = need(i);
+        else if (a == "-j") o.threads = max(1, stoi(need(i)));
+        else throw runtime_error("Unknown option " + a);
+    }
+    if (o.q.empty() || o.k.empty() || o.v.empty()) throw runtime_error("No Q/K/V inputs given");
+    o.cfg.derive();
+    return o;
+}
+
+// Error of one output row against the reference row
+struct RowError {
+    double mae = 0, rmse = 0;
+    int max_abs = 0;
+    bool top1 = false;
+};
+
+static RowError row_error(const int8_t *ref, const int8_t *out, int D) {
+    RowError e;
+    for (int d = 0; d < D; ++d) {
+        int err = abs(out[d] - ref[d]);
+        e.mae += err;
+        e.rmse += (double)err * err;
+        e.max_abs = max(e.max_abs, err);
+    }
+    e.mae /= D;
+    e.rmse = sqrt(e.rmse / D);
+    e.top1 = max_element(ref, ref + D) - ref == max_element(out, out + D) - out;
+    return e;
+}
+
+int main(int argc, char **argv) {
+    stats_init(argc, argv);
+    ios::sync_with_stdio(false);
+
+    if (argc < 2) {
+        usage(argv[0]);
+        return 1;
+    }
+
+    try {
+        AttribOptions o = parse_args(argc, argv);
+        const int D = AURA_DK;
+        auto Q = read_int8_mem(o.q), K = read_int8_mem(o.k), V = read_int8_mem(o.v);
+        if (K.size() != V.size()) throw runtime_error("K and V have different sizes");
+        const int rows = (int)(Q.size() / D), rows_kv = (int)(K.size() / D);
+        if (o.row >= rows) throw runtime_error("--row is past the last query row");
+
+        vector<int8_t> O_ref;
+        if (!o.expected.empty()) {
+            O_ref = read_int8_mem(o.expected);
+            if (O_ref.size() != Q.size()) throw runtime_error("Reference and Q have different sizes");
+        } else {
+            O_ref = quantize_q07(reference_attention(dequantize_q07<double>(Q), dequantize_q07<double>(K),
+                                                     dequantize_q07<double>(V), D, o.threads));
+        }
+
+        // every (combination, row) pair is independent
+        vector<vector<int8_t>> out(NUM_STAGE_MASKS, vector<int8_t>(Q.size()));
+        MatrixView<const int8_t> Kv(K, D), Vv(V, D);
+        parallel_rows(NUM_STAGE_MASKS * rows, o.threads, [&](int item) {
+            StageMask mask = item / rows;
+            int i = item % rows;
+            mixed_attention_row(&Q[(size_t)i * D], Kv, Vv, rows_kv, &out[mask][(size_t)i * D], o.cfg, mask);
+        });
+
+        // sanity: the all-RTL combination is the model itself
+        if (out[ALL_APPROX] != model_attention(Q, K, V, o.cfg, o.threads))
+            throw runtime_error("Mixed datapath with every stage approximate differs from the model");
+
+        vector<Metrics> metrics(NUM_STAGE_MASKS);
+        vector<vector<RowError>> errs(NUM_STAGE_MASKS, vector<RowError>(rows));
+        for (int mask = 0; mask < NUM_STAGE_MASKS; ++mask) {
+            metrics[mask] = compare_outputs(O_ref, out[mask]);
+            for (int i = 0; i < rows; ++i)
+                errs[mask][i] = row_error(&O_ref[(size_t)i * D], &out[mask][(size_t)i * D], D);
+        }
+
+        cout << "===== Stage Attribution =====\n";
+        cout << "Inputs        : " << o.q << " (" << rows << " x " << D << "), K/V rows " << rows_kv << "\n";
+        cout << "Reference     : " << (o.expected.empty() ? "fp64 attention of the Q0.7 inputs" : o.expected)
+             << "\n";
+        cout << "Model         : " << o.cfg.signature() << "\n\n";
+
+        cout << left << setw(36) << "RTL stages" << setw(10) << "MAE" << setw(10) << "RMSE" << setw(6)
+             << "max" << "top-1\n";
+        for (int mask = 0; mask < NUM_STAGE_MASKS; ++mask) {
+            const Metrics &m = metrics[mask];
+            cout << left << setw(36) << stage_mask_name(mask) << fixed << setprecision(4) << setw(10)
+                 << m.mae << setw(10) << m.rmse << setw(6) << m.max_abs_error << setprecision(3)
+                 << m.top1_ratio() << "\n" << defaultfloat;
+        }
+
+        // marginal contributions
+        double mae[NUM_STAGE_MASKS], rmse[NUM_STAGE_MASKS], top1[NUM_STAGE_MASKS];
+        for (int mask = 0; mask < NUM_STAGE_MASKS; ++mask) {
+            mae[mask] = metrics[mask].mae;
+            rmse[mask] = metrics[mask].rmse;
+            top1[mask] = metrics[mask].top1_ratio();
+        }
+        auto phi_mae = stage_shapley(mae), phi_rmse = stage_shapley(rmse), phi_top1 = stage_shapley(top1);
+
+        cout << "\nMarginal contribution (Shapley value over all combinations)\n";
+        cout << left << setw(10) << "stage" << setw(12) << "MAE" << setw(12) << "RMSE" << setw(12)
+             << "top-1" << setw(12) << "alone MAE" << "removed MAE\n";
+        for (int s = 0; s < NUM_ATTRIB_STAGES; ++s) {
+            StageMask bit = 1u << s;
+            cout << left << setw(10) << attrib_stage_name(s) << showpos << fixed << setprecision(4)
+                 << setw(12) << phi_mae[s] << setw(12) << phi_rmse[s] << setw(12) << phi_top1[s]
+                 << setw(12) << mae[bit] - mae[ALL_EXACT] << mae[ALL_APPROX] - mae[ALL_APPROX & ~bit]
+                 << "\n" << noshowpos << defaultfloat;
+        }
+        cout << left << setw(10) << "total" << showpos << fixed << setprecision(4) << setw(12)
+             << mae[ALL_APPROX] - mae[ALL_EXACT] << setw(12) << rmse[ALL_APPROX] - rmse[ALL_EXACT]
+             << top1[ALL_APPROX] - top1[ALL_EXACT] << "\n" << noshowpos << defaultfloat;
+
+        // first divergence: enable the stages one by one in datapath order
+        vector<int> first(rows, -1);
+        for (int i = 0; i < rows; ++i)
+            for (int s = 0; s <= NUM_ATTRIB_STAGES && first[i] < 0; ++s)
+                if (errs[cumulative_mask(s)][i].max_abs > o.tol) first[i] = s;
+        vector<int> count(NUM_ATTRIB_STAGES + 2, 0);
+        for (int f : first) count[f + 1]++;
+
+        auto first_name = [](int f) -> string {
+            return f < 0 ? "none" : f == 0 ? "exact" : attrib_stage_name(f - 1);
+        };
+        cout << "\nFirst divergent stage (row max error > " << o.tol
+             << " LSB, stages enabled in datapath order)\n";
+        for (int f = -1; f <= NUM_ATTRIB_STAGES; ++f)
+            cout << "  " << left << setw(8) << first_name(f) << ": " << count[f + 1] << " rows\n";
+
+        if (o.row >= 0) {
+            cout << "\nRow " << o.row << "\n";
+            cout << left << setw(36) << "RTL stages" << setw(10) << "MAE" << setw(10) << "RMSE" << setw(6) << "max"
+                 << "top-1\n";
+            for (int s = 0; s <= NUM_ATTRIB_STAGES; ++s) {
+                const RowError &e = errs[cumulative_mask(s)][o.row];
+                cout << left << setw(36) << stage_mask_name(cumulative_mask(s)) << fixed << setprecision(4)
+                     << setw(10) << e.mae << setw(10) << e.rmse << setw(6) << e.max_abs << (e.top1 ? "yes" : "no") << "\n"
+                     << defaultfloat;
+            }
+            cout << "First divergent stage: " << first_name(first[o.row]) << "\n";
+        }
+
+        if (!o.rows_csv.empty()) {
+            ofstream csv(o.rows_csv);
+            if (!csv) throw runtime_error("Cannot open " + o.rows_csv);
+            csv << "row,mae_exact,mae_rtl,rmse_exact,rmse_rtl";
+            for (int s = 0; s < NUM_ATTRIB_STAGES; ++s) csv << ",mae_" << attrib_stage_name(s);
+            for (int s = 0; s < NUM_ATTRIB_STAGES; ++s) csv << ",rmse_" << attrib_stage_name(s);
+            for (int s = 0; s < NUM_ATTRIB_STAGES; ++s) csv << ",top1_" << attrib_stage_name(s);
+            csv << ",first_divergent\n";
+            for (int i = 0; i < rows; ++i) {
+                double rmae[NUM_STAGE_MASKS], rrmse[NUM_STAGE_MASKS], rtop1[NUM_STAGE_MASKS];
+                for (int mask = 0; mask < NUM_STAGE_MASKS; ++mask) {
+                    rmae[mask] = errs[mask][i].mae;
+                    rrmse[mask] = errs[mask][i].rmse;
+                    rtop1[mask] = errs[mask][i].top1;
+                }
+                auto pm = stage_shapley(rmae), pr = stage_shapley(rrmse), pt = stage_shapley(rtop1);
+                csv << i << "," << rmae[ALL_EXACT] << "," << rmae[ALL_APPROX] << "," << rrmse[ALL_EXACT] << ","
+                    << rrmse[ALL_APPROX];
+                for (double x : pm) csv << "," << x;
+                for (double x : pr) csv << "," << x;
+                for (double x : pt) csv << "," << x;
+                csv << "," << first_name(first[i]) << "\n";
+            }
+            cerr << "Wrote " << o.rows_csv << "\n";
+        }
+
+    } catch (const exception &e) {
+        cerr << "ERROR: " << e.what() << "\n";
+        return 1;
+    }
+    return 0;
+}
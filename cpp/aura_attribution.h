@@ -0,0 +1,160 @@
+// Per-stage error attribution for the fixed-point model.
+//
+// mixed_attention_row() runs the PE datapath with every approximating stage
+// switchable between its RTL behaviour (aura_model.h, bit-exact) and exact
+// real arithmetic:
+//   DOT_QT : score truncation to EXPMUL_DIFF_IN_QT     (dot_product.sv)
+//   LOG2E  : x + (x >>> 1) - (x >>> 4) for x * log2(e) (expmul_stage.sv)
+//   EXP_QT : rounding/clipping of the exponent to EXPMUL_EXP_QT
+//   VEC_QT : o* / v* held in EXPMUL_VEC_QT, barrel-shifted
+//   DIV    : DIV_INPUT_QT + int_division              (vector_division.sv)
+//            or the reciprocal multiply with cfg.recip_bits
+// With every stage approximate the output is identical to model_attention();
+// with none it is the real-valued softmax(QK^T / sqrt(dk)) V of the Q0.7 inputs.
+//
+// Running all 2^5 combinations gives each stage's marginal contribution to an
+// error metric as its Shapley value: the change from switching the stage to
+// its approximation, averaged over every state of the other stages. The values
+// add up to metric(all approximate) - metric(all exact).
+
+#ifndef AURA_ATTRIBUTION_H
+#define AURA_ATTRIBUTION_H
+
+#include "aura_model.h"
+
+enum AttribStage { STAGE_DOT_QT, STAGE_LOG2E, STAGE_EXP_QT, STAGE_VEC_QT, STAGE_DIV, NUM_ATTRIB_STAGES };
+
+// bit s set: stage s runs as in the RTL
+using StageMask = unsigned;
+static constexpr StageMask ALL_EXACT = 0, ALL_APPROX = (1u << NUM_ATTRIB_STAGES) - 1;
+static constexpr int NUM_STAGE_MASKS = 1 << NUM_ATTRIB_STAGES;
+
+inline const char *attrib_stage_name(int s) {
+    static const char *names[NUM_ATTRIB_STAGES] = {"DOT_QT", "LOG2E", "EXP_QT", "VEC_QT", "DIV"};
+    return names[s];
+}
+
+// "DOT_QT+EXP_QT", "exact" or "RTL"
+inline string stage_mask_name(StageMask mask) {
+    if (mask == ALL_EXACT) return "exact";
+    if (mask == ALL_APPROX) return "RTL";
+    string name;
+    for (int s = 0; s < NUM_ATTRIB_STAGES; ++s)
+        if (mask >> s & 1) name += (name.empty() ? "" : "+") + string(attrib_stage_name(s));
+    return name;
+}
+
+// ---------------------------
+// Mixed exact/approximate datapath
+// ---------------------------
+inline void mixed_attention_row(const int8_t *q, MatrixView<const int8_t> K, MatrixView<const int8_t> V,
+                                int rows_kv, int8_t *o_out, const ModelConfig &cfg, StageMask approx) {
+    const bool a_dot = approx >> STAGE_DOT_QT & 1, a_log = approx >> STAGE_LOG2E & 1,
+               a_exp = approx >> STAGE_EXP_QT & 1, a_vec = approx >> STAGE_VEC_QT & 1,
+               a_div = approx >> STAGE_DIV & 1;
+    const int D = cfg.embedding_dim;
+    const int vec_w = cfg.expmul_vec.width();
+    const double score_lsb = ldexp(1.0, -cfg.expmul_diff_in.f), vec_lsb = ldexp(1.0, -cfg.expmul_vec.f);
+    const QFormat log2e_fmt = model_log2e_format(cfg);
+    const double inv_sqrt_dk = 1.0 / sqrt((double)D);
+    auto round_lsb = [&](double x) { return (int64_t)floor(cfg.rounding ? x + 0.5 : x); };
+
+    ScratchScope scratch;
+    int64_t *o_fix = scratch.alloc<int64_t>(D + 1), *v_fix = scratch.alloc<int64_t>(D + 1);
+    double *o_real = scratch.alloc<double>(D + 1);
+    fill(o_fix, o_fix + D + 1, 0);
+    fill(o_real, o_real + D + 1, 0.0);
+
+    // log2 of the rescale factor e^(a - b); integral whenever EXP_QT is approximate
+    auto exponent = [&](double a, double b, int64_t a_fix, int64_t b_fix) {
+        int64_t lx = 0;
+        double x = (a - b) * M_LOG2E;
+        if (a_log) {
+            lx = model_log2e(a_fix, b_fix, cfg);
+            x = ldexp((double)lx, -log2e_fmt.f);
+        }
+        if (!a_exp) return x;
+        if (a_log) return (double)q_convert(lx, log2e_fmt, cfg.expmul_exp, cfg.rounding);
+        return (double)q_saturate(round_lsb(x), cfg.expmul_exp.width());
+    };
+    // v * 2^e on the EXPMUL_VEC_QT grid
+    auto scale_fix = [&](int64_t v, double e) {
+        if (a_exp) return model_exp_shift(v, (int64_t)e, cfg);
+        return q_wrap(round_lsb(v * exp2(e)), vec_w);
+    };
+
+    double m = 0;
+    int64_t m_fix = 0;
+    for (int j = 0; j < rows_kv; ++j) {
+        const int8_t *k = K.row(j), *v = V.row(j);
+
+        double s;
+        int64_t s_fix;
+        if (a_dot) {
+            s_fix = model_score(q, k, cfg);
+            s = s_fix * score_lsb;
+        } else {
+            int64_t dot = 0;
+            for (int d = 0; d < D; ++d) dot += (int64_t)q[d] * k[d];
+            s = dot / (AURA_Q_FACTOR * AURA_Q_FACTOR) * inv_sqrt_dk;
+            s_fix = q_saturate(round_lsb(s / score_lsb), cfg.expmul_diff_in.width());
+        }
+        double m_new = max(s, m);
+        int64_t m_fix_new = max(s_fix, m_fix);
+        double e_o = exponent(m, m_new, m_fix, m_fix_new);
+        double e_v = exponent(s, m_new, s_fix, m_fix_new);
+
+        v_fix[0] = 1LL << cfg.expmul_vec.f;
+        for (int d = 0; d < D; ++d)
+            v_fix[d + 1] = q_convert(v[d], cfg.input_vec, cfg.expmul_vec, cfg.rounding);
+
+        if (a_vec) {
+            for (int d = 0; d <= D; ++d) {
+                int64_t o = (j == 0) ? 0 : scale_fix(o_fix[d], e_o);
+                o_fix[d] = q_wrap(o + scale_fix(v_fix[d], e_v), vec_w);
+            }
+        } else {
+            double f_o = (j == 0) ? 0.0 : exp2(e_o), f_v = exp2(e_v);
+            for (int d = 0; d <= D; ++d) o_real[d] = o_real[d] * f_o + v_fix[d] * vec_lsb * f_v;
+        }
+        m = m_new;
+        m_fix = m_fix_new;
+    }
+
+    if (a_div) {
+        if (!a_vec)
+            for (int d = 0; d <= D; ++d) o_fix[d] = llround(o_real[d] / vec_lsb);
+        model_normalize(o_fix, o_out, cfg);
+        return;
+    }
+    for (int d = 0; d < D; ++d) {
+        double num = a_vec ? o_fix[d + 1] * vec_lsb : o_real[d + 1];
+        double den = a_vec ? o_fix[0] * vec_lsb : o_real[0];
+        o_out[d] = den != 0 ? quantize_q07(num / den) : (num == 0 ? 0 : num > 0 ? 127 : -128);
+    }
+}
+
+// ---------------------------
+// Shapley values over the stage masks
+// ---------------------------
+// value[mask] is a metric of the output with the stages in `mask` approximate;
+// returns the contribution of every stage (summing to value[ALL_APPROX] - value[ALL_EXACT]).
+inline array<double, NUM_ATTRIB_STAGES> stage_shapley(const double *value) {
+    const int n = NUM_ATTRIB_STAGES;
+    double fact[NUM_ATTRIB_STAGES + 1] = {1};
+    for (int i = 1; i <= n; ++i) fact[i] = fact[i - 1] * i;
+
+    array<double, NUM_ATTRIB_STAGES> phi{};
+    for (int s = 0; s < n; ++s)
+        for (StageMask rest = 0; rest < (StageMask)NUM_STAGE_MASKS; ++rest) {
+            if (rest >> s & 1) continue;
+            int k = __builtin_popcount(rest);
+            phi[s] += fact[k] * fact[n - k - 1] / fact[n] * (value[rest | 1u << s] - value[rest]);
+        }
+    return phi;
+}
+
+// Masks that switch the stages on in datapath order: exact, DOT_QT, DOT_QT+LOG2E, ..., RTL
+inline StageMask cumulative_mask(int stages) { return (1u << stages) - 1; }
+
+#endif // AURA_ATTRIBUTION_H
@@ -0,0 +1,301 @@
+#include "aura_mem.h"
+#include "aura_model.h"
+#include "aura_reference.h"
+#include "aura_metrics.h"
+#include "aura_executor.h"
+
+// -----------------------------------------------------
+// Batch runner: reference + C++ model + compare for many cases at once.
+//   ingest  : read and convert Q/K/V of one case, split it into jobs
+//             (one per query head and block of --tile-rows query rows)
+//   compute : reference and bit-accurate model rows of one job
+//   egress  : once every job of a case is done, write its outputs and compare
+// The stages overlap through bounded queues (aura_executor.h), so parsing the
+// next case and writing the previous one hide behind the attention of the
+// current one. Per case, the numbers match 'aura_pipeline --test NAME'.
+// -----------------------------------------------------
+
+struct Options {
+    vector<string> tests;           // case names under `models`
+    string models = "models";
+    string reference;               // fp32 | fp64 (default: fp32 when FP32 inputs exist)
+    string out;                     // write DIR/NAME/O_*.mem
+    int tile_rows = 64;             // query rows per compute job (0: whole head)
+    int stage_workers[3] = {1, max(1, default_threads() - 1), 1};
+    int depths[2] = {2, 4};         // ingest->compute, compute->egress
+    HeadLayout heads;
+    ModelConfig cfg;
+};
+
+static void usage(const char *prog) {
+    Options d;
+    cerr << "Usage: " << prog << " [options]\n"
+         << "  --test NAME           add models/NAME/ (repeatable; default every case under --models)\n"
+         << "  --models DIR          case root (default " << d.models << ")\n"
+         << "  --reference fp32|fp64 reference precision (default fp32 when Q32/K32/V32.mem exist)\n"
+         << "  --q-heads H           Q holds H heads stacked by rows (default 1)\n"
+         << "  --kv-heads N          K/V hold N heads, each shared by H/N query heads (default H)\n"
+         << "  --guard-bits N        extra Log2Exp fraction bits in the C++ model (default 0)\n"
+         << "  --tile-rows R         query rows per compute job, 0 for one job per head (default "
+         << d.tile_rows << ")\n"
+         << "  --workers I,C,E       ingest, compute and egress workers (default " << d.stage_workers[0]
+         << "," << d.stage_workers[1] << "," << d.stage_workers[2] << ")\n"
+         << "  --depths A,B          ingest->compute and compute->egress queue depths in jobs\n"
+         << "                        (default " << d.depths[0] << "," << d.depths[1] << ")\n"
+         << "  --out DIR             write DIR/NAME/O_cleaned.mem and O_fixed_correct.mem\n";
+}
+
+static Options parse_args(int argc, char **argv) {
+    Options o;
+    auto need = [&](int &i) -> string {
+        if (i + 1 >= argc) throw runtime_error(string("Missing value for ") + argv[i]);
+        return argv[++i];
+    };
+    int kv_heads = 0;
+
+    for (int i = 1; i < argc; ++i) {
+        string a = argv[i];
+        if (a == "--test") o.tests.push_back(need(i));
+        else if (a == "--models") o.models = need(i);
+        else if (a == "--reference") o.reference = need(i);
+        else if (a == "--q-heads") o.heads.q_heads = parse_int(need(i));
+        else if (a == "--kv-heads") kv_heads = parse_int(need(i));
+        else if (a == "--guard-bits") o.cfg.log2e_guard_bits = parse_int(need(i));
+        else if (a == "--tile-rows") o.tile_rows = max(0, parse_int(need(i)));
+        else if (a == "--workers") {
+            auto v = parse_list(need(i));
+            if (v.size() != 3) throw runtime_error("--workers takes ingest,compute,egress");
+            for (int s = 0; s < 3; ++s) o.stage_workers[s] = max(1, v[s]);
+        }
+        else if (a == "--depths") {
+            auto v = parse_list(need(i));
+            if (v.size() != 2) throw runtime_error("--depths takes two queue depths");
+            for (int s = 0; s < 2; ++s) o.depths[s] = max(1, v[s]);
+        }
+        else if (a == "--out") o.out = need(i);
+        else throw runtime_error("Unknown option " + a);
+    }
+
+    if (kv_heads == 0) kv_heads = o.heads.q_heads;
+    o.heads.kv_heads = kv_heads;
+    if (!o.reference.empty() && o.reference != "fp32" && o.reference != "fp64")
+        throw runtime_error("Unknown reference " + o.reference);
+    if (o.tests.empty()) o.tests = discover_tests(o.models);
+    if (o.tests.empty()) throw runtime_error("No cases under " + o.models);
+    o.cfg.derive();
+    return o;
+}
+
+// -----------------------------------------------------
+// Work items
+// -----------------------------------------------------
+// One case in flight: inputs, the outputs every job writes its rows into, and
+// the number of jobs still outstanding.
+struct CaseData {
+    size_t index = 0;
+    string name, reference;
+    vector<float> Q32, K32, V32;   // fp32 reference inputs
+    vector<double> Qd, Kd, Vd;     // fp64 reference inputs
+    vector<int8_t> Q, K, V;        // model inputs
+    vector<float> O_float;         // fp32 reference output (written as O_float_correct.mem)
+    vector<double> O_double;
+    vector<int8_t> O_ref, O_asic;
+    atomic<int> pending{0};
+    atomic<int64_t> compute_ns{0};
+    double ingest_s = 0;
+};
+
+struct Job {
+    shared_ptr<CaseData> c;
+    int head = 0, row_begin = 0, rows = 0;  // query rows of head `head`
+};
+
+struct CaseResult {
+    string name, reference;
+    int rows = 0;
+    Metrics m;
+    double ingest_s = 0, compute_s = 0, egress_s = 0;
+};
+
+static double seconds_since(chrono::steady_clock::time_point t0) {
+    return chrono::duration<double>(chrono::steady_clock::now() - t0).count();
+}
+
+// ---- ingest ----
+template <class Emit>
+static void ingest(const Options &o, size_t index, const string &name, Emit &&emit) {
+    auto t0 = chrono::steady_clock::now();
+    auto c = make_shared<CaseData>();
+    c->index = index;
+    c->name = name;
+
+    CaseInputs in = read_case(o.models, name);
+    c->reference = o.reference.empty() ? (in.has_fp32() ? "fp32" : "fp64") : o.reference;
+    if (c->reference == "fp32" && !in.has_fp32())
+        throw runtime_error(name + ": --reference fp32 needs Q32/K32/V32.mem");
+    c->Q32 = std::move(in.Q32), c->K32 = std::move(in.K32), c->V32 = std::move(in.V32);
+    c->Q = std::move(in.Q), c->K = std::move(in.K), c->V = std::move(in.V);
+    o.heads.validate(c->Q.size(), c->K.size(), AURA_DK);
+    if (c->reference == "fp64") {
+        c->Qd = dequantize_q07<double>(c->Q);
+        c->Kd = dequantize_q07<double>(c->K);
+        c->Vd = dequantize_q07<double>(c->V);
+        c->Q32.clear(), c->K32.clear(), c->V32.clear();
+        c->O_double.resize(c->Q.size());
+    } else {
+        c->O_float.resize(c->Q.size());
+    }
+    c->O_ref.resize(c->Q.size());
+    c->O_asic.resize(c->Q.size());
+
+    const int head_rows = (int)(c->Q.size() / AURA_DK / o.heads.q_heads);
+    const int tile = o.tile_rows ? min(o.tile_rows, head_rows) : head_rows;
+    vector<Job> jobs;
+    for (int h = 0; h < o.heads.q_heads; ++h)
+        for (int r = 0; r < head_rows; r += tile) jobs.push_back({c, h, r, min(tile, head_rows - r)});
+    c->pending = (int)jobs.size();
+    c->ingest_s = seconds_since(t0);
+    for (auto &j : jobs) emit(std::move(j));
+}
+
+// ---- compute ----
+// Rows [row_begin, row_begin + rows) of query head `head` against its K/V head
+static void compute(const Options &o, const Job &job) {
+    auto t0 = chrono::steady_clock::now();
+    CaseData &c = *job.c;
+    const size_t head_rows = c.Q.size() / AURA_DK / o.heads.q_heads;
+    const size_t kv_rows = c.K.size() / AURA_DK / o.heads.kv_heads;
+    const size_t q0 = job.head * head_rows + job.row_begin;
+    const size_t k0 = o.heads.kv_head(job.head) * kv_rows;
+    auto rows_of = [&](auto &flat, size_t begin, size_t n) {
+        return MatrixView<remove_reference_t<decltype(flat[0])>>(flat, AURA_DK).slice(begin, n);
+    };
+    // reference rows, then Q0.7 as in aura_pipeline
+    auto reference = [&](const auto &Q, const auto &K, const auto &V, auto &O) {
+        using T = typename decay_t<decltype(O)>::value_type;
+        reference_attention<T>(rows_of(Q, q0, job.rows), rows_of(K, k0, kv_rows),
+                               rows_of(V, k0, kv_rows), rows_of(O, q0, job.rows));
+        for (size_t i = q0 * AURA_DK; i < (q0 + job.rows) * AURA_DK; ++i) c.O_ref[i] = quantize_q07(O[i]);
+    };
+
+    if (c.reference == "fp32") reference(c.Q32, c.K32, c.V32, c.O_float);
+    else reference(c.Qd, c.Kd, c.Vd, c.O_double);
+    model_attention(rows_of(as_const(c.Q), q0, job.rows), rows_of(as_const(c.K), k0, kv_rows),
+                    rows_of(as_const(c.V), k0, kv_rows), rows_of(c.O_asic, q0, job.rows), o.cfg);
+    c.compute_ns += chrono::duration_cast<chrono::nanoseconds>(chrono::steady_clock::now() - t0).count();
+}
+
+// ---- egress ----
+// Only the job that completes a case writes and compares it
+static void egress(const Options &o, const Job &job, vector<CaseResult> &results) {
+    CaseData &c = *job.c;
+    if (--c.pending > 0) return;
+    auto t0 = chrono::steady_clock::now();
+    if (!o.out.empty()) {
+        string dir = o.out + "/" + c.name;
+        error_code ec;
+        filesystem::create_directories(dir, ec);
+        if (ec) throw runtime_error("Cannot create " + dir + ": " + ec.message());
+        write_int8_mem(dir + "/O_cleaned.mem", c.O_asic);
+        write_int8_mem(dir + "/O_fixed_correct.mem", c.O_ref);
+        if (!c.O_float.empty()) write_fp32_mem(dir + "/O_float_correct.mem", c.O_float);
+    }
+    CaseResult &r = results[c.index];
+    r.name = c.name;
+    r.reference = c.reference;
+    r.rows = (int)(c.Q.size() / AURA_DK);
+    r.m = compare_outputs(c.O_ref, c.O_asic);
+    r.ingest_s = c.ingest_s;
+    r.compute_s = c.compute_ns * 1e-9;
+    r.egress_s = seconds_since(t0);
+    cerr << "[done] " << c.name << "\n";
+}
+
+// -----------------------------------------------------
+// Report
+// -----------------------------------------------------
+static void report(const Options &o, const vector<CaseResult> &results, const Pipeline &p,
+                   const BoundedQueue<pair<size_t, string>> &cases, const BoundedQueue<Job> &to_compute,
+                   const BoundedQueue<Job> &to_egress, double wall) {
+    cout << "===== AURA Batch =====\n";
+    cout << results.size() << " cases, " << o.heads.q_heads << " query heads, " << o.heads.kv_heads
+         << " K/V heads, guard bits " << o.cfg.log2e_guard_bits << "\n";
+    cout << left << setw(22) << "case" << setw(6) << "ref" << setw(7) << "rows" << setw(10) << "MAE"
+         << setw(10) << "RMSE" << setw(6) << "max" << setw(9) << "top-1" << setw(9) << "read s"
+         << setw(11) << "compute s" << setw(9) << "write s" << "verdict\n";
+    bool all = true;
+    for (const auto &r : results) {
+        all = all && r.m.passed();
+        cout << left << setw(22) << r.name << setw(6) << r.reference << setw(7) << r.rows << fixed
+             << setprecision(4) << setw(10) << r.m.mae << setw(10) << r.m.rmse << setw(6)
+             << r.m.max_abs_error << setprecision(3) << setw(9) << r.m.top1_ratio() << setw(9)
+             << r.ingest_s << setw(11) << r.compute_s << setw(9) << r.egress_s
+             << (r.m.passed() ? "PASS" : "FAIL") << "\n" << defaultfloat;
+    }
+
+    cout << "\n" << left << setw(10) << "stage" << setw(9) << "workers" << setw(8) << "jobs"
+         << setw(10) << "busy s" << setw(11) << "blocked s" << "utilization\n";
+    for (const auto &s : p.stats())
+        cout << left << setw(10) << s.name << setw(9) << s.workers << setw(8) << s.items << fixed
+             << setprecision(3) << setw(10) << s.busy << setw(11) << s.blocked
+             << s.busy / (wall * s.workers) << "\n" << defaultfloat;
+
+    cout << "\n" << left << setw(10) << "queue" << setw(8) << "depth" << setw(12) << "high water"
+         << "full waits\n";
+    auto queue_row = [](const char *name, size_t depth, size_t high, size_t waits) {
+        cout << left << setw(10) << name << setw(8) << depth << setw(12) << high << waits << "\n";
+    };
+    queue_row("cases", cases.capacity(), cases.high_water(), cases.push_waits());
+    queue_row("compute", to_compute.capacity(), to_compute.high_water(), to_compute.push_waits());
+    queue_row("egress", to_egress.capacity(), to_egress.high_water(), to_egress.push_waits());
+
+    double serial = 0;
+    for (const auto &s : p.stats()) serial += s.busy;
+    cout << "\nWall time     : " << fixed << setprecision(3) << wall << " s (" << serial
+         << " s of stage work)\n" << defaultfloat;
+    cout << "Overall       : " << (all ? "PASS" : "FAIL") << "\n";
+}
+
+// -----------------------------------------------------
+// main
+// -----------------------------------------------------
+int main(int argc, char **argv) {
+    stats_init(argc, argv);
+    ios::sync_with_stdio(false);
+
+    if (argc > 1 && (string(argv[1]) == "-h" || string(argv[1]) == "--help")) {
+        usage(argv[0]);
+        return 1;
+    }
+
+    try {
+        Options o = parse_args(argc, argv);
+        vector<CaseResult> results(o.tests.size());
+        auto t0 = chrono::steady_clock::now();
+
+        Pipeline p;
+        auto &cases = p.queue<pair<size_t, string>>(1);
+        auto &to_compute = p.queue<Job>(o.depths[0]);
+        auto &to_egress = p.queue<Job>(o.depths[1]);
+        p.stage("ingest", o.stage_workers[0], cases, to_compute, [&](pair<size_t, string> c, auto &emit) {
+            ingest(o, c.first, c.second, emit);
+        });
+        p.stage("compute", o.stage_workers[1], to_compute, to_egress, [&](Job job, auto &emit) {
+            compute(o, job);
+            emit(std::move(job));
+        });
+        p.sink("egress", o.stage_workers[2], to_egress, [&](Job job) { egress(o, job, results); });
+
+        for (size_t i = 0; i < o.tests.size(); ++i)
+            if (!cases.push({i, o.tests[i]})) break;  // a stage failed
+        cases.close();
+        p.wait();
+
+        report(o, results, p, cases, to_compute, to_egress, seconds_since(t0));
+
+    } catch (const exception &e) {
+        cerr << "ERROR: " << e.what() << "\n";
+        return 1;
+    }
+    return 0;
+}
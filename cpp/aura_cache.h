@@ -0,0 +1,199 @@
+// Content-addressed on-disk cache for reference/model outputs.
+//
+// A key is the hash of everything an output depends on: the tool version
+// (AURA_TOOL_VERSION), the stage name, the configuration and the Q/K/V data.
+// Entries live in $AURA_CACHE_DIR (or the directory given to the tool) as
+//   <key>.bin : 32 byte header (magic, version, element size, count) + raw data
+// and are written to a unique temp file and renamed, so concurrent sweeps can
+// share one cache directory. An entry whose header does not match its size is
+// treated as a miss and rebuilt, and an entry that cannot be written is
+// skipped with a warning: the cache never fails a run.
+
+#ifndef AURA_CACHE_H
+#define AURA_CACHE_H
+
+#include "aura_common.h"
+
+#include <sys/stat.h>
+#include <unistd.h>
+
+// Bump when a change to a kernel alters its output bits
+static constexpr uint32_t AURA_TOOL_VERSION = 1;
+
+// ---------------------------
+// 64-bit content hash (8 bytes per step, murmur-style finalizer)
+// ---------------------------
+inline uint64_t hash_mix(uint64_t h) {
+    h ^= h >> 33;
+    h *= 0xFF51AFD7ED558CCDULL;
+    h ^= h >> 33;
+    h *= 0xC4CEB9FE1A85EC53ULL;
+    h ^= h >> 33;
+    return h;
+}
+
+inline uint64_t hash_bytes(const void *data, size_t n, uint64_t seed = 0) {
+    const uint8_t *p = (const uint8_t *)data;
+    uint64_t h = seed ^ (n * 0x9E3779B97F4A7C15ULL);
+    size_t i = 0;
+    for (; i + 8 <= n; i += 8) {
+        uint64_t w;
+        memcpy(&w, p + i, 8);
+        h = (h ^ hash_mix(w)) * 0x9E3779B97F4A7C15ULL;
+    }
+    uint64_t tail = 0;
+    memcpy(&tail, p + i, n - i);
+    return hash_mix(h ^ hash_mix(tail ^ (n - i)));
+}
+
+// Accumulates the inputs of one computation into a cache key
+class CacheKey {
+public:
+    explicit CacheKey(const string &stage) {
+        add(AURA_TOOL_VERSION);
+        add(stage);
+    }
+
+    CacheKey &add(const string &s) { return mix(hash_bytes(s.data(), s.size(), 1)); }
+    CacheKey &add(int64_t v) { return mix(hash_bytes(&v, sizeof(v), 2)); }
+    CacheKey &add(uint32_t v) { return add((int64_t)v); }
+    CacheKey &add(int v) { return add((int64_t)v); }
+
+    template <class T>
+    CacheKey &add(const vector<T> &tensor) {
+        return mix(hash_bytes(tensor.data(), tensor.size() * sizeof(T), 3 + sizeof(T)));
+    }
+
+    string hex() const {
+        char buf[33];
+        snprintf(buf, sizeof(buf), "%016llx%016llx", (unsigned long long)h0, (unsigned long long)h1);
+        return buf;
+    }
+
+private:
+    uint64_t h0 = 0x243F6A8885A308D3ULL, h1 = 0x13198A2E03707344ULL;
+
+    CacheKey &mix(uint64_t v) {
+        h0 = hash_mix(h0 ^ v);
+        h1 = hash_mix(h1 + v * 0x9E3779B97F4A7C15ULL);
+        return *this;
+    }
+};
+
+// ---------------------------
+// On-disk store
+// ---------------------------
+class ResultCache {
+public:
+    // empty dir: $AURA_CACHE_DIR, or disabled when that is unset too
+    explicit ResultCache(string dir = "", bool use = true) : dir_(use ? std::move(dir) : "") {
+        if (use && dir_.empty())
+            if (const char *env = getenv("AURA_CACHE_DIR")) dir_ = env;
+        if (!dir_.empty() && mkdir(dir_.c_str(), 0777) != 0 && errno != EEXIST)
+            cerr << "WARNING: cannot create cache directory " << dir_ << " (" << strerror(errno) << ")\n";
+    }
+
+    bool enabled() const { return !dir_.empty(); }
+    int hits() const { return hits_; }
+    int misses() const { return misses_; }
+
+    // a missing, truncated or corrupt entry is a miss (and is rebuilt by the caller)
+    template <class T>
+    bool load(const CacheKey &key, vector<T> &out) {
+        if (!enabled()) return false;
+        try {
+            if (read_entry(path(key), out)) {
+                hits_++;
+                return true;
+            }
+        } catch (const exception &) {
+        }
+        misses_++;
+        return false;
+    }
+
+    // best effort: a failure is reported and otherwise ignored
+    template <class T>
+    void store(const CacheKey &key, const vector<T> &data) {
+        if (!enabled()) return;
+        Header h;
+        memcpy(h.magic, MAGIC, 8);
+        h.version = AURA_TOOL_VERSION;
+        h.elem_size = sizeof(T);
+        h.count = data.size();
+
+        // unique per process and thread; renamed into place when complete
+        string final_path = path(key);
+        string tmp = final_path + ".tmpXXXXXX";
+        int fd = mkstemp(&tmp[0]);
+        if (fd < 0) return warn("cannot open " + tmp);
+        fchmod(fd, 0644);
+        bool ok = write_all(fd, &h, sizeof(h)) && write_all(fd, data.data(), data.size() * sizeof(T));
+        ok = close(fd) == 0 && ok;
+        if (!ok || rename(tmp.c_str(), final_path.c_str()) != 0) {
+            warn((ok ? "cannot rename " : "cannot write ") + tmp);
+            unlink(tmp.c_str());
+        }
+    }
+
+    // load on hit, otherwise compute() and store
+    template <class T, class F>
+    vector<T> get_or_compute(const CacheKey &key, F compute) {
+        vector<T> out;
+        if (load(key, out)) return out;
+        out = compute();
+        store(key, out);
+        return out;
+    }
+
+private:
+    static constexpr char MAGIC[9] = "AURACACH";
+    struct Header {
+        char magic[8];
+        uint32_t version;
+        uint32_t elem_size;
+        uint64_t count;
+        uint64_t reserved = 0;
+    };
+    static_assert(sizeof(Header) == 32, "cache header layout");
+
+    string dir_;
+    int hits_ = 0, misses_ = 0;
+
+    string path(const CacheKey &key) const { return dir_ + "/" + key.hex() + ".bin"; }
+
+    static void warn(const string &what) {
+        cerr << "WARNING: result cache: " << what << " (" << strerror(errno) << "), entry not stored\n";
+    }
+
+    // the entry's data, if its header is valid and matches the file size exactly
+    template <class T>
+    static bool read_entry(const string &file, vector<T> &out) {
+        struct stat st {};
+        if (stat(file.c_str(), &st) != 0 || (uint64_t)st.st_size < sizeof(Header)) return false;
+        ifstream fin(file, ios::binary);
+        Header h;
+        if (!fin || !fin.read((char *)&h, sizeof(h)) || memcmp(h.magic, MAGIC, 8) != 0 ||
+            h.version != AURA_TOOL_VERSION || h.elem_size != sizeof(T))
+            return false;
+        const uint64_t payload = (uint64_t)st.st_size - sizeof(Header);
+        if (payload % sizeof(T) != 0 || h.count != payload / sizeof(T)) return false;
+        vector<T> data(h.count);
+        if (!fin.read((char *)data.data(), payload)) return false;
+        out = std::move(data);
+        return true;
+    }
+
+    static bool write_all(int fd, const void *data, size_t left) {
+        const char *p = (const char *)data;
+        while (left > 0) {
+            ssize_t w = write(fd, p, left);
+            if (w <= 0) return false;
+            p += w;
+            left -= (size_t)w;
+        }
+        return true;
+    }
+};
+
+#endif // AURA_CACHE_H
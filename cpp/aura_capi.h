@@ -0,0 +1,107 @@
+/* C interface of the analysis library (cpp/libaura.so, built by 'make cpp_tools').
+ *
+ * The converters, the floating point references, the bit-accurate fixed-point
+ * model and the comparator of the cpp/ tools, on caller-owned memory: no files,
+ * no allocation visible to the caller. Every matrix is an aura_tensor view with
+ * a row stride, so one head of a [tokens, heads, dk] activation is passed as
+ * {base + h * dk, tokens, dk, heads * dk} without copying it out.
+ *
+ * Functions return AURA_OK or AURA_ERROR; aura_last_error() then describes the
+ * failure of the calling thread. Nothing throws across this interface.
+ *
+ * The ABI is versioned: any incompatible change bumps AURA_ABI_VERSION, and
+ * callers should compare aura_abi_version() against the version they were
+ * written for. Structs passed by pointer start with `size`, which the caller
+ * sets to sizeof the struct it was compiled with; they are only ever extended
+ * at the end, and the library reads and writes no field beyond that size
+ * (fields a caller does not have take their defaults).
+ */
+
+#ifndef AURA_CAPI_H
+#define AURA_CAPI_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define AURA_ABI_VERSION 2
+
+/* the library is built with hidden visibility; only these symbols are exported */
+#if defined(__GNUC__)
+#define AURA_API __attribute__((visibility("default")))
+#else
+#define AURA_API
+#endif
+
+#define AURA_OK 0
+#define AURA_ERROR (-1)
+
+#define AURA_FP8_E4M3 0
+#define AURA_FP8_E5M2 1
+
+/* rows x cols elements, row i at data + i * stride (stride in elements, 0 = cols) */
+typedef struct {
+    void *data;
+    size_t rows, cols, stride;
+} aura_tensor;
+
+/* starting parameters of the fixed-point model (ModelConfig in aura_model.h) */
+typedef struct {
+    size_t size;             /* sizeof(aura_model_params) */
+    int integer_width;
+    int embedding_dim;
+    int max_seq_length;
+    int rounding;
+    int expmul_exp_i;
+    int log2e_guard_bits;
+    int recip_bits;          /* 0 = int_division */
+    int recip_seed_bits;
+    int recip_iterations;
+} aura_model_params;
+
+/* comparison of two Q0.7 matrices (Metrics in aura_metrics.h) */
+typedef struct {
+    size_t size;             /* sizeof(aura_metrics) */
+    int total_elements;
+    int rows;
+    double mae;
+    double rmse;
+    int max_abs_error;
+    double mean_rel_error;
+    int top1_match;
+    int passed;              /* every precision_measure threshold met */
+} aura_metrics;
+
+AURA_API int aura_abi_version(void);
+AURA_API const char *aura_last_error(void);
+
+/* the RTL defaults (p->size must be set) */
+AURA_API int aura_model_defaults(aura_model_params *p);
+
+/* converters: fp32 -> Q0.7 (round, clamp), Q0.7 -> fp32, fp32 <-> FP8 */
+AURA_API int aura_quantize_q07(aura_tensor in_f32, aura_tensor out_i8);
+AURA_API int aura_dequantize_q07(aura_tensor in_i8, aura_tensor out_f32);
+AURA_API int aura_fp32_to_fp8(aura_tensor in_f32, aura_tensor out_u8, int format);
+AURA_API int aura_fp8_to_fp32(aura_tensor in_u8, aura_tensor out_f32, int format);
+
+/* softmax(Q K^T / sqrt(dk)) V; the float variant is the O_float_correct.mem generator */
+AURA_API int aura_reference_attention_f32(aura_tensor Q, aura_tensor K, aura_tensor V, aura_tensor O,
+                                          int threads);
+AURA_API int aura_reference_attention_f64(aura_tensor Q, aura_tensor K, aura_tensor V, aura_tensor O,
+                                          int threads);
+
+/* bit-accurate model on Q0.7 inputs; params NULL = aura_model_defaults */
+AURA_API int aura_model_attention(aura_tensor Q, aura_tensor K, aura_tensor V, aura_tensor O,
+                                  const aura_model_params *params, int threads);
+
+/* metrics of out (Q0.7) against ref (Q0.7) */
+AURA_API int aura_compare(aura_tensor ref, aura_tensor out, aura_metrics *m);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* AURA_CAPI_H */
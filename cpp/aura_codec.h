@@ -0,0 +1,316 @@
+// Block codec of the compressed .bin tensors (aura_tensor.h, version 2).
+//
+// A block is a run of whole rows, flattened row-major, encoded on its own so
+// any block can be decoded without the others:
+//   uint8_t mode         BLOCK_STORED: the raw bytes follow
+//                        BLOCK_PACKED: mini-blocks follow
+//   mini-block, one per 64 values (the last one may be short):
+//     uint8_t  w | DELTA  bits per value (0 .. 8 * sizeof) and the delta flag
+//     uint64_t plane[w]   plane[b] bit k = bit b of value k
+// A value is the element's bit pattern, zig-zag coded either as is or, with
+// DELTA, as its wrapping difference to the element one row up (the first row
+// of a block counts from 0). The encoder picks per mini-block whichever needs
+// fewer bits, and stores the block raw when packing would not be smaller.
+//
+// Bit planes rather than packed fields keep the decoder branch-free: one plane
+// is one 64-bit mask expanded to 64 values (a masked broadcast per vector with
+// AVX-512, a byte shuffle and compare with AVX2, table lookups otherwise), and
+// with rows of 64 or more the delta is a vector add against the row above. The
+// vector decoders are chosen at run time (codec_isa), so a portable build
+// still decodes with AVX2 or AVX-512 where the CPU has them.
+
+#ifndef AURA_CODEC_H
+#define AURA_CODEC_H
+
+#include "aura_common.h"
+
+// GCC on x86-64 builds the vector decoders for AVX2 and AVX-512BW whatever the
+// -march, and picks one at run time
+#if defined(__x86_64__) && defined(__GNUC__) && !defined(__clang__)
+#define CODEC_DISPATCH 1
+#include <immintrin.h>
+#endif
+
+enum BlockMode : uint8_t { BLOCK_STORED = 0, BLOCK_PACKED = 1 };
+
+static constexpr size_t CODEC_MINI = 64;       // values per mini-block
+static constexpr uint8_t CODEC_DELTA = 0x80;  // flag in the width byte
+
+template <class U>
+inline U zigzag_encode(U v) {
+    using S = make_signed_t<U>;
+    return (U)((U)(v << 1) ^ (U)((S)v >> (8 * sizeof(U) - 1)));
+}
+
+template <class U>
+inline U zigzag_decode(U z) {
+    return (U)((U)(z >> 1) ^ (U)(0 - (U)(z & 1)));
+}
+
+template <class U>
+inline int bits_needed(U v) {
+    int n = 0;
+    for (; v; v = (U)(v >> 1)) ++n;
+    return n;
+}
+
+// ---------------------------
+// Encoder
+// ---------------------------
+// n values of a block with `cols` values per row, appended to out
+template <class U>
+void codec_encode_block(const U *in, size_t n, size_t cols, vector<uint8_t> &out) {
+    const size_t start = out.size();
+    out.push_back(BLOCK_PACKED);
+    U plain[CODEC_MINI], delta[CODEC_MINI];
+    for (size_t k0 = 0; k0 < n; k0 += CODEC_MINI) {
+        const size_t m = min(CODEC_MINI, n - k0);
+        U or_plain = 0, or_delta = 0;
+        for (size_t k = 0; k < m; ++k) {
+            size_t i = k0 + k;
+            plain[k] = zigzag_encode(in[i]);
+            delta[k] = zigzag_encode((U)(in[i] - (i >= cols ? in[i - cols] : U(0))));
+            or_plain |= plain[k];
+            or_delta |= delta[k];
+        }
+        const int wp = bits_needed(or_plain), wd = bits_needed(or_delta);
+        const bool use_delta = wd < wp;
+        const int w = use_delta ? wd : wp;
+        const U *v = use_delta ? delta : plain;
+        out.push_back((uint8_t)(w | (use_delta ? CODEC_DELTA : 0)));
+        for (int b = 0; b < w; ++b) {
+            uint64_t plane = 0;
+            for (size_t k = 0; k < m; ++k) plane |= (uint64_t)((v[k] >> b) & 1) << k;
+            uint8_t bytes[8];
+            memcpy(bytes, &plane, 8);
+            out.insert(out.end(), bytes, bytes + 8);
+        }
+    }
+    if (out.size() - start >= 1 + n * sizeof(U)) {
+        out.resize(start);
+        out.push_back(BLOCK_STORED);
+        const uint8_t *raw = (const uint8_t *)in;
+        out.insert(out.end(), raw, raw + n * sizeof(U));
+    }
+}
+
+// ---------------------------
+// Decoder
+// ---------------------------
+// byte k of spread8[x] is bit k of x
+struct Spread8 {
+    uint64_t t[256];
+    Spread8() {
+        for (int x = 0; x < 256; ++x) {
+            t[x] = 0;
+            for (int k = 0; k < 8; ++k) t[x] |= (uint64_t)((x >> k) & 1) << (8 * k);
+        }
+    }
+};
+
+// zig-zag values of one mini-block (all 64 lanes) from its w planes
+template <class U>
+void codec_decode_mini(const uint8_t *planes, int w, U *z) {
+    if constexpr (sizeof(U) == 1) {
+        static const Spread8 spread;
+        uint64_t v[8] = {};
+        for (int b = 0; b < w; ++b)
+            for (int g = 0; g < 8; ++g) v[g] |= spread.t[planes[8 * b + g]] << b;
+        memcpy(z, v, 64);
+    } else {
+        // eight planes at a time through the byte expansion, then widened
+        alignas(8) uint8_t bytes[CODEC_MINI];
+        fill(z, z + CODEC_MINI, U(0));
+        for (int b = 0; b < w; b += 8) {
+            codec_decode_mini(planes + 8 * b, min(8, w - b), bytes);
+            for (size_t k = 0; k < CODEC_MINI; ++k) z[k] |= (U)bytes[k] << b;
+        }
+    }
+}
+
+// one mini-block of zig-zag values into out[k0, k0 + m)
+template <class U>
+void codec_finish_mini(const U *z, size_t k0, size_t m, size_t cols, bool delta, U *out) {
+    if constexpr (sizeof(U) == 1) {
+        // eight bytes per word when the row above lies wholly before the mini-block
+        if (m == CODEC_MINI && (!delta || (k0 >= cols && cols >= CODEC_MINI))) {
+            const uint64_t lo7 = 0x7F7F7F7F7F7F7F7FULL, ones = 0x0101010101010101ULL;
+            for (size_t j = 0; j < CODEC_MINI; j += 8) {
+                uint64_t v, up;
+                memcpy(&v, z + j, 8);
+                v = ((v >> 1) & lo7) ^ ((v & ones) * 0xFF);
+                if (delta) {  // bytewise add without carries across bytes
+                    memcpy(&up, out + k0 + j - cols, 8);
+                    v = ((v & lo7) + (up & lo7)) ^ ((v ^ up) & ~lo7);
+                }
+                memcpy(out + k0 + j, &v, 8);
+            }
+            return;
+        }
+    }
+    for (size_t k = 0; k < m; ++k) {
+        size_t i = k0 + k;
+        U x = zigzag_decode(z[k]);
+        out[i] = delta && i >= cols ? (U)(x + out[i - cols]) : x;
+    }
+}
+
+// the mini-blocks of a packed block (p is past the mode byte); false when malformed
+template <class U>
+bool codec_decode_packed(const uint8_t *p, const uint8_t *end, size_t n, size_t cols, U *out) {
+    alignas(64) U z[CODEC_MINI];
+    for (size_t k0 = 0; k0 < n; k0 += CODEC_MINI) {
+        if (p >= end) return false;
+        const int w = *p & ~CODEC_DELTA;
+        const bool delta = *p++ & CODEC_DELTA;
+        if (w > (int)(8 * sizeof(U)) || p + 8 * w > end) return false;
+        codec_decode_mini(p, w, z);
+        p += 8 * w;
+        codec_finish_mini(z, k0, min(CODEC_MINI, n - k0), cols, delta, out);
+    }
+    return p == end;
+}
+
+#ifdef CODEC_DISPATCH
+// ---------------------------
+// Vector decoders, compiled for their instruction set whatever the build flags
+// ---------------------------
+// One plane sets bit b in the byte lanes it marks; a CodecVec covers 64 bytes
+// with AVX-512 and 32 with AVX2. Wider values are expanded eight planes at a
+// time as bytes and then widened into place.
+#pragma GCC push_options
+#pragma GCC target("avx512f,avx512bw")
+namespace codec_avx512 {
+using CodecVec = __m512i;
+inline CodecVec codec_zero() { return _mm512_setzero_si512(); }
+inline CodecVec codec_or(CodecVec a, CodecVec b) { return _mm512_or_si512(a, b); }
+inline CodecVec codec_load(const void *p) { return _mm512_loadu_si512(p); }
+inline void codec_store(void *p, CodecVec v) { _mm512_storeu_si512(p, v); }
+
+inline CodecVec codec_plane_bits(uint64_t plane, int, int b, uint8_t) {
+    return _mm512_maskz_set1_epi8(plane, (char)(1 << b));
+}
+// lanes [16 j, 16 j + 16) / [8 j, 8 j + 8) of 64 bytes, zero-extended and shifted left by b
+inline CodecVec codec_widen(const uint8_t *bytes, int j, int b, uint32_t) {
+    return _mm512_slli_epi32(_mm512_cvtepu8_epi32(_mm_loadu_si128((const __m128i *)(bytes + 16 * j))), b);
+}
+inline CodecVec codec_widen(const uint8_t *bytes, int j, int b, uint64_t) {
+    return _mm512_slli_epi64(_mm512_cvtepu8_epi64(_mm_loadl_epi64((const __m128i *)(bytes + 8 * j))), b);
+}
+inline CodecVec codec_unzigzag(CodecVec z, uint8_t) {
+    CodecVec half = _mm512_and_si512(_mm512_srli_epi16(z, 1), _mm512_set1_epi8(0x7F));
+    return _mm512_xor_si512(half, _mm512_sub_epi8(codec_zero(), _mm512_and_si512(z, _mm512_set1_epi8(1))));
+}
+inline CodecVec codec_unzigzag(CodecVec z, uint32_t) {
+    CodecVec sign = _mm512_sub_epi32(codec_zero(), _mm512_and_si512(z, _mm512_set1_epi32(1)));
+    return _mm512_xor_si512(_mm512_srli_epi32(z, 1), sign);
+}
+inline CodecVec codec_unzigzag(CodecVec z, uint64_t) {
+    CodecVec sign = _mm512_sub_epi64(codec_zero(), _mm512_and_si512(z, _mm512_set1_epi64(1)));
+    return _mm512_xor_si512(_mm512_srli_epi64(z, 1), sign);
+}
+inline CodecVec codec_add(CodecVec a, CodecVec b, uint8_t) { return _mm512_add_epi8(a, b); }
+inline CodecVec codec_add(CodecVec a, CodecVec b, uint32_t) { return _mm512_add_epi32(a, b); }
+inline CodecVec codec_add(CodecVec a, CodecVec b, uint64_t) { return _mm512_add_epi64(a, b); }
+
+#include "aura_codec_simd.h"
+} // namespace codec_avx512
+#pragma GCC pop_options
+
+#pragma GCC push_options
+#pragma GCC target("avx2")
+namespace codec_avx2 {
+using CodecVec = __m256i;
+inline CodecVec codec_zero() { return _mm256_setzero_si256(); }
+inline CodecVec codec_or(CodecVec a, CodecVec b) { return _mm256_or_si256(a, b); }
+inline CodecVec codec_load(const void *p) { return _mm256_loadu_si256((const __m256i *)p); }
+inline void codec_store(void *p, CodecVec v) { _mm256_storeu_si256((__m256i *)p, v); }
+
+inline CodecVec codec_plane_bits(uint64_t plane, int j, int b, uint8_t) {
+    // byte k of the 32 takes plane byte k / 8 (4 bytes per 128-bit half), then tests bit k % 8
+    const CodecVec spread = _mm256_setr_epi8(0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 1, 1, 1, 1,
+                                             2, 2, 2, 2, 2, 2, 2, 2, 3, 3, 3, 3, 3, 3, 3, 3);
+    const CodecVec sel = _mm256_set1_epi64x((long long)0x8040201008040201ULL);
+    CodecVec x = _mm256_and_si256(
+        _mm256_shuffle_epi8(_mm256_set1_epi32((int)(uint32_t)(plane >> (32 * j))), spread), sel);
+    return _mm256_and_si256(_mm256_cmpeq_epi8(x, sel), _mm256_set1_epi8((char)(1 << b)));
+}
+// lanes [8 j, 8 j + 8) / [4 j, 4 j + 4) of 64 bytes, zero-extended and shifted left by b
+inline CodecVec codec_widen(const uint8_t *bytes, int j, int b, uint32_t) {
+    return _mm256_slli_epi32(_mm256_cvtepu8_epi32(_mm_loadl_epi64((const __m128i *)(bytes + 8 * j))), b);
+}
+inline CodecVec codec_widen(const uint8_t *bytes, int j, int b, uint64_t) {
+    uint32_t four;
+    memcpy(&four, bytes + 4 * j, 4);
+    return _mm256_slli_epi64(_mm256_cvtepu8_epi64(_mm_cvtsi32_si128((int)four)), b);
+}
+inline CodecVec codec_unzigzag(CodecVec z, uint8_t) {
+    CodecVec half = _mm256_and_si256(_mm256_srli_epi16(z, 1), _mm256_set1_epi8(0x7F));
+    return _mm256_xor_si256(half, _mm256_sub_epi8(codec_zero(), _mm256_and_si256(z, _mm256_set1_epi8(1))));
+}
+inline CodecVec codec_unzigzag(CodecVec z, uint32_t) {
+    CodecVec sign = _mm256_sub_epi32(codec_zero(), _mm256_and_si256(z, _mm256_set1_epi32(1)));
+    return _mm256_xor_si256(_mm256_srli_epi32(z, 1), sign);
+}
+inline CodecVec codec_unzigzag(CodecVec z, uint64_t) {
+    CodecVec sign = _mm256_sub_epi64(codec_zero(), _mm256_and_si256(z, _mm256_set1_epi64x(1)));
+    return _mm256_xor_si256(_mm256_srli_epi64(z, 1), sign);
+}
+inline CodecVec codec_add(CodecVec a, CodecVec b, uint8_t) { return _mm256_add_epi8(a, b); }
+inline CodecVec codec_add(CodecVec a, CodecVec b, uint32_t) { return _mm256_add_epi32(a, b); }
+inline CodecVec codec_add(CodecVec a, CodecVec b, uint64_t) { return _mm256_add_epi64(a, b); }
+
+#include "aura_codec_simd.h"
+} // namespace codec_avx2
+#pragma GCC pop_options
+#endif // CODEC_DISPATCH
+
+// Decoder used by this process: the widest the CPU supports, or a narrower one
+// named by $AURA_CODEC_ISA (scalar, avx2, avx512) to compare the paths
+enum class CodecIsa { SCALAR, AVX2, AVX512 };
+
+inline const char *codec_isa_name(CodecIsa isa) {
+    switch (isa) {
+    case CodecIsa::AVX512: return "avx512";
+    case CodecIsa::AVX2: return "avx2";
+    default: return "scalar";
+    }
+}
+
+inline CodecIsa codec_isa() {
+    static const CodecIsa isa = [] {
+        CodecIsa best = CodecIsa::SCALAR;
+#ifdef CODEC_DISPATCH
+        __builtin_cpu_init();
+        if (__builtin_cpu_supports("avx512bw")) best = CodecIsa::AVX512;
+        else if (__builtin_cpu_supports("avx2")) best = CodecIsa::AVX2;
+#endif
+        if (const char *env = getenv("AURA_CODEC_ISA"))
+            for (CodecIsa want : {CodecIsa::SCALAR, CodecIsa::AVX2})
+                if (env == string(codec_isa_name(want)) && want < best) best = want;
+        return best;
+    }();
+    return isa;
+}
+
+// n values of a block from its encoding (len bytes); false when malformed
+template <class U>
+bool codec_decode_block(const uint8_t *p, size_t len, size_t n, size_t cols, U *out) {
+    const uint8_t *end = p + len;
+    if (len < 1) return false;
+    if (*p == BLOCK_STORED) {
+        if (len != 1 + n * sizeof(U)) return false;
+        memcpy(out, p + 1, n * sizeof(U));
+        return true;
+    }
+    if (*p++ != BLOCK_PACKED) return false;
+    switch (codec_isa()) {
+#ifdef CODEC_DISPATCH
+    case CodecIsa::AVX512: return codec_avx512::codec_decode_packed(p, end, n, cols, out);
+    case CodecIsa::AVX2: return codec_avx2::codec_decode_packed(p, end, n, cols, out);
+#endif
+    default: return codec_decode_packed(p, end, n, cols, out);
+    }
+}
+
+#endif // AURA_CODEC_H
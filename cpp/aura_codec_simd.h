@@ -0,0 +1,61 @@
+// Vector body of the aura_codec.h decoder. No include guard: aura_codec.h
+// includes it once per instruction set, inside that set's namespace and target
+// pragma, after defining CodecVec and the codec_* primitives for it.
+
+// the w planes of a mini-block as vectors of zig-zag values
+template <class U, int NV>
+inline void codec_expand(const uint8_t *planes, int w, CodecVec (&v)[NV]) {
+    for (int j = 0; j < NV; ++j) v[j] = codec_zero();
+    if constexpr (sizeof(U) == 1) {
+        for (int b = 0; b < w; ++b) {
+            uint64_t plane;
+            memcpy(&plane, planes + 8 * b, 8);
+            for (int j = 0; j < NV; ++j) v[j] = codec_or(v[j], codec_plane_bits(plane, j, b, U()));
+        }
+    } else {
+        constexpr int NB = CODEC_MINI / sizeof(CodecVec);
+        alignas(64) uint8_t bytes[CODEC_MINI];
+        for (int b = 0; b < w; b += 8) {
+            CodecVec vb[NB];
+            codec_expand<uint8_t>(planes + 8 * b, min(8, w - b), vb);
+            for (int j = 0; j < NB; ++j) codec_store(bytes + j * sizeof(CodecVec), vb[j]);
+            for (int j = 0; j < NV; ++j) v[j] = codec_or(v[j], codec_widen(bytes, j, b, U()));
+        }
+    }
+}
+
+// a full mini-block straight to out, in registers; `up` is the row above
+// (unused without delta), which must not overlap out[0, 64)
+template <class U>
+inline void codec_decode_whole(const uint8_t *planes, int w, bool delta, const U *up, U *out) {
+    constexpr int L = sizeof(CodecVec) / sizeof(U), NV = CODEC_MINI / L;
+    CodecVec v[NV];
+    codec_expand<U>(planes, w, v);
+    for (int j = 0; j < NV; ++j) {
+        v[j] = codec_unzigzag(v[j], U());
+        if (delta) v[j] = codec_add(v[j], codec_load(up + j * L), U());
+        codec_store(out + j * L, v[j]);
+    }
+}
+
+// the mini-blocks of a packed block (p is past the mode byte); short
+// mini-blocks and deltas against a row narrower than 64 take the scalar path
+template <class U>
+bool codec_decode_packed(const uint8_t *p, const uint8_t *end, size_t n, size_t cols, U *out) {
+    alignas(64) U z[CODEC_MINI];
+    for (size_t k0 = 0; k0 < n; k0 += CODEC_MINI) {
+        if (p >= end) return false;
+        const int w = *p & ~CODEC_DELTA;
+        const bool delta = *p++ & CODEC_DELTA;
+        if (w > (int)(8 * sizeof(U)) || p + 8 * w > end) return false;
+        const size_t m = min(CODEC_MINI, n - k0);
+        if (m == CODEC_MINI && (!delta || (k0 >= cols && cols >= CODEC_MINI))) {
+            codec_decode_whole(p, w, delta, out + k0 - (delta ? cols : 0), out + k0);
+        } else {
+            ::codec_decode_mini(p, w, z);
+            ::codec_finish_mini(z, k0, m, cols, delta, out);
+        }
+        p += 8 * w;
+    }
+    return p == end;
+}
@@ -0,0 +1,162 @@
+// Shared constants and small helpers for the cpp/ analysis tools.
+
+#ifndef AURA_COMMON_H
+#define AURA_COMMON_H
+
+#include <bits/stdc++.h>
+using namespace std;
+
+#include "aura_stats.h"
+
+static constexpr int AURA_DK = 64;             // `MAX_EMBEDDING_DIM
+static constexpr int AURA_SEQ = 512;           // `MAX_SEQ_LENGTH
+static constexpr int AURA_WORD_BYTES = 8;      // one 64-bit .mem line
+static constexpr double AURA_Q_FACTOR = 128;   // Q0.7 scale
+
+inline int clog2(int x) {
+    int r = 0;
+    while ((1 << r) < x) ++r;
+    return r;
+}
+
+inline int default_threads() {
+    unsigned n = thread::hardware_concurrency();
+    return n ? (int)n : 1;
+}
+
+// ---------------------------
+// Command-line values
+// ---------------------------
+// The whole string must be the number, so "-j x" or "--target 1.5x" is an error
+// rather than 0 or a silently truncated value
+inline int parse_int(const string &s) {
+    size_t used = 0;
+    int v = 0;
+    try {
+        v = stoi(s, &used);
+    } catch (const logic_error &) {
+        used = 0;
+    }
+    if (s.empty() || used != s.size()) throw runtime_error("Not an integer: '" + s + "'");
+    return v;
+}
+
+inline double parse_double(const string &s) {
+    size_t used = 0;
+    double v = 0;
+    try {
+        v = stod(s, &used);
+    } catch (const logic_error &) {
+        used = 0;
+    }
+    if (s.empty() || used != s.size()) throw runtime_error("Not a number: '" + s + "'");
+    return v;
+}
+
+// "1,2,,4" -> {1, 2, 4}
+inline vector<int> parse_list(const string &s) {
+    vector<int> out;
+    stringstream ss(s);
+    for (string tok; getline(ss, tok, ',');)
+        if (!tok.empty()) out.push_back(parse_int(tok));
+    if (out.empty()) throw runtime_error("Empty list: '" + s + "'");
+    return out;
+}
+
+// Run fn(row) for row in [0, rows) on `threads` workers (rows interleaved).
+// The first exception thrown by fn stops the other workers at their next row
+// and is rethrown here once every worker has joined.
+template <class F>
+void parallel_rows(int rows, int threads, F fn) {
+    threads = max(1, min(threads, rows));
+    mutex mu;
+    exception_ptr error;
+    atomic<bool> failed{false};
+    auto work = [&](int t) {
+        try {
+            for (int i = t; i < rows && !failed.load(memory_order_relaxed); i += threads) fn(i);
+        } catch (...) {
+            lock_guard<mutex> lock(mu);
+            if (!error) error = current_exception();
+            failed = true;
+        }
+    };
+    vector<thread> pool;
+    for (int t = 1; t < threads; ++t) pool.emplace_back(work, t);
+    work(0);
+    for (auto &th : pool) th.join();
+    if (error) rethrow_exception(error);
+}
+
+// Q0.7 quantization used by fp32_to_f8 / write_mem_matrix (round, clamp)
+template <class T>
+inline int8_t quantize_q07(T x) {
+    long q = lround(x * AURA_Q_FACTOR);
+    if (q > 127) q = 127;
+    if (q < -128) q = -128;
+    return (int8_t)q;
+}
+
+template <class T>
+vector<int8_t> quantize_q07(const vector<T> &data) {
+    StatScope scope("quantize");
+    stats_count(STAT_ELEMENTS, data.size());
+    vector<int8_t> out(data.size());
+    for (size_t i = 0; i < data.size(); ++i) out[i] = quantize_q07(data[i]);
+    return out;
+}
+
+template <class T>
+vector<T> dequantize_q07(const vector<int8_t> &data) {
+    vector<T> out(data.size());
+    for (size_t i = 0; i < data.size(); ++i) out[i] = T(data[i]) / T(AURA_Q_FACTOR);
+    return out;
+}
+
+// ---------------------------
+// Multi-head / grouped-query layout
+// ---------------------------
+// Heads are stacked along the rows (head-major). q_heads query heads share
+// kv_heads K/V heads: query head h reads K/V head h / group(). kv_heads == 1 is
+// multi-query attention, kv_heads == q_heads plain multi-head attention.
+struct HeadLayout {
+    int q_heads = 1, kv_heads = 1;
+
+    int group() const { return q_heads / kv_heads; }
+    int kv_head(int h) const { return h / group(); }
+    bool single() const { return q_heads == 1 && kv_heads == 1; }
+
+    void validate(size_t q_elems, size_t kv_elems, int dk) const {
+        if (q_heads <= 0 || kv_heads <= 0 || q_heads % kv_heads != 0)
+            throw runtime_error("Query heads must be a multiple of K/V heads");
+        if (q_elems % ((size_t)q_heads * dk) != 0 || kv_elems % ((size_t)kv_heads * dk) != 0)
+            throw runtime_error("Row counts do not split evenly into heads");
+    }
+};
+
+// Run attend(Q_h, K_g, V_g) for every query head and stack the outputs;
+// `attend` is any single-head attention (reference, split-KV, model, simv)
+template <class T, class F>
+vector<T> attention_by_head(const vector<T> &Q, const vector<T> &K, const vector<T> &V,
+                            const HeadLayout &heads, int dk, F attend) {
+    heads.validate(Q.size(), K.size(), dk);
+    if (heads.single()) return attend(Q, K, V);
+
+    const size_t q_len = Q.size() / heads.q_heads, kv_len = K.size() / heads.kv_heads;
+    vector<T> O;
+    O.reserve(Q.size());
+    vector<T> Kg, Vg;
+    for (int h = 0; h < heads.q_heads; ++h) {
+        int g = heads.kv_head(h);
+        if (h % heads.group() == 0) {  // K/V head shared by the next group() query heads
+            Kg.assign(K.begin() + g * kv_len, K.begin() + (g + 1) * kv_len);
+            Vg.assign(V.begin() + g * kv_len, V.begin() + (g + 1) * kv_len);
+        }
+        vector<T> Qh(Q.begin() + h * q_len, Q.begin() + (h + 1) * q_len);
+        vector<T> Oh = attend(Qh, Kg, Vg);
+        O.insert(O.end(), Oh.begin(), Oh.end());
+    }
+    return O;
+}
+
+#endif // AURA_COMMON_H
@@ -0,0 +1,173 @@
+#include "aura_mem.h"
+#include "aura_kvcache.h"
+#include "aura_import.h"
+
+// -----------------------------------------------------
+// Incremental decode over a persistent KV cache.
+//
+// Row t of Q/K/V is token t: each step appends K[t], V[t] to the cache and
+// computes only O[t] for Q[t] (causal attention over the resident rows).
+// --window W keeps the last W tokens (sliding eviction). --check recomputes
+// every step from scratch over the same window and requires identical bits.
+// -----------------------------------------------------
+
+struct DecodeOptions {
+    string engine = "cmodel";  // fp32 (FP32 .mem inputs) | fp64 | cmodel (Q0.7 inputs)
+    int window = 0;            // 0: keep every token
+    bool check = false;
+    ModelConfig cfg;
+};
+
+static void usage(const char *prog) {
+    cerr << "Usage: " << prog << " [options] <Q.mem> <K.mem> <V.mem> <O_int8.mem>\n"
+         << "  --engine fp32|fp64|cmodel  fp32 reads FP32 inputs (.mem, .bin, .npy, .safetensors),\n"
+         << "                             the others Q0.7 (default cmodel)\n"
+         << "  --window W                 sliding window of W cached tokens (default all)\n"
+         << "  --guard-bits N             Log2Exp guard bits for the C++ model\n"
+         << "  --check                    verify every step against a full recompute\n";
+}
+
+struct StepTimes {
+    vector<double> us;
+
+    void report(const string &engine, int window) const {
+        cout << "===== Decode (" << engine << ", window "
+             << (window ? to_string(window) : string("all")) << ") =====\n";
+        cout << "Tokens        : " << us.size() << "\n";
+        if (us.empty()) return;
+        vector<double> sorted = us;
+        sort(sorted.begin(), sorted.end());
+        double total = accumulate(us.begin(), us.end(), 0.0);
+        cout << "Total         : " << total / 1000.0 << " ms\n";
+        cout << "Per token     : mean " << total / us.size() << " us, p50 "
+             << sorted[sorted.size() / 2] << " us, max " << sorted.back() << " us\n";
+        cout << "First / last  : " << us.front() << " us / " << us.back() << " us\n";
+    }
+};
+
+// Run every step through `step(t)` and time it
+template <class F>
+static StepTimes run_steps(int tokens, F step) {
+    StepTimes t;
+    t.us.reserve(tokens);
+    for (int i = 0; i < tokens; ++i) {
+        StatScope stat("decode step");
+        stats_count(STAT_ROWS, 1);
+        auto start = chrono::steady_clock::now();
+        step(i);
+        t.us.push_back(chrono::duration<double, micro>(chrono::steady_clock::now() - start).count());
+    }
+    return t;
+}
+
+template <class T>
+static vector<int8_t> decode_float(const vector<T> &Q, const vector<T> &K, const vector<T> &V,
+                                   const DecodeOptions &o, StepTimes &times) {
+    const int D = AURA_DK, tokens = (int)(K.size() / D);
+    KVCache<T> cache(D, o.window ? o.window : tokens);
+    vector<T> out(D), full(D);
+    vector<T> steps(o.check ? Q.size() : 0);  // unquantized step outputs, for --check
+    vector<int8_t> O(Q.size());
+
+    times = run_steps(tokens, [&](int t) {
+        cache.append(&K[(size_t)t * D], &V[(size_t)t * D]);
+        reference_decode_step(cache, &Q[(size_t)t * D], out.data());
+        for (int d = 0; d < D; ++d) O[(size_t)t * D + d] = quantize_q07(out[d]);
+        if (o.check) copy(out.begin(), out.end(), &steps[(size_t)t * D]);
+    });
+
+    if (o.check) {
+        for (int t = 0; t < tokens; ++t) {
+            int first = max(0, t + 1 - cache.capacity());
+            reference_attention_row(&Q[(size_t)t * D], &K[(size_t)first * D], &V[(size_t)first * D],
+                                    t + 1 - first, D, full.data());
+            if (memcmp(full.data(), &steps[(size_t)t * D], D * sizeof(T)) != 0)
+                throw runtime_error("Decode step " + to_string(t) + " differs from full recompute");
+        }
+        cerr << "Check: every step matches the full recompute\n";
+    }
+    return O;
+}
+
+static vector<int8_t> decode_model(const vector<int8_t> &Q, const vector<int8_t> &K,
+                                   const vector<int8_t> &V, const DecodeOptions &o,
+                                   StepTimes &times) {
+    const int D = AURA_DK, tokens = (int)(K.size() / D);
+    KVCache<int8_t> cache(D, o.window ? o.window : tokens);
+    vector<int8_t> O(Q.size()), full(D);
+
+    times = run_steps(tokens, [&](int t) {
+        cache.append(&K[(size_t)t * D], &V[(size_t)t * D]);
+        model_decode_step(cache, &Q[(size_t)t * D], &O[(size_t)t * D], o.cfg);
+    });
+
+    if (o.check) {
+        for (int t = 0; t < tokens; ++t) {
+            int first = max(0, t + 1 - cache.capacity());
+            model_attention_row(&Q[(size_t)t * D], &K[(size_t)first * D], &V[(size_t)first * D],
+                                t + 1 - first, full.data(), o.cfg);
+            if (memcmp(full.data(), &O[(size_t)t * D], D) != 0)
+                throw runtime_error("Decode step " + to_string(t) + " differs from full recompute");
+        }
+        cerr << "Check: every step matches the full recompute\n";
+    }
+    return O;
+}
+
+int main(int argc, char **argv) {
+    stats_init(argc, argv);
+    ios::sync_with_stdio(false);
+
+    DecodeOptions o;
+    vector<string> files;
+    try {
+        for (int i = 1; i < argc; ++i) {
+            string a = argv[i];
+            auto need = [&]() -> string {
+                if (i + 1 >= argc) throw runtime_error("Missing value for " + a);
+                return argv[++i];
+            };
+            if (a == "--engine") o.engine = need();
+            else if (a == "--window") o.window = max(0, stoi(need()));
+            else if (a == "--guard-bits") o.cfg.log2e_guard_bits = stoi(need());
+            else if (a == "--check") o.check = true;
+            else files.push_back(a);
+        }
+        if (o.engine != "fp32" && o.engine != "fp64" && o.engine != "cmodel")
+            throw runtime_error("Unknown engine " + o.engine);
+        o.cfg.derive();
+    } catch (const exception &e) {
+        cerr << "ERROR: " << e.what() << "\n";
+        return 1;
+    }
+    if (files.size() != 4) {
+        usage(argv[0]);
+        return 1;
+    }
+
+    try {
+        StepTimes times;
+        vector<int8_t> O;
+        if (o.engine == "fp32") {
+            auto Q = read_fp32_input(files[0]), K = read_fp32_input(files[1]), V = read_fp32_input(files[2]);
+            if (Q.size() != K.size() || K.size() != V.size()) throw runtime_error("Q/K/V sizes differ");
+            O = decode_float(Q, K, V, o, times);
+        } else {
+            auto Q = read_int8_mem(files[0]), K = read_int8_mem(files[1]), V = read_int8_mem(files[2]);
+            if (Q.size() != K.size() || K.size() != V.size()) throw runtime_error("Q/K/V sizes differ");
+            if (o.engine == "fp64")
+                O = decode_float(dequantize_q07<double>(Q), dequantize_q07<double>(K),
+                                 dequantize_q07<double>(V), o, times);
+            else
+                O = decode_model(Q, K, V, o, times);
+        }
+
+        times.report(o.engine, o.window);
+        cerr << "Writing output to " << files[3] << "...\n";
+        write_int8_mem(files[3], O);
+    } catch (const exception &e) {
+        cerr << "ERROR: " << e.what() << "\n";
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,184 @@
+#include "aura_mem.h"
+#include "aura_energy.h"
+
+// -----------------------------------------------------
+// Energy per token from operation counts.
+//
+// For every configuration (--recip-bits, 0 being int_division) the fixed-point
+// model runs over the Q/K/V inputs with operation counting enabled and the
+// performance model simulates the same shape for the SRAM and DRAM traffic.
+// The events are weighted by the energy table (built-in defaults, or --energy
+// FILE with "event pJ" lines) and reported as pJ per token (query row) with a
+// per-block breakdown.
+// -----------------------------------------------------
+
+struct EnergyOptions {
+    string q, k, v;
+    vector<int> recip_bits = {0};
+    string table;
+    bool print_table = false, events = false, help = false;
+    int threads = default_threads();
+    ModelConfig cfg;
+    PerfConfig perf;
+};
+
+static void usage(const char *prog) {
+    EnergyOptions d;
+    cerr << "Usage: " << prog << " [options]\n"
+         << "  --test NAME           Q/K/V.mem from models/NAME/\n"
+         << "  --q F --k F --v F     Q0.7 inputs\n"
+         << "  --guard-bits N        extra Log2Exp fraction bits (default 0)\n"
+         << "  --recip-bits LIST     normalisations to compare, 0 = int_division (default 0)\n"
+         << "  --pes N               processing elements (default " << d.perf.num_pes << ")\n"
+         << "  --bus-bytes N         memory block size (default " << d.perf.bus_bytes << ")\n"
+         << "  --energy FILE         per-event energies, 'event pJ' per line\n"
+         << "  --print-table         print the energy table in --energy format and exit\n"
+         << "  --events              also print the event counts\n"
+         << "  -j N                  worker threads (default " << default_threads() << ")\n";
+}
+
+static EnergyOptions parse_args(int argc, char **argv) {
+    EnergyOptions o;
+    auto need = [&](int &i) -> string {
+        if (i + 1 >= argc) throw runtime_error(string("Missing value for ") + argv[i]);
+        return argv[++i];
+    };
+    for (int i = 1; i < argc; ++i) {
+        string a = argv[i];
+        if (a == "--test") {
+            string dir = "models/" + need(i) + "/";
+            o.q = dir + "Q.mem"; o.k = dir + "K.mem"; o.v = dir + "V.mem";
+        }
+        else if (a == "--q") o.q = need(i);
+        else if (a == "--k") o.k = need(i);
+        else if (a == "--v") o.v = need(i);
+        else if (a == "--guard-bits") o.cfg.log2e_guard_bits = parse_int(need(i));
+        else if (a == "--recip-bits") o.recip_bits = parse_list(need(i));
+        else if (a == "--pes") o.perf.num_pes = parse_int(need(i));
+        else if (a == "--bus-bytes") o.perf.bus_bytes = parse_int(need(i));
+        else if (a == "--energy") o.table = need(i);
+        else if (a == "--print-table") o.print_table = true;
+        else if (a == "--events") o.events = true;
+        else if (a == "-j") o.threads = max(1, parse_int(need(i)));
+        else if (a == "-h" || a == "--help") {
+            o.help = true;
+            return o;
+        }
+        else throw runtime_error("Unknown option " + a);
+    }
+    if (!o.print_table && (o.q.empty() || o.k.empty() || o.v.empty()))
+        throw runtime_error("No Q/K/V inputs given");
+    o.cfg.derive();
+    return o;
+}
+
+// Operation counts of the model over every query row, one counter per thread
+static OpCounts count_ops(const vector<int8_t> &Q, const vector<int8_t> &K, const vector<int8_t> &V,
+                          const ModelConfig &cfg, int threads) {
+    const int D = cfg.embedding_dim, rows = (int)(Q.size() / D), rows_kv = (int)(K.size() / D);
+    vector<OpCounts> per(threads);
+    vector<int8_t> O(Q.size());
+    MatrixView<const int8_t> Kv(K, D), Vv(V, D);
+    parallel_rows(threads, threads, [&](int t) {
+        ModelConfig local = cfg;
+        local.ops = &per[t];
+        for (int i = t; i < rows; i += threads)
+            model_attention_row(&Q[(size_t)i * D], Kv, Vv, rows_kv, &O[(size_t)i * D], local);
+    });
+    OpCounts all;
+    for (const auto &p : per) all.merge(p);
+    return all;
+}
+
+int main(int argc, char **argv) {
+    stats_init(argc, argv);
+    ios::sync_with_stdio(false);
+
+    EnergyOptions o;
+    try {
+        o = parse_args(argc, argv);
+    } catch (const exception &e) {
+        cerr << "ERROR: " << e.what() << "\n";
+        return 1;
+    }
+    if (o.help) {
+        usage(argv[0]);
+        return 0;
+    }
+
+    try {
+        EnergyTable table = o.table.empty() ? EnergyTable() : load_energy_table(o.table);
+        if (o.print_table) {
+            for (int e = 0; e < NUM_ENERGY_EVENTS; ++e)
+                cout << left << setw(16) << energy_event_name(e) << table.pj[e] << "\n";
+            return 0;
+        }
+
+        const int D = o.cfg.embedding_dim;
+        auto Q = read_int8_mem(o.q), K = read_int8_mem(o.k), V = read_int8_mem(o.v);
+        if (K.size() != V.size()) throw runtime_error("K and V have different sizes");
+        const int rows = (int)(Q.size() / D), rows_kv = (int)(K.size() / D);
+
+        PerfConfig pc = o.perf;
+        pc.seq_len = rows_kv;
+        pc.q_rows = rows;
+        pc.dk = D;
+        PerfResult perf = perf_simulate(pc);
+
+        cout << "===== Energy Estimate =====\n";
+        cout << "Inputs        : " << o.q << " (" << rows << " x " << D << "), K/V rows " << rows_kv << "\n";
+        cout << "Hardware      : " << pc.num_pes << " PEs, bus " << pc.bus_bytes << " B, " << perf.cycles
+             << " cycles\n";
+        cout << "Energy table  : " << (o.table.empty() ? "built-in 45 nm estimate" : o.table) << "\n";
+
+        vector<EnergyCounts> counts;
+        for (int bits : o.recip_bits) {
+            ModelConfig cfg = o.cfg;
+            cfg.recip_bits = bits;
+            cfg.derive();
+            counts.emplace_back(count_ops(Q, K, V, cfg, o.threads), perf, pc);
+        }
+
+        auto label = [&](size_t c) {
+            return o.recip_bits[c] ? "recip " + to_string(o.recip_bits[c]) + " bits" : string("int_division");
+        };
+        cout << "\n" << left << setw(18) << "block";
+        for (size_t c = 0; c < counts.size(); ++c) cout << setw(22) << label(c);
+        cout << "\n";
+        vector<array<double, NUM_ENERGY_BLOCKS>> blocks;
+        for (const auto &c : counts) blocks.push_back(c.blocks(table));
+        for (int b = 0; b < NUM_ENERGY_BLOCKS; ++b) {
+            cout << left << setw(18) << energy_block_name(b);
+            for (size_t c = 0; c < counts.size(); ++c) {
+                double total = counts[c].total(table);
+                stringstream cell;
+                cell << fixed << setprecision(1) << blocks[c][b] / rows << " (" << setprecision(1)
+                     << 100.0 * blocks[c][b] / total << "%)";
+                cout << setw(22) << cell.str();
+            }
+            cout << "\n";
+        }
+        cout << left << setw(18) << "pJ / token";
+        for (const auto &c : counts) cout << setw(22) << fixed << setprecision(1) << c.total(table) / rows;
+        cout << "\n" << left << setw(18) << "uJ / head";
+        for (const auto &c : counts) cout << setw(22) << setprecision(3) << c.total(table) * 1e-6;
+        cout << "\n" << defaultfloat;
+        cout << "(per-block rows are pJ per token and share of the total)\n";
+
+        if (o.events) {
+            cout << "\nEvents per token\n" << left << setw(18) << "event" << setw(10) << "pJ";
+            for (size_t c = 0; c < counts.size(); ++c) cout << setw(22) << label(c);
+            cout << "\n";
+            for (int e = 0; e < NUM_ENERGY_EVENTS; ++e) {
+                cout << left << setw(18) << energy_event_name(e) << setprecision(6) << setw(10) << table.pj[e];
+                for (const auto &c : counts) cout << setw(22) << fixed << setprecision(2) << c.n[e] / rows;
+                cout << "\n" << defaultfloat;
+            }
+        }
+
+    } catch (const exception &e) {
+        cerr << "ERROR: " << e.what() << "\n";
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,129 @@
+// Energy estimate from operation counts.
+//
+// The fixed-point model counts the datapath operations (ModelConfig::ops) and
+// the performance model the SRAM accesses and memory traffic of the same
+// problem (PerfResult). Every event is weighted by an entry of an EnergyTable,
+// and the result is summed per hardware block.
+//
+// The default table is a rough 45 nm estimate (Horowitz, ISSCC 2014, scaled to
+// the operand widths of sys_defs.svh); load_energy_table() replaces any subset
+// of it from a file of "event pJ" lines.
+
+#ifndef AURA_ENERGY_H
+#define AURA_ENERGY_H
+
+#include "aura_model.h"
+#include "aura_perf.h"
+
+// model operations first, in ModelOp order
+enum EnergyEvent {
+    EV_QSRAM_RD = NUM_MODEL_OPS, EV_QSRAM_WR, EV_KSRAM_RD, EV_KSRAM_WR,
+    EV_VSRAM_RD, EV_VSRAM_WR, EV_OSRAM_RD, EV_OSRAM_WR,
+    EV_DRAM_RD_BYTE, EV_DRAM_WR_BYTE,
+    NUM_ENERGY_EVENTS
+};
+
+enum EnergyBlock {
+    BLOCK_DOT, BLOCK_MAX, BLOCK_EXPMUL, BLOCK_DIV,
+    BLOCK_QSRAM, BLOCK_KSRAM, BLOCK_VSRAM, BLOCK_OSRAM, BLOCK_DRAM,
+    NUM_ENERGY_BLOCKS
+};
+
+inline const char *energy_event_name(int e) {
+    static const char *names[] = {"qsram_rd", "qsram_wr", "ksram_rd", "ksram_wr", "vsram_rd",
+                                  "vsram_wr", "osram_rd", "osram_wr", "dram_rd_byte", "dram_wr_byte"};
+    return e < NUM_MODEL_OPS ? model_op_name(e) : names[e - NUM_MODEL_OPS];
+}
+
+inline const char *energy_block_name(int b) {
+    static const char *names[NUM_ENERGY_BLOCKS] = {"dot_product", "max", "expmul", "vector_division",
+                                                   "QSRAM", "KSRAM", "VSRAM", "OSRAM", "DRAM"};
+    return names[b];
+}
+
+inline EnergyBlock energy_block(int e) {
+    switch (e) {
+    case OP_MUL8: case OP_TREE_ADD: return BLOCK_DOT;
+    case OP_MAX_CMP: return BLOCK_MAX;
+    case OP_LOG2E_ADD: case OP_EXP_SHIFT: case OP_VEC_ADD: return BLOCK_EXPMUL;
+    case OP_DIV_ITER: case OP_RECIP_LUT: case OP_RECIP_MUL: return BLOCK_DIV;
+    case EV_QSRAM_RD: case EV_QSRAM_WR: return BLOCK_QSRAM;
+    case EV_KSRAM_RD: case EV_KSRAM_WR: return BLOCK_KSRAM;
+    case EV_VSRAM_RD: case EV_VSRAM_WR: return BLOCK_VSRAM;
+    case EV_OSRAM_RD: case EV_OSRAM_WR: return BLOCK_OSRAM;
+    default: return BLOCK_DRAM;
+    }
+}
+
+// pJ per event; SRAM events are one dk-byte vector, DRAM events one byte
+struct EnergyTable {
+    double pj[NUM_ENERGY_EVENTS];
+
+    EnergyTable() {
+        pj[OP_MUL8] = 0.2;        // 8 x 8 multiply
+        pj[OP_TREE_ADD] = 0.05;   // ~20-bit add
+        pj[OP_MAX_CMP] = 0.03;
+        pj[OP_LOG2E_ADD] = 0.03;
+        pj[OP_EXP_SHIFT] = 0.02;  // one mux level of a ~30-bit barrel shifter
+        pj[OP_VEC_ADD] = 0.07;    // ~30-bit add
+        pj[OP_DIV_ITER] = 0.06;   // 18-bit subtract + select
+        pj[OP_RECIP_LUT] = 0.5;
+        pj[OP_RECIP_MUL] = 1.5;   // ~18 x 32 multiply
+        pj[EV_QSRAM_RD] = pj[EV_QSRAM_WR] = 40;   // small SRAM, 8 x 64-bit words
+        pj[EV_OSRAM_RD] = pj[EV_OSRAM_WR] = 40;
+        pj[EV_KSRAM_RD] = pj[EV_KSRAM_WR] = 80;   // 32 KB SRAM
+        pj[EV_VSRAM_RD] = pj[EV_VSRAM_WR] = 80;
+        pj[EV_DRAM_RD_BYTE] = pj[EV_DRAM_WR_BYTE] = 160;  // ~1.3 nJ per 64-bit access
+    }
+};
+
+// "event pJ" per line, '#' starts a comment; events not listed keep their value
+inline EnergyTable load_energy_table(const string &path) {
+    ifstream in(path);
+    if (!in) throw runtime_error("Cannot open " + path);
+    EnergyTable t;
+    string line;
+    for (int n = 1; getline(in, line); ++n) {
+        line = line.substr(0, line.find('#'));
+        stringstream ss(line);
+        string name;
+        double pj;
+        if (!(ss >> name)) continue;
+        if (!(ss >> pj)) throw runtime_error(path + ":" + to_string(n) + ": expected 'event pJ'");
+        int e = 0;
+        while (e < NUM_ENERGY_EVENTS && name != energy_event_name(e)) ++e;
+        if (e == NUM_ENERGY_EVENTS) throw runtime_error(path + ":" + to_string(n) + ": unknown event " + name);
+        t.pj[e] = pj;
+    }
+    return t;
+}
+
+// ---------------------------
+// Events of one run
+// ---------------------------
+struct EnergyCounts {
+    double n[NUM_ENERGY_EVENTS] = {};
+
+    EnergyCounts(const OpCounts &ops, const PerfResult &r, const PerfConfig &c) {
+        for (int i = 0; i < NUM_MODEL_OPS; ++i) n[i] = (double)ops.n[i];
+        for (int s = 0; s < NUM_SRAMS; ++s) {
+            n[EV_QSRAM_RD + 2 * s] = (double)r.sram_reads[s];
+            n[EV_QSRAM_WR + 2 * s] = (double)r.sram_writes[s];
+        }
+        n[EV_DRAM_RD_BYTE] = (double)r.mem_loads * c.bus_bytes;
+        n[EV_DRAM_WR_BYTE] = (double)r.mem_stores * c.bus_bytes;
+    }
+
+    // pJ per block
+    array<double, NUM_ENERGY_BLOCKS> blocks(const EnergyTable &t) const {
+        array<double, NUM_ENERGY_BLOCKS> b{};
+        for (int e = 0; e < NUM_ENERGY_EVENTS; ++e) b[energy_block(e)] += n[e] * t.pj[e];
+        return b;
+    }
+    double total(const EnergyTable &t) const {
+        auto b = blocks(t);
+        return accumulate(b.begin(), b.end(), 0.0);
+    }
+};
+
+#endif // AURA_ENERGY_H
@@ -0,0 +1,215 @@
+// Staged executor for batch runs: bounded queues between worker pools.
+//
+//   cases -> [ingest] -> queue -> [compute] -> queue -> [egress]
+//
+// Every stage has its own worker count and every queue a fixed depth. A full
+// queue blocks its producers (back-pressure), so a fast reader can run at most
+// `depth` cases ahead of the compute workers instead of loading the whole batch.
+// While the compute workers run case i, the ingest stage parses case i+1 and the
+// egress stage writes and compares case i-1.
+//
+// If any worker throws, every queue is cancelled so the other stages unblock,
+// and Pipeline::wait() rethrows the first exception.
+
+#ifndef AURA_EXECUTOR_H
+#define AURA_EXECUTOR_H
+
+#include "aura_common.h"
+
+// ---------------------------
+// Bounded MPMC queue
+// ---------------------------
+template <class T>
+class BoundedQueue {
+public:
+    explicit BoundedQueue(size_t capacity) : capacity_(max<size_t>(capacity, 1)) {}
+
+    // Blocks while full. False once the queue is cancelled (the item is dropped).
+    bool push(T item) {
+        unique_lock<mutex> lock(mu_);
+        if (items_.size() >= capacity_ && !cancelled_) {
+            ++push_waits_;
+            not_full_.wait(lock, [&] { return items_.size() < capacity_ || cancelled_; });
+        }
+        if (cancelled_) return false;
+        if (closed_) throw runtime_error("push to a closed queue");
+        items_.push_back(std::move(item));
+        high_water_ = max(high_water_, items_.size());
+        not_empty_.notify_one();
+        return true;
+    }
+
+    // Blocks while empty. nullopt once the queue is closed and drained, or cancelled.
+    optional<T> pop() {
+        unique_lock<mutex> lock(mu_);
+        not_empty_.wait(lock, [&] { return !items_.empty() || closed_ || cancelled_; });
+        if (cancelled_ || items_.empty()) return nullopt;
+        T item = std::move(items_.front());
+        items_.pop_front();
+        not_full_.notify_one();
+        return item;
+    }
+
+    // No more pushes; consumers drain what is left
+    void close() {
+        lock_guard<mutex> lock(mu_);
+        closed_ = true;
+        not_empty_.notify_all();
+    }
+
+    // Abort: producers and consumers return immediately
+    void cancel() {
+        lock_guard<mutex> lock(mu_);
+        cancelled_ = true;
+        items_.clear();
+        not_empty_.notify_all();
+        not_full_.notify_all();
+    }
+
+    size_t capacity() const { return capacity_; }
+    size_t high_water() const {
+        lock_guard<mutex> lock(mu_);
+        return high_water_;
+    }
+    // times a producer found the queue full and had to wait
+    size_t push_waits() const {
+        lock_guard<mutex> lock(mu_);
+        return push_waits_;
+    }
+
+private:
+    const size_t capacity_;
+    mutable mutex mu_;
+    condition_variable not_empty_, not_full_;
+    deque<T> items_;
+    bool closed_ = false, cancelled_ = false;
+    size_t high_water_ = 0, push_waits_ = 0;
+};
+
+// ---------------------------
+// Worker pools connected by queues
+// ---------------------------
+struct StageStats {
+    string name;
+    int workers = 0;
+    size_t items = 0;
+    double busy = 0;     // seconds summed over the workers, excluding queue waits
+    double blocked = 0;  // seconds spent waiting on a full output queue
+};
+
+class Pipeline {
+public:
+    Pipeline() = default;
+    Pipeline(const Pipeline &) = delete;
+    Pipeline &operator=(const Pipeline &) = delete;
+    ~Pipeline() {
+        cancel_all();
+        join();
+    }
+
+    // Register a queue so that a failing stage can cancel it
+    template <class T>
+    BoundedQueue<T> &queue(size_t depth) {
+        auto q = make_shared<BoundedQueue<T>>(depth);
+        cancels_.push_back([q] { q->cancel(); });
+        owned_.push_back(q);
+        return *q;
+    }
+
+    // `workers` threads pop from `in`, run fn(item, emit) and may call emit(out_item)
+    // any number of times. `out` is closed once the last worker of the stage exits.
+    template <class In, class Out, class F>
+    void stage(const string &name, int workers, BoundedQueue<In> &in, BoundedQueue<Out> &out, F fn) {
+        auto emit = [&out](Out item) {
+            auto t0 = chrono::steady_clock::now();
+            bool ok = out.push(std::move(item));
+            emit_wait_ += chrono::duration<double>(chrono::steady_clock::now() - t0).count();
+            if (!ok) throw Cancelled{};
+        };
+        spawn(name, workers, in, [fn, emit](In item) mutable { fn(std::move(item), emit); },
+              [&out] { out.close(); });
+    }
+
+    // Final stage: no output queue
+    template <class In, class F>
+    void sink(const string &name, int workers, BoundedQueue<In> &in, F fn) {
+        spawn(name, workers, in, [fn](In item) mutable { fn(std::move(item)); }, [] {});
+    }
+
+    // Join every worker; rethrows the first exception a stage raised
+    void wait() {
+        join();
+        if (error_) rethrow_exception(error_);
+    }
+
+    const vector<StageStats> &stats() const { return stats_; }
+
+private:
+    struct Cancelled {};
+
+    template <class In, class Run, class Done>
+    void spawn(const string &name, int workers, BoundedQueue<In> &in, Run run, Done done) {
+        workers = max(1, workers);
+        size_t s;
+        {
+            lock_guard<mutex> lock(mu_);
+            s = stats_.size();
+            stats_.push_back({name, workers, 0, 0.0, 0.0});
+        }
+        auto remaining = make_shared<atomic<int>>(workers);
+        for (int w = 0; w < workers; ++w) {
+            threads_.emplace_back([this, s, &in, run, done, remaining]() mutable {
+                size_t items = 0;
+                double busy = 0;
+                emit_wait_ = 0;
+                try {
+                    while (auto item = in.pop()) {
+                        auto t0 = chrono::steady_clock::now();
+                        run(std::move(*item));
+                        busy += chrono::duration<double>(chrono::steady_clock::now() - t0).count();
+                        ++items;
+                    }
+                } catch (const Cancelled &) {
+                } catch (...) {
+                    fail(current_exception());
+                }
+                {
+                    lock_guard<mutex> lock(mu_);
+                    stats_[s].items += items;
+                    stats_[s].busy += busy - emit_wait_;
+                    stats_[s].blocked += emit_wait_;
+                }
+                if (--*remaining == 0) done();
+            });
+        }
+    }
+
+    void fail(exception_ptr e) {
+        {
+            lock_guard<mutex> lock(mu_);
+            if (!error_) error_ = e;
+        }
+        cancel_all();
+    }
+
+    void cancel_all() {
+        for (auto &c : cancels_) c();
+    }
+
+    void join() {
+        for (auto &t : threads_)
+            if (t.joinable()) t.join();
+        threads_.clear();
+    }
+
+    static inline thread_local double emit_wait_ = 0;  // per worker thread
+
+    mutex mu_;
+    exception_ptr error_;
+    vector<StageStats> stats_;
+    vector<thread> threads_;
+    vector<function<void()>> cancels_;
+    vector<shared_ptr<void>> owned_;
+};
+
+#endif // AURA_EXECUTOR_H
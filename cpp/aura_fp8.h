@@ -0,0 +1,178 @@
+// FP8 (OCP E4M3 / E5M2) encode and decode helpers shared by the FP8 tools.
+//
+// E4M3 follows the "FN" variant: bias 7, no infinities, 0x7F/0xFF are NaN,
+// largest finite value is 448. E5M2 is IEEE-like: bias 15, exponent 31 holds
+// inf/NaN, largest finite value is 57344.
+//
+// Encoding is round-to-nearest-even with saturation to the largest finite
+// value (what a quantizer wants: an out of range activation clips instead of
+// turning into inf/NaN). Decoding goes through a 256 entry table.
+//
+// Bytes are stored in .mem files exactly like the Q0.7 int8 data: 8 values per
+// 64-bit line, LSB-first, so an FP8 tensor costs the same bus bandwidth as the
+// fixed-point one.
+
+#ifndef AURA_FP8_H
+#define AURA_FP8_H
+
+#include <bits/stdc++.h>
+#ifdef __AVX2__
+#include <immintrin.h>
+#endif
+using namespace std;
+
+enum class Fp8Format { E4M3, E5M2 };
+
+struct Fp8Traits {
+    int mant_bits;      // stored mantissa bits
+    int bias;           // exponent bias
+    uint8_t max_code;   // code of the largest finite magnitude
+    uint8_t nan_code;   // canonical NaN magnitude
+    float max_value;    // largest finite magnitude
+};
+
+inline Fp8Traits fp8_traits(Fp8Format fmt) {
+    if (fmt == Fp8Format::E4M3) return {3, 7, 0x7E, 0x7F, 448.0f};
+    return {2, 15, 0x7B, 0x7F, 57344.0f};
+}
+
+inline const char *fp8_name(Fp8Format fmt) {
+    return fmt == Fp8Format::E4M3 ? "e4m3" : "e5m2";
+}
+
+inline Fp8Format parse_fp8_format(const string &s) {
+    if (s == "e4m3" || s == "E4M3") return Fp8Format::E4M3;
+    if (s == "e5m2" || s == "E5M2") return Fp8Format::E5M2;
+    throw runtime_error("Unknown FP8 format '" + s + "' (expected e4m3 or e5m2)");
+}
+
+inline uint32_t fp8_f2u(float f) { uint32_t u; memcpy(&u, &f, 4); return u; }
+inline float fp8_u2f(uint32_t u) { float f; memcpy(&f, &u, 4); return f; }
+
+// ---------------------------
+// Scalar FP32 -> FP8
+// ---------------------------
+inline uint8_t fp32_to_fp8(float f, Fp8Format fmt) {
+    const Fp8Traits t = fp8_traits(fmt);
+    uint32_t u = fp8_f2u(f);
+    uint8_t sign = (u >> 24) & 0x80;
+    u &= 0x7FFFFFFFu;
+
+    if (u > 0x7F800000u) return sign | t.nan_code;              // NaN
+    if (u >= fp8_f2u(t.max_value)) return sign | t.max_code;    // saturate (incl. inf)
+
+    const int shift = 23 - t.mant_bits;
+    if (u < (uint32_t)(128 - t.bias) << 23) {
+        // subnormal or zero: let the FPU round by aligning against a magic
+        // number whose ulp equals the FP8 subnormal step
+        uint32_t magic = (uint32_t)((127 - t.bias) + shift + 1) << 23;
+        float r = fp8_u2f(u) + fp8_u2f(magic);
+        return sign | (uint8_t)(fp8_f2u(r) - magic);
+    }
+
+    // normal: rebias and round-to-nearest-even on the dropped mantissa bits
+    uint32_t mant_odd = (u >> shift) & 1;
+    u += ((uint32_t)(t.bias - 127) << 23) + ((1u << (shift - 1)) - 1) + mant_odd;
+    return sign | (uint8_t)(u >> shift);
+}
+
+// ---------------------------
+// FP8 -> FP32 decode table
+// ---------------------------
+inline const float *fp8_decode_table(Fp8Format fmt) {
+    static const auto build = [](Fp8Format f) {
+        const Fp8Traits t = fp8_traits(f);
+        array<float, 256> lut{};
+        const int exp_max = (1 << (7 - t.mant_bits)) - 1;
+        for (int c = 0; c < 256; ++c) {
+            int e = (c >> t.mant_bits) & exp_max;
+            int m = c & ((1 << t.mant_bits) - 1);
+            float v;
+            if (f == Fp8Format::E4M3 && (c & 0x7F) == 0x7F)
+                v = numeric_limits<float>::quiet_NaN();
+            else if (f == Fp8Format::E5M2 && e == exp_max)
+                v = m ? numeric_limits<float>::quiet_NaN() : numeric_limits<float>::infinity();
+            else if (e == 0)
+                v = ldexp((float)m, 1 - t.bias - t.mant_bits);
+            else
+                v = ldexp(1.0f + (float)m / (1 << t.mant_bits), e - t.bias);
+            lut[c] = (c & 0x80) ? -v : v;
+        }
+        return lut;
+    };
+    static const array<float, 256> e4m3 = build(Fp8Format::E4M3);
+    static const array<float, 256> e5m2 = build(Fp8Format::E5M2);
+    return fmt == Fp8Format::E4M3 ? e4m3.data() : e5m2.data();
+}
+
+inline float fp8_to_fp32(uint8_t c, Fp8Format fmt) {
+    return fp8_decode_table(fmt)[c];
+}
+
+// ---------------------------
+// Bulk conversion (AVX2 when available, scalar tail / fallback)
+// ---------------------------
+#ifdef __AVX2__
+// 8 lanes of the scalar encoder above; returns the codes in the low byte of
+// each 32-bit lane
+inline __m256i fp8_encode8(__m256 x, const Fp8Traits &t) {
+    const int shift = 23 - t.mant_bits;
+    const __m256i u_raw = _mm256_castps_si256(x);
+    const __m256i sign = _mm256_and_si256(_mm256_srli_epi32(u_raw, 24), _mm256_set1_epi32(0x80));
+    const __m256i u = _mm256_and_si256(u_raw, _mm256_set1_epi32(0x7FFFFFFF));
+
+    // normal path
+    __m256i odd = _mm256_and_si256(_mm256_srli_epi32(u, shift), _mm256_set1_epi32(1));
+    __m256i n = _mm256_add_epi32(u, _mm256_set1_epi32((int)(((uint32_t)(t.bias - 127) << 23) + ((1u << (shift - 1)) - 1))));
+    n = _mm256_srli_epi32(_mm256_add_epi32(n, odd), shift);
+
+    // subnormal path
+    const __m256i magic = _mm256_set1_epi32((int)((uint32_t)((127 - t.bias) + shift + 1) << 23));
+    __m256 r = _mm256_add_ps(_mm256_castsi256_ps(u), _mm256_castsi256_ps(magic));
+    __m256i s = _mm256_sub_epi32(_mm256_castps_si256(r), magic);
+
+    // u is a non-negative int32 here so signed compares are safe
+    __m256i is_sub = _mm256_cmpgt_epi32(_mm256_set1_epi32((int)((uint32_t)(128 - t.bias) << 23)), u);
+    __m256i is_sat = _mm256_cmpgt_epi32(u, _mm256_set1_epi32((int)fp8_f2u(t.max_value) - 1));
+    __m256i is_nan = _mm256_cmpgt_epi32(u, _mm256_set1_epi32(0x7F800000));
+
+    __m256i code = _mm256_blendv_epi8(n, s, is_sub);
+    code = _mm256_blendv_epi8(code, _mm256_set1_epi32(t.max_code), is_sat);
+    code = _mm256_blendv_epi8(code, _mm256_set1_epi32(t.nan_code), is_nan);
+    return _mm256_or_si256(code, sign);
+}
+#endif
+
+inline void fp32_to_fp8_n(const float *in, uint8_t *out, size_t n, Fp8Format fmt) {
+    size_t i = 0;
+#ifdef __AVX2__
+    const Fp8Traits t = fp8_traits(fmt);
+    // gathers byte 0 of each 32-bit lane into the low 4 bytes of each 128-bit half
+    const __m256i pick = _mm256_setr_epi8(0, 4, 8, 12, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+                                          0, 4, 8, 12, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1);
+    for (; i + 8 <= n; i += 8) {
+        __m256i c = _mm256_shuffle_epi8(fp8_encode8(_mm256_loadu_ps(in + i), t), pick);
+        uint32_t lo = (uint32_t)_mm256_extract_epi32(c, 0);
+        uint32_t hi = (uint32_t)_mm256_extract_epi32(c, 4);
+        memcpy(out + i, &lo, 4);
+        memcpy(out + i + 4, &hi, 4);
+    }
+#endif
+    for (; i < n; ++i) out[i] = fp32_to_fp8(in[i], fmt);
+}
+
+inline void fp8_to_fp32_n(const uint8_t *in, float *out, size_t n, Fp8Format fmt) {
+    const float *lut = fp8_decode_table(fmt);
+    size_t i = 0;
+#ifdef __AVX2__
+    for (; i + 8 <= n; i += 8) {
+        uint64_t b;
+        memcpy(&b, in + i, 8);
+        __m256i idx = _mm256_cvtepu8_epi32(_mm_cvtsi64_si128((long long)b));
+        _mm256_storeu_ps(out + i, _mm256_i32gather_ps(lut, idx, 4));
+    }
+#endif
+    for (; i < n; ++i) out[i] = lut[in[i]];
+}
+
+#endif // AURA_FP8_H
@@ -0,0 +1,135 @@
+// Buffered hex text output for .mem files.
+//
+// Every .mem line the tools write is built from fixed-width uppercase hex
+// fields, exactly what $readmemh in test/aura_test.sv reads back:
+//   int8 / fp8 / int16 : one 64-bit word per line, element 0 in the least
+//                        significant bits
+//   fp32               : 8 floats per line, each as 8 digits of its
+//                        memory-order (byte-swapped) bits
+// HexWriter formats fields through a byte -> two digit table into one buffer
+// and hands it to write(2) once per file, or once per chunk for outputs larger
+// than the chunk size.
+
+#ifndef AURA_HEX_H
+#define AURA_HEX_H
+
+#include "aura_common.h"
+
+#include <fcntl.h>
+#include <unistd.h>
+
+// "00" .. "FF"
+struct HexTable {
+    char digits[256][2];
+    constexpr HexTable() : digits() {
+        const char *h = "0123456789ABCDEF";
+        for (int i = 0; i < 256; ++i) {
+            digits[i][0] = h[i >> 4];
+            digits[i][1] = h[i & 15];
+        }
+    }
+};
+inline constexpr HexTable HEX_TABLE{};
+
+// ---------------------------
+// Word packing (LSB-first, as the RTL memories store them)
+// ---------------------------
+template <class T>
+inline uint64_t pack_word(const T *p) {
+    static_assert(is_integral_v<T> && 8 % sizeof(T) == 0, "packs 1, 2 or 4 byte integers");
+    constexpr int n = 8 / sizeof(T), bits = 8 * sizeof(T);
+    constexpr uint64_t mask = bits == 64 ? ~0ULL : (1ULL << bits) - 1;
+    uint64_t packed = 0;
+    for (int e = 0; e < n; ++e) packed |= (uint64_t(make_unsigned_t<T>(p[e])) & mask) << (bits * e);
+    return packed;
+}
+
+class HexWriter {
+public:
+    static constexpr size_t CHUNK = 16 << 20;
+
+    // size_hint: expected output bytes, so small files go out in one write()
+    explicit HexWriter(const string &filename, size_t size_hint = 0) : filename_(filename) {
+        fd_ = ::open(filename.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+        if (fd_ < 0) throw runtime_error("Cannot open for writing " + filename);
+        buf_.reserve(min(max<size_t>(size_hint, 4096), CHUNK));
+    }
+    ~HexWriter() {
+        if (fd_ >= 0) {
+            try {
+                close();
+            } catch (...) {
+            }
+        }
+    }
+    HexWriter(const HexWriter &) = delete;
+    HexWriter &operator=(const HexWriter &) = delete;
+
+    // 16 digits and a newline: one int8/fp8/int16 .mem line
+    void word64(uint64_t v) {
+        char *p = grow(17);
+        for (int b = 0; b < 8; ++b) {
+            const char *d = HEX_TABLE.digits[(v >> (56 - 8 * b)) & 0xFF];
+            p[2 * b] = d[0];
+            p[2 * b + 1] = d[1];
+        }
+        p[16] = '\n';
+    }
+
+    // 8 digits, no newline: one field of an fp32 .mem line
+    void hex32(uint32_t v) {
+        char *p = grow(8);
+        for (int b = 0; b < 4; ++b) {
+            const char *d = HEX_TABLE.digits[(v >> (24 - 8 * b)) & 0xFF];
+            p[2 * b] = d[0];
+            p[2 * b + 1] = d[1];
+        }
+    }
+
+    // a float as its memory-order bytes (Generate_QKV.py's tobytes().hex())
+    void fp32(float f) {
+        uint32_t bits;
+        memcpy(&bits, &f, sizeof(bits));
+        hex32(__builtin_bswap32(bits));
+    }
+
+    void newline() { *grow(1) = '\n'; }
+
+    void flush() {
+        stats_count(STAT_BYTES_WRITTEN, buf_.size());
+        const char *p = buf_.data();
+        size_t left = buf_.size();
+        while (left > 0) {
+            ssize_t n = ::write(fd_, p, left);
+            if (n < 0) {
+                if (errno == EINTR) continue;
+                throw runtime_error("Write failed for " + filename_);
+            }
+            p += n;
+            left -= (size_t)n;
+        }
+        buf_.clear();
+    }
+
+    void close() {
+        flush();
+        int fd = fd_;
+        fd_ = -1;
+        if (::close(fd) != 0) throw runtime_error("Write failed for " + filename_);
+    }
+
+private:
+    char *grow(size_t n) {
+        if (buf_.size() + n > CHUNK) flush();
+        size_t at = buf_.size();
+        buf_.resize(at + n);
+        return buf_.data() + at;
+    }
+
+    StatScope scope_{"write"};   // formatting and write(2), open to close
+    string filename_;
+    int fd_ = -1;
+    string buf_;
+};
+
+#endif // AURA_HEX_H
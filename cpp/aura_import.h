@@ -0,0 +1,510 @@
+// Activation dumps from the Python side: .npy and .safetensors, read in place.
+//
+// The file is mmapped and only the selected rows are converted, so a full
+// model's Q/K/V set (every layer and head in one safetensors file) opens in
+// the time it takes to parse its JSON header. Supported element types are
+// fp32, fp16, bf16 and fp64 (little-endian, C order).
+//
+// A tensor is named by a spec:
+//   FILE.npy[INDEX]
+//   FILE.safetensors[:TENSOR][INDEX]      (TENSOR may be omitted if there is one)
+// INDEX is numpy-like over the leading axes: an integer drops the axis, ':'
+// keeps it and 'a:b' keeps a range; missing axes are ':'. The last axis must
+// be kept and becomes the columns, every other kept axis is flattened into
+// rows. Layer 3, head 5 of a [layers, tokens, heads, dk] dump is "[3,:,5]";
+// head 5 of a [tokens, heads * dk] dump is "[:,320:384]".
+
+#ifndef AURA_IMPORT_H
+#define AURA_IMPORT_H
+
+#include "aura_mem.h"
+#include "aura_tensor.h"
+
+#ifdef __F16C__
+#include <immintrin.h>
+#endif
+
+enum class ImportDType { F32, F16, BF16, F64 };
+
+inline size_t import_dtype_size(ImportDType t) {
+    switch (t) {
+    case ImportDType::F16: case ImportDType::BF16: return 2;
+    case ImportDType::F64: return 8;
+    default: return 4;
+    }
+}
+
+inline const char *import_dtype_name(ImportDType t) {
+    switch (t) {
+    case ImportDType::F32: return "fp32";
+    case ImportDType::F16: return "fp16";
+    case ImportDType::BF16: return "bf16";
+    case ImportDType::F64: return "fp64";
+    }
+    return "?";
+}
+
+// ---------------------------
+// Half-precision decode
+// ---------------------------
+inline float fp16_to_fp32(uint16_t h) {
+    uint32_t sign = (uint32_t)(h & 0x8000) << 16, exp = (h >> 10) & 0x1F, mant = h & 0x3FF, u;
+    if (exp == 0x1F) {
+        u = sign | 0x7F800000 | (mant << 13);           // inf / NaN
+    } else if (exp) {
+        u = sign | ((exp + 112) << 23) | (mant << 13);
+    } else if (mant) {                                   // subnormal: normalise
+        int e = -1;
+        do { mant <<= 1; ++e; } while (!(mant & 0x400));
+        u = sign | ((uint32_t)(112 - e) << 23) | ((mant & 0x3FF) << 13);
+    } else {
+        u = sign;
+    }
+    float f;
+    memcpy(&f, &u, 4);
+    return f;
+}
+
+inline float bf16_to_fp32(uint16_t b) {
+    uint32_t u = (uint32_t)b << 16;
+    float f;
+    memcpy(&f, &u, 4);
+    return f;
+}
+
+// n elements of dtype t at p (any alignment) to T
+template <class T>
+void import_convert(const uint8_t *p, ImportDType t, size_t n, T *out) {
+    size_t i = 0;
+    switch (t) {
+    case ImportDType::F32:
+        for (; i < n; ++i) {
+            float f;
+            memcpy(&f, p + 4 * i, 4);
+            out[i] = T(f);
+        }
+        break;
+    case ImportDType::F64:
+        for (; i < n; ++i) {
+            double d;
+            memcpy(&d, p + 8 * i, 8);
+            out[i] = T(d);
+        }
+        break;
+    case ImportDType::F16:
+#ifdef __F16C__
+        if constexpr (is_same_v<T, float>)
+            for (; i + 8 <= n; i += 8)
+                _mm256_storeu_ps(out + i, _mm256_cvtph_ps(_mm_loadu_si128((const __m128i *)(p + 2 * i))));
+#endif
+        for (; i < n; ++i) {
+            uint16_t h;
+            memcpy(&h, p + 2 * i, 2);
+            out[i] = T(fp16_to_fp32(h));
+        }
+        break;
+    case ImportDType::BF16:
+        for (; i < n; ++i) {
+            uint16_t b;
+            memcpy(&b, p + 2 * i, 2);
+            out[i] = T(bf16_to_fp32(b));
+        }
+        break;
+    }
+}
+
+// ---------------------------
+// One tensor inside a mapped file
+// ---------------------------
+struct ImportedTensor {
+    string name;                     // empty for .npy
+    string file;                     // the file it was read from
+    ImportDType dtype = ImportDType::F32;
+    vector<size_t> shape;
+    const uint8_t *data = nullptr;   // into the mapping
+
+    // for messages: "name in file", or the file alone for .npy
+    string label() const { return name.empty() ? file : name + " in " + file; }
+
+    // bytes of the whole tensor; false when the shape overflows
+    bool byte_size(uint64_t &out) const {
+        out = import_dtype_size(dtype);
+        for (size_t d : shape)
+            if (__builtin_mul_overflow(out, (uint64_t)d, &out)) return false;
+        return true;
+    }
+};
+
+// Rows of a selection: every row is `cols` contiguous elements starting at
+// offset + sum(index_k * outer_stride[k]) over the kept leading axes
+struct TensorSlice {
+    size_t offset = 0, cols = 0;     // in elements
+    vector<size_t> outer_count, outer_stride;
+
+    size_t rows() const {
+        size_t n = 1;
+        for (size_t c : outer_count) n *= c;
+        return n;
+    }
+    size_t row_offset(size_t r) const {
+        size_t off = offset;
+        for (size_t k = outer_count.size(); k-- > 0;) {
+            off += (r % outer_count[k]) * outer_stride[k];
+            r /= outer_count[k];
+        }
+        return off;
+    }
+};
+
+inline TensorSlice slice_tensor(const ImportedTensor &t, const string &index) {
+    const size_t dims = t.shape.size();
+    if (dims == 0) throw runtime_error(t.label() + " is a scalar");
+    vector<string> parts;
+    if (!index.empty()) {
+        if (index.front() != '[' || index.back() != ']') throw runtime_error("Bad tensor index " + index);
+        stringstream ss(index.substr(1, index.size() - 2));
+        for (string tok; getline(ss, tok, ',');) {
+            tok.erase(remove_if(tok.begin(), tok.end(), ::isspace), tok.end());
+            parts.push_back(tok);
+        }
+    }
+    if (parts.size() > dims) throw runtime_error("Too many indices for " + t.label());
+    parts.resize(dims, ":");
+
+    vector<size_t> stride(dims, 1);
+    for (size_t k = dims - 1; k-- > 0;) stride[k] = stride[k + 1] * t.shape[k + 1];
+
+    TensorSlice s;
+    for (size_t k = 0; k < dims; ++k) {
+        const string &p = parts[k];
+        size_t colon = p.find(':'), begin = 0, end = t.shape[k];
+        bool keep = colon != string::npos;
+        if (!keep) {
+            begin = stoul(p);
+            end = begin + 1;
+        } else {
+            if (colon > 0) begin = stoul(p.substr(0, colon));
+            if (colon + 1 < p.size()) end = stoul(p.substr(colon + 1));
+        }
+        if (begin >= end || end > t.shape[k])
+            throw runtime_error("Index " + p + " is out of range for axis " + to_string(k) + " of " + t.label());
+        s.offset += begin * stride[k];
+        if (k == dims - 1) {
+            if (!keep) throw runtime_error("The last axis of " + t.label() + " must be kept (it is the columns)");
+            s.cols = end - begin;
+        } else if (keep) {
+            s.outer_count.push_back(end - begin);
+            s.outer_stride.push_back(stride[k]);
+        }
+    }
+    return s;
+}
+
+// selected rows converted to T, row-major rows() x cols
+template <class T>
+vector<T> read_slice(const ImportedTensor &t, const TensorSlice &s) {
+    StatScope scope("parse");
+    const size_t rows = s.rows(), es = import_dtype_size(t.dtype);
+    stats_count(STAT_BYTES_READ, rows * s.cols * es);
+    vector<T> out(rows * s.cols);
+    for (size_t r = 0; r < rows; ++r)
+        import_convert(t.data + s.row_offset(r) * es, t.dtype, s.cols, &out[r * s.cols]);
+    return out;
+}
+
+// ---------------------------
+// Read-only mmap of a .npy or .safetensors file
+// ---------------------------
+class TensorFile {
+public:
+    explicit TensorFile(const string &filename) : filename_(filename) {
+        int fd = open(filename.c_str(), O_RDONLY);
+        if (fd < 0) throw runtime_error("Cannot open " + filename);
+        struct stat st {};
+        if (fstat(fd, &st) != 0) {
+            close(fd);
+            throw runtime_error("Cannot stat " + filename);
+        }
+        size_ = (size_t)st.st_size;
+        base_ = size_ ? mmap(nullptr, size_, PROT_READ, MAP_SHARED, fd, 0) : MAP_FAILED;
+        close(fd);
+        if (base_ == MAP_FAILED) {
+            base_ = nullptr;
+            throw runtime_error("Cannot mmap " + filename);
+        }
+        try {
+            if (ends_with(filename, ".npy")) parse_npy();
+            else if (ends_with(filename, ".safetensors")) parse_safetensors();
+            else throw runtime_error(filename + " is neither .npy nor .safetensors");
+        } catch (...) {
+            munmap(base_, size_);
+            throw;
+        }
+    }
+    ~TensorFile() {
+        if (base_) munmap(base_, size_);
+    }
+    TensorFile(const TensorFile &) = delete;
+    TensorFile &operator=(const TensorFile &) = delete;
+
+    const vector<ImportedTensor> &tensors() const { return tensors_; }
+
+    // "" selects the only tensor of the file
+    const ImportedTensor &tensor(const string &name) const {
+        if (name.empty()) {
+            if (tensors_.size() != 1) throw runtime_error(filename_ + " holds several tensors; name one");
+            return tensors_[0];
+        }
+        for (const auto &t : tensors_)
+            if (t.name == name) return t;
+        throw runtime_error("No tensor " + name + " in " + filename_);
+    }
+
+    static bool ends_with(const string &s, const string &suffix) {
+        return s.size() >= suffix.size() && s.compare(s.size() - suffix.size(), suffix.size(), suffix) == 0;
+    }
+
+private:
+    string filename_;
+    void *base_ = nullptr;
+    size_t size_ = 0;
+    vector<ImportedTensor> tensors_;
+
+    const uint8_t *bytes() const { return (const uint8_t *)base_; }
+
+    void check_extent(const ImportedTensor &t, uint64_t begin, uint64_t end) const {
+        uint64_t bytes;
+        if (!t.byte_size(bytes)) throw runtime_error("Shape of " + t.label() + " is too large");
+        if (begin > end || end > size_ || end - begin != bytes)
+            throw runtime_error("Truncated data of " + t.label());
+    }
+
+    // ---- .npy: magic, version, header length, Python dict literal, data ----
+    void parse_npy() {
+        const uint8_t *p = bytes();
+        if (size_ < 10 || memcmp(p, "\x93NUMPY", 6) != 0) throw runtime_error(filename_ + " is not a .npy file");
+        size_t hlen, start;
+        if (p[6] == 1) {
+            hlen = p[8] | (size_t)p[9] << 8;
+            start = 10;
+        } else {
+            if (size_ < 12) throw runtime_error("Truncated .npy header in " + filename_);
+            hlen = p[8] | (size_t)p[9] << 8 | (size_t)p[10] << 16 | (size_t)p[11] << 24;
+            start = 12;
+        }
+        if (hlen > size_ - start) throw runtime_error("Truncated .npy header in " + filename_);
+        string h((const char *)p + start, hlen);
+
+        auto field = [&](const string &key) {
+            size_t k = h.find("'" + key + "'");
+            if (k == string::npos) throw runtime_error(filename_ + ": .npy header has no " + key);
+            size_t v = h.find(':', k) + 1;
+            while (v < h.size() && isspace((unsigned char)h[v])) ++v;
+            return v;
+        };
+        size_t d = field("descr");
+        string descr = h.substr(d + 1, h.find(h[d], d + 1) - d - 1);
+        ImportedTensor t;
+        t.file = filename_;
+        if (descr == "<f4") t.dtype = ImportDType::F32;
+        else if (descr == "<f2") t.dtype = ImportDType::F16;
+        else if (descr == "<f8") t.dtype = ImportDType::F64;
+        else throw runtime_error(filename_ + ": unsupported .npy dtype " + descr);
+        if (h.compare(field("fortran_order"), 4, "True") == 0)
+            throw runtime_error(filename_ + ": Fortran-order arrays are not supported");
+        size_t s = field("shape") + 1;
+        for (size_t e = h.find(')', s); s < e;) {
+            while (s < e && !isdigit((unsigned char)h[s])) ++s;
+            if (s == e) break;
+            size_t used;
+            t.shape.push_back(stoul(h.substr(s), &used));
+            s += used;
+        }
+        check_extent(t, start + hlen, size_);
+        t.data = p + start + hlen;
+        tensors_.push_back(std::move(t));
+    }
+
+    // ---- .safetensors: u64 header length, JSON header, data ----
+    void parse_safetensors() {
+        if (size_ < 8) throw runtime_error(filename_ + " is not a safetensors file");
+        uint64_t hlen;
+        memcpy(&hlen, bytes(), 8);
+        if (hlen > size_ - 8) throw runtime_error("Truncated safetensors header in " + filename_);
+        const char *p = (const char *)bytes() + 8, *end = p + hlen;
+        const size_t data_start = 8 + hlen;
+
+        auto fail = [&]() -> runtime_error { return runtime_error("Malformed safetensors header in " + filename_); };
+        auto skip_ws = [&] {
+            while (p < end && isspace((unsigned char)*p)) ++p;
+        };
+        auto expect = [&](char c) {
+            skip_ws();
+            if (p == end || *p != c) throw fail();
+            ++p;
+        };
+        auto peek = [&]() {
+            skip_ws();
+            if (p == end) throw fail();
+            return *p;
+        };
+        auto string_ = [&] {
+            expect('"');
+            string s;
+            while (p < end && *p != '"') {
+                if (*p == '\\' && p + 1 < end) ++p;
+                s += *p++;
+            }
+            if (p == end) throw fail();
+            ++p;
+            return s;
+        };
+        auto numbers = [&] {
+            vector<size_t> v;
+            expect('[');
+            if (peek() == ']') {
+                ++p;
+                return v;
+            }
+            for (;;) {
+                skip_ws();
+                char *e;
+                v.push_back(strtoull(p, &e, 10));
+                if (e == p) throw fail();
+                p = e;
+                if (peek() == ']') break;
+                expect(',');
+            }
+            ++p;
+            return v;
+        };
+        function<void()> skip_value = [&] {
+            char c = peek();
+            if (c == '"') {
+                string_();
+            } else if (c == '{' || c == '[') {
+                char close = c == '{' ? '}' : ']';
+                ++p;
+                if (peek() == close) {
+                    ++p;
+                    return;
+                }
+                for (;;) {
+                    if (close == '}') {
+                        string_();
+                        expect(':');
+                    }
+                    skip_value();
+                    if (peek() == close) break;
+                    expect(',');
+                }
+                ++p;
+            } else {
+                while (p < end && *p != ',' && *p != '}' && *p != ']') ++p;
+            }
+        };
+
+        expect('{');
+        if (peek() == '}') return;
+        for (;;) {
+            string name = string_();
+            expect(':');
+            if (name == "__metadata__") {
+                skip_value();
+            } else {
+                ImportedTensor t;
+                t.name = name;
+                t.file = filename_;
+                vector<size_t> offsets;
+                string dtype;
+                expect('{');
+                for (;;) {
+                    string key = string_();
+                    expect(':');
+                    if (key == "dtype") dtype = string_();
+                    else if (key == "shape") t.shape = numbers();
+                    else if (key == "data_offsets") offsets = numbers();
+                    else skip_value();
+                    if (peek() == '}') break;
+                    expect(',');
+                }
+                ++p;
+                if (dtype == "F32") t.dtype = ImportDType::F32;
+                else if (dtype == "F16") t.dtype = ImportDType::F16;
+                else if (dtype == "BF16") t.dtype = ImportDType::BF16;
+                else if (dtype == "F64") t.dtype = ImportDType::F64;
+                else throw runtime_error(filename_ + ": " + name + " has unsupported dtype " + dtype);
+                uint64_t begin, stop;
+                if (offsets.size() != 2 || __builtin_add_overflow(data_start, offsets[0], &begin) ||
+                    __builtin_add_overflow(data_start, offsets[1], &stop))
+                    throw fail();
+                check_extent(t, begin, stop);
+                t.data = bytes() + begin;
+                tensors_.push_back(std::move(t));
+            }
+            if (peek() == '}') break;
+            expect(',');
+        }
+    }
+};
+
+// ---------------------------
+// Specs
+// ---------------------------
+struct TensorSpec {
+    string file, tensor, index;
+};
+
+inline TensorSpec parse_tensor_spec(const string &spec) {
+    TensorSpec s;
+    size_t ext = spec.find(".safetensors");
+    size_t cut = ext != string::npos ? ext + 12 : spec.find(".npy");
+    if (cut == string::npos) throw runtime_error(spec + " names neither a .npy nor a .safetensors file");
+    if (ext == string::npos) cut += 4;
+    s.file = spec.substr(0, cut);
+    string rest = spec.substr(cut);
+    size_t bracket = rest.find('[');
+    s.index = bracket == string::npos ? "" : rest.substr(bracket);
+    rest = rest.substr(0, bracket);
+    if (!rest.empty()) {
+        if (rest[0] != ':' || ext == string::npos) throw runtime_error("Bad tensor spec " + spec);
+        s.tensor = rest.substr(1);
+    }
+    return s;
+}
+
+inline bool is_tensor_spec(const string &path) {
+    return path.find(".npy") != string::npos || path.find(".safetensors") != string::npos;
+}
+
+// rows x cols values of a spec; cols (the last axis) is returned through *cols
+template <class T>
+vector<T> read_tensor_spec(const string &spec, size_t *cols = nullptr) {
+    TensorSpec s = parse_tensor_spec(spec);
+    TensorFile f(s.file);
+    const ImportedTensor &t = f.tensor(s.tensor);
+    TensorSlice slice = slice_tensor(t, s.index);
+    if (cols) *cols = slice.cols;
+    return read_slice<T>(t, slice);
+}
+
+// FP32 activations from a .mem, a .bin tensor or a .npy / .safetensors spec
+inline vector<float> read_fp32_input(const string &spec) {
+    if (is_tensor_spec(spec)) {
+        size_t cols;
+        auto data = read_tensor_spec<float>(spec, &cols);
+        if (cols != (size_t)AURA_DK)
+            throw runtime_error(spec + " has " + to_string(cols) + " columns, expected " + to_string(AURA_DK));
+        return data;
+    }
+    if (TensorFile::ends_with(spec, ".bin")) {
+        MappedTensor t(spec);
+        if (t.cols() != (size_t)AURA_DK) throw runtime_error(spec + " does not have " + to_string(AURA_DK) + " columns");
+        vector<float> data(t.rows() * t.cols());
+        t.read_rows(0, t.rows(), data.data());
+        return data;
+    }
+    return read_fp32_mem(spec);
+}
+
+#endif // AURA_IMPORT_H
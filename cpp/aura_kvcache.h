@@ -0,0 +1,61 @@
+// Persistent K/V cache for incremental (autoregressive) decode.
+//
+// A ring buffer of `capacity` K/V rows: append() adds the newest token and,
+// once full, evicts the oldest (sliding window). Rows are addressed oldest
+// first, which is the order the PE accumulates them in, so a decode step
+// gives the same result as recomputing attention over the window.
+
+#ifndef AURA_KVCACHE_H
+#define AURA_KVCACHE_H
+
+#include "aura_model.h"
+#include "aura_reference.h"
+
+template <class T>
+class KVCache {
+public:
+    KVCache(int dk, int capacity) : dk_(dk), cap_(capacity), k_((size_t)dk * capacity), v_(k_.size()) {
+        if (dk <= 0 || capacity <= 0) throw runtime_error("KV cache needs dk > 0 and capacity > 0");
+    }
+
+    int dk() const { return dk_; }
+    int capacity() const { return cap_; }
+    int size() const { return (int)min<int64_t>(appended_, cap_); }
+    int64_t appended() const { return appended_; }  // tokens seen, including evicted ones
+
+    void append(const T *k_row, const T *v_row) {
+        size_t slot = (size_t)(appended_ % cap_) * dk_;
+        copy(k_row, k_row + dk_, &k_[slot]);
+        copy(v_row, v_row + dk_, &v_[slot]);
+        appended_++;
+    }
+
+    void clear() { appended_ = 0; }
+
+    // j = 0 is the oldest resident row
+    pair<const T *, const T *> row(int j) const {
+        int64_t first = appended_ > cap_ ? appended_ - cap_ : 0;
+        size_t slot = (size_t)((first + j) % cap_) * dk_;
+        return {&k_[slot], &v_[slot]};
+    }
+
+private:
+    int dk_, cap_;
+    vector<T> k_, v_;
+    int64_t appended_ = 0;
+};
+
+// ---------------------------
+// One decode step: output for query q over every resident row
+// ---------------------------
+template <class T>
+void reference_decode_step(const KVCache<T> &cache, const T *q, T *out) {
+    reference_attention_row_kv(q, cache.size(), [&](int j) { return cache.row(j); }, cache.dk(), out);
+}
+
+inline void model_decode_step(const KVCache<int8_t> &cache, const int8_t *q, int8_t *out,
+                              const ModelConfig &cfg) {
+    model_attention_row_kv(q, cache.size(), [&](int j) { return cache.row(j); }, out, cfg);
+}
+
+#endif // AURA_KVCACHE_H
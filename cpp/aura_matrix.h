@@ -0,0 +1,209 @@
+// Contiguous row-major tensors for the cpp/ tools.
+//
+// Matrix<T> owns one 64-byte aligned allocation. Every row starts on a 64-byte
+// boundary: the row stride is `cols` rounded up to whole cache lines and the
+// padding is zero (a 64 x int8 or 64 x float row needs none). MatrixView<T> is
+// a non-owning (data, rows, cols, stride) window onto a Matrix, a flat vector
+// or an mmapped tensor; kernels, writers and comparators take views, so none of
+// them care where the rows live.
+//
+// Per-row temporaries (scores, accumulators) come from the calling thread's
+// ScratchArena instead of the heap.
+
+#ifndef AURA_MATRIX_H
+#define AURA_MATRIX_H
+
+#include "aura_common.h"
+
+static constexpr size_t AURA_ALIGN = 64;  // cache line / AVX-512 vector
+
+inline size_t align_up(size_t bytes, size_t align = AURA_ALIGN) {
+    return (bytes + align - 1) / align * align;
+}
+
+template <class T>
+struct AlignedAllocator {
+    using value_type = T;
+
+    AlignedAllocator() = default;
+    template <class U>
+    AlignedAllocator(const AlignedAllocator<U> &) {}
+
+    T *allocate(size_t n) {
+        void *p = ::operator new(align_up(n * sizeof(T)), align_val_t(AURA_ALIGN));
+        return static_cast<T *>(p);
+    }
+    void deallocate(T *p, size_t) { ::operator delete(p, align_val_t(AURA_ALIGN)); }
+
+    template <class U>
+    bool operator==(const AlignedAllocator<U> &) const { return true; }
+    template <class U>
+    bool operator!=(const AlignedAllocator<U> &) const { return false; }
+};
+
+template <class T>
+using aligned_vector = vector<T, AlignedAllocator<T>>;
+
+// ---------------------------
+// Non-owning view
+// ---------------------------
+template <class T>
+struct MatrixView {
+    T *data = nullptr;
+    size_t rows = 0, cols = 0, stride = 0;  // stride in elements
+
+    MatrixView() = default;
+    MatrixView(T *d, size_t r, size_t c, size_t s = 0) : data(d), rows(r), cols(c), stride(s ? s : c) {}
+
+    // a flat row-major vector with `cols` elements per row
+    template <class V, class = decltype(declval<V &>().data())>
+    MatrixView(V &flat, size_t c) : MatrixView(flat.data(), flat.size() / c, c) {}
+
+    T *row(size_t i) const { return data + i * stride; }
+    T &operator()(size_t i, size_t j) const { return data[i * stride + j]; }
+    size_t size() const { return rows * cols; }
+    bool contiguous() const { return stride == cols; }
+
+    MatrixView slice(size_t begin, size_t n) const { return MatrixView(row(begin), n, cols, stride); }
+
+    operator MatrixView<const T>() const { return MatrixView<const T>(data, rows, cols, stride); }
+};
+
+// ---------------------------
+// Owning, aligned, padded
+// ---------------------------
+template <class T>
+class Matrix {
+public:
+    static_assert(AURA_ALIGN % sizeof(T) == 0, "rows are padded to whole cache lines");
+
+    Matrix() = default;
+    Matrix(size_t rows, size_t cols)
+        : rows_(rows), cols_(cols), stride_(align_up(cols * sizeof(T)) / sizeof(T)),
+          data_(rows * stride_, T(0)) {}
+
+    // copy of a flat row-major buffer
+    static Matrix from_flat(const T *flat, size_t rows, size_t cols) {
+        Matrix m(rows, cols);
+        for (size_t i = 0; i < rows; ++i) copy(flat + i * cols, flat + (i + 1) * cols, m.row(i));
+        return m;
+    }
+
+    size_t rows() const { return rows_; }
+    size_t cols() const { return cols_; }
+    size_t stride() const { return stride_; }
+    size_t size() const { return rows_ * cols_; }
+
+    T *row(size_t i) { return data_.data() + i * stride_; }
+    const T *row(size_t i) const { return data_.data() + i * stride_; }
+    T &operator()(size_t i, size_t j) { return data_[i * stride_ + j]; }
+    const T &operator()(size_t i, size_t j) const { return data_[i * stride_ + j]; }
+
+    MatrixView<T> view() { return MatrixView<T>(data_.data(), rows_, cols_, stride_); }
+    MatrixView<const T> view() const { return MatrixView<const T>(data_.data(), rows_, cols_, stride_); }
+    operator MatrixView<T>() { return view(); }
+    operator MatrixView<const T>() const { return view(); }
+
+    // row-major without padding (cache keys, flat APIs)
+    vector<T> flatten() const {
+        vector<T> out;
+        out.reserve(size());
+        for (size_t i = 0; i < rows_; ++i) out.insert(out.end(), row(i), row(i) + cols_);
+        return out;
+    }
+
+private:
+    size_t rows_ = 0, cols_ = 0, stride_ = 0;
+    aligned_vector<T> data_;
+};
+
+template <class T>
+Matrix<T> to_matrix(MatrixView<const T> v) {
+    Matrix<T> m(v.rows, v.cols);
+    for (size_t i = 0; i < v.rows; ++i) copy(v.row(i), v.row(i) + v.cols, m.row(i));
+    return m;
+}
+
+// ---------------------------
+// Per-thread scratch
+// ---------------------------
+// A bump allocator: alloc() hands out aligned, uninitialized storage and a
+// ScratchScope gives it back when it goes out of scope. Memory is kept between
+// uses, so the steady state of a row loop does no heap allocation at all.
+class ScratchArena {
+public:
+    struct Mark {
+        size_t blocks, used;
+    };
+
+    template <class T>
+    T *alloc(size_t n) {
+        static_assert(is_trivially_copyable_v<T>, "scratch is uninitialized storage");
+        size_t bytes = align_up(max<size_t>(n, 1) * sizeof(T));
+        if (blocks_.empty() || used_ + bytes > blocks_.back().size) grow(bytes);
+        T *p = reinterpret_cast<T *>(blocks_.back().ptr.get() + used_);
+        used_ += bytes;
+        return p;
+    }
+
+    Mark mark() const { return {blocks_.size(), used_}; }
+
+    void release(Mark m) {
+        if (blocks_.size() > max<size_t>(m.blocks, 1)) {
+            if (m.blocks <= 1 && m.used == 0) {
+                // back to empty: fold the blocks into one big enough for next time
+                size_t total = 0;
+                for (auto &b : blocks_) total += b.size;
+                blocks_.clear();
+                blocks_.emplace_back(total);
+                used_ = 0;
+                return;
+            }
+            blocks_.erase(blocks_.begin() + m.blocks, blocks_.end());
+        }
+        used_ = m.used;
+    }
+
+private:
+    struct Deleter {
+        void operator()(char *p) const { ::operator delete(p, align_val_t(AURA_ALIGN)); }
+    };
+    struct Block {
+        unique_ptr<char, Deleter> ptr;
+        size_t size;
+        explicit Block(size_t n)
+            : ptr(static_cast<char *>(::operator new(n, align_val_t(AURA_ALIGN)))), size(n) {}
+    };
+
+    void grow(size_t bytes) {
+        size_t n = max<size_t>(bytes, blocks_.empty() ? 64 << 10 : 2 * blocks_.back().size);
+        blocks_.emplace_back(n);
+        used_ = 0;
+    }
+
+    vector<Block> blocks_;
+    size_t used_ = 0;
+};
+
+inline ScratchArena &thread_scratch() {
+    thread_local ScratchArena arena;
+    return arena;
+}
+
+// Everything allocated from the thread's arena inside the scope is released at its end
+class ScratchScope {
+public:
+    ScratchScope() : arena_(thread_scratch()), mark_(arena_.mark()) {}
+    ~ScratchScope() { arena_.release(mark_); }
+    ScratchScope(const ScratchScope &) = delete;
+    ScratchScope &operator=(const ScratchScope &) = delete;
+
+    template <class T>
+    T *alloc(size_t n) { return arena_.template alloc<T>(n); }
+
+private:
+    ScratchArena &arena_;
+    ScratchArena::Mark mark_;
+};
+
+#endif // AURA_MATRIX_H
@@ -0,0 +1,211 @@
+// Readers and writers for the .mem tensor files shared by the analysis tools.
+//
+// Every .mem line is one 64-bit memory word written as 16 hex characters:
+//   int8 (Q0.7) files : 8 elements per line, element 0 in the least significant byte
+//   FP32 files        : 2 words (8 floats) per line, each float written as its
+//                       memory-order bytes (Generate_QKV.py's tobytes().hex())
+//   INT16 files       : 4 elements per line, LSB-first (fp32_to_f16)
+// Writers go through HexWriter (aura_hex.h): one buffered write() per file.
+// Tensors are returned either flat and row-major with AURA_DK elements per row
+// or as an aligned Matrix; the writers take any MatrixView.
+// A test case is a directory models/NAME/ holding Q32/K32/V32.mem (FP32) or
+// Q/K/V.mem (Q0.7); every corpus tool finds and loads cases the same way.
+
+#ifndef AURA_MEM_H
+#define AURA_MEM_H
+
+#include "aura_matrix.h"
+#include "aura_hex.h"
+
+#include <dirent.h>
+#include <unistd.h>
+
+// ---------------------------
+// Raw file helpers
+// ---------------------------
+inline string read_file(const string &filename) {
+    ifstream fin(filename, ios::binary);
+    if (!fin) throw runtime_error("Cannot open " + filename);
+    string text(istreambuf_iterator<char>(fin), istreambuf_iterator<char>{});
+    stats_count(STAT_BYTES_READ, text.size());
+    return text;
+}
+
+inline int hex_value(char c) {
+    if (c >= '0' && c <= '9') return c - '0';
+    if (c >= 'a' && c <= 'f') return c - 'a' + 10;
+    if (c >= 'A' && c <= 'F') return c - 'A' + 10;
+    return -1;
+}
+
+// Parse every whitespace separated hex token into `digits`-wide values.
+// Tokens longer than `digits` (the FP32 files) are split into chunks.
+inline vector<uint64_t> parse_hex_words(const string &text, int digits, const string &filename) {
+    vector<uint64_t> words;
+    words.reserve(text.size() / (digits + 1) + 1);
+    uint64_t cur = 0;
+    int n = 0;
+    for (char c : text) {
+        int h = hex_value(c);
+        if (h < 0) {
+            if (!isspace((unsigned char)c))
+                throw runtime_error(string("Invalid character '") + c + "' in " + filename);
+            if (n != 0) throw runtime_error("Truncated hex word in " + filename);
+            continue;
+        }
+        cur = (cur << 4) | (uint64_t)h;
+        if (++n == digits) {
+            words.push_back(cur);
+            cur = 0;
+            n = 0;
+        }
+    }
+    if (n != 0) throw runtime_error("Truncated hex word in " + filename);
+    return words;
+}
+
+inline void check_rows(size_t elements, const string &filename) {
+    if (elements == 0 || elements % AURA_DK != 0) {
+        stringstream msg;
+        msg << "Expected a multiple of " << AURA_DK << " values in " << filename
+            << " but found " << elements;
+        throw runtime_error(msg.str());
+    }
+}
+
+// ---------------------------
+// INT8 (Q0.7) .mem
+// ---------------------------
+inline vector<int8_t> read_int8_mem(const string &filename) {
+    StatScope scope("parse");
+    auto words = parse_hex_words(read_file(filename), 16, filename);
+    vector<int8_t> data(words.size() * 8);
+    for (size_t w = 0; w < words.size(); ++w)
+        for (int b = 0; b < 8; ++b)
+            data[w * 8 + b] = (int8_t)((words[w] >> (8 * b)) & 0xFF);  // LSB-first
+    check_rows(data.size(), filename);
+    return data;
+}
+
+inline Matrix<int8_t> read_int8_matrix(const string &filename) {
+    auto data = read_int8_mem(filename);
+    return Matrix<int8_t>::from_flat(data.data(), data.size() / AURA_DK, AURA_DK);
+}
+
+// Packed integer layouts: 8 x int8 or 4 x int16 per 64-bit word, LSB-first
+template <class T>
+void write_packed_mem(const string &filename, MatrixView<const T> m) {
+    constexpr size_t per_word = 8 / sizeof(T);
+    if (m.cols % per_word != 0) throw runtime_error(".mem rows must be whole 64-bit words");
+    HexWriter out(filename, m.rows * (m.cols / per_word) * 17);
+    for (size_t r = 0; r < m.rows; ++r) {
+        const T *row = m.row(r);
+        for (size_t w = 0; w < m.cols; w += per_word) out.word64(pack_word(row + w));
+    }
+    out.close();
+}
+
+inline void write_int8_mem(const string &filename, MatrixView<const int8_t> m) {
+    write_packed_mem(filename, m);
+}
+
+inline void write_int8_mem(const string &filename, const vector<int8_t> &data) {
+    write_int8_mem(filename, MatrixView<const int8_t>(data.data(), data.size() / 8, 8));
+}
+
+// ---------------------------
+// FP32 .mem
+// ---------------------------
+inline vector<float> read_fp32_mem(const string &filename) {
+    StatScope scope("parse");
+    auto words = parse_hex_words(read_file(filename), 8, filename);
+    vector<float> data(words.size());
+    for (size_t i = 0; i < words.size(); ++i) {
+        uint32_t bits = __builtin_bswap32((uint32_t)words[i]);  // memory-order text
+        memcpy(&data[i], &bits, sizeof(float));
+    }
+    check_rows(data.size(), filename);
+    return data;
+}
+
+inline Matrix<float> read_fp32_matrix(const string &filename) {
+    auto data = read_fp32_mem(filename);
+    return Matrix<float>::from_flat(data.data(), data.size() / AURA_DK, AURA_DK);
+}
+
+inline void write_fp32_mem(const string &filename, MatrixView<const float> m) {
+    if (m.cols % 8 != 0) throw runtime_error("FP32 .mem rows must be whole lines of 8 values");
+    HexWriter out(filename, m.rows * m.cols * 8 + m.rows * m.cols / 8);
+    for (size_t r = 0; r < m.rows; ++r) {
+        const float *row = m.row(r);
+        for (size_t i = 0; i < m.cols; ++i) {
+            out.fp32(row[i]);
+            if (i % 8 == 7) out.newline();
+        }
+    }
+    out.close();
+}
+
+inline void write_fp32_mem(const string &filename, const vector<float> &data) {
+    write_fp32_mem(filename, MatrixView<const float>(data.data(), data.size() / 8, 8));
+}
+
+// ---------------------------
+// INT16 .mem (4 elements per line, LSB-first)
+// ---------------------------
+inline void write_int16_mem(const string &filename, MatrixView<const int16_t> m) {
+    write_packed_mem(filename, m);
+}
+
+inline void write_int16_mem(const string &filename, const vector<int16_t> &data) {
+    write_int16_mem(filename, MatrixView<const int16_t>(data.data(), data.size() / 4, 4));
+}
+
+// ---------------------------
+// Test cases
+// ---------------------------
+inline bool readable(const string &f) { return access(f.c_str(), R_OK) == 0; }
+
+// every subdirectory of `root` with Q/K/V inputs, sorted by name
+inline vector<string> discover_tests(const string &root) {
+    vector<string> names;
+    DIR *dir = opendir(root.c_str());
+    if (!dir) throw runtime_error("Cannot open " + root);
+    while (dirent *e = readdir(dir)) {
+        string name = e->d_name;
+        if (name[0] == '.') continue;
+        string base = root + "/" + name + "/";
+        if (readable(base + "Q32.mem") || readable(base + "Q.mem")) names.push_back(name);
+    }
+    closedir(dir);
+    sort(names.begin(), names.end());
+    return names;
+}
+
+struct CaseInputs {
+    vector<float> Q32, K32, V32;  // FP32 inputs, empty when the case only has Q/K/V.mem
+    vector<int8_t> Q, K, V;       // Q0.7 model inputs
+    bool has_fp32() const { return !Q32.empty(); }
+};
+
+// Inputs of case `name`: Q32/K32/V32.mem quantized to Q0.7 when present, else Q/K/V.mem
+inline CaseInputs read_case(const string &models, const string &name) {
+    CaseInputs c;
+    const string dir = models + "/" + name + "/";
+    if (readable(dir + "Q32.mem")) {
+        c.Q32 = read_fp32_mem(dir + "Q32.mem");
+        c.K32 = read_fp32_mem(dir + "K32.mem");
+        c.V32 = read_fp32_mem(dir + "V32.mem");
+        c.Q = quantize_q07(c.Q32);
+        c.K = quantize_q07(c.K32);
+        c.V = quantize_q07(c.V32);
+    } else {
+        c.Q = read_int8_mem(dir + "Q.mem");
+        c.K = read_int8_mem(dir + "K.mem");
+        c.V = read_int8_mem(dir + "V.mem");
+    }
+    if (c.K.size() != c.V.size()) throw runtime_error(name + ": K and V have different sizes");
+    return c;
+}
+
+#endif // AURA_MEM_H
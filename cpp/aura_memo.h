@@ -0,0 +1,172 @@
+// Stage-level memoization of the fixed-point model for parameter sweeps.
+//
+// model_attention runs score -> running max -> expmul -> normalize for every
+// query row. In a design-space sweep most points only move a downstream
+// parameter (EXPMUL_EXP_I, the guard bits, DIV_INPUT_QT, OUTPUT_VEC_QT, the
+// reciprocal), so the Q.K^T scores, and often the o* accumulators, are the
+// same as at the previous point. ModelMemo keeps each stage's output in memory
+// keyed by
+//   score  : hash of Q and K + the dot_product formats and rounding
+//   max    : the score key (no parameters of its own)
+//   expmul : the max key + hash of V + the expmul_stage formats and guard bits
+// and model_attention_memo reruns only the stages after the first one whose
+// key changed; normalize always runs. Keys use the derived Q-formats, not the
+// starting parameters, so a format overridden after derive() (aura_sweep's
+// --div-input-f, aura_profile's narrowing) is keyed correctly.
+//
+// Probes and operation counts are per evaluation, so a config with profile or
+// ops set bypasses the memo and runs model_attention in full.
+
+#ifndef AURA_MEMO_H
+#define AURA_MEMO_H
+
+#include "aura_model.h"
+#include "aura_cache.h"
+
+enum ModelStage { STAGE_SCORE, STAGE_MAX, STAGE_EXPMUL, NUM_MODEL_STAGES };
+
+inline const char *model_stage_name(int s) {
+    static const char *names[NUM_MODEL_STAGES] = {"score", "max", "expmul"};
+    return names[s];
+}
+
+class ModelMemo {
+public:
+    // budget: bytes of intermediates kept; the oldest entries go first
+    explicit ModelMemo(size_t budget = size_t(1) << 30) : budget_(budget) {}
+
+    int hits(ModelStage s) const { return hits_[s]; }
+    int misses(ModelStage s) const { return misses_[s]; }
+    size_t bytes() const { return bytes_; }
+
+    using Tensor = shared_ptr<const vector<int64_t>>;
+
+    // the cached stage output, or compute() (which fills a vector) stored under key
+    template <class F>
+    Tensor get(ModelStage stage, const CacheKey &key, F compute) {
+        string id = key.hex();
+        auto it = entries_.find(id);
+        if (it != entries_.end()) {
+            hits_[stage]++;
+            return it->second;
+        }
+        misses_[stage]++;
+        auto t = make_shared<vector<int64_t>>();
+        {
+            StatScope scope(model_stage_name(stage));
+            compute(*t);
+        }
+        Tensor out = t;
+        size_t n = t->size() * sizeof(int64_t);
+        if (n > budget_) return out;
+        while (bytes_ + n > budget_ && !order_.empty()) {
+            auto old = entries_.find(order_.front());
+            bytes_ -= old->second->size() * sizeof(int64_t);
+            entries_.erase(old);
+            order_.pop_front();
+        }
+        entries_.emplace(id, out);
+        order_.push_back(id);
+        bytes_ += n;
+        return out;
+    }
+
+    void clear() {
+        entries_.clear();
+        order_.clear();
+        bytes_ = 0;
+    }
+
+private:
+    size_t budget_, bytes_ = 0;
+    unordered_map<string, Tensor> entries_;
+    deque<string> order_;   // insertion order, for eviction
+    int hits_[NUM_MODEL_STAGES] = {}, misses_[NUM_MODEL_STAGES] = {};
+};
+
+// ---------------------------
+// Stage keys
+// ---------------------------
+inline void memo_add_view(CacheKey &key, MatrixView<const int8_t> t) {
+    key.add((int64_t)t.rows).add((int64_t)t.cols);
+    if (t.contiguous()) {
+        key.add((int64_t)hash_bytes(t.data, t.size()));
+        return;
+    }
+    uint64_t h = 0;
+    for (size_t i = 0; i < t.rows; ++i) h = hash_bytes(t.row(i), t.cols, h);
+    key.add((int64_t)h);
+}
+
+inline void memo_add_format(CacheKey &key, QFormat f) { key.add(f.i).add(f.f); }
+
+inline CacheKey memo_score_key(MatrixView<const int8_t> Q, MatrixView<const int8_t> K, const ModelConfig &cfg) {
+    CacheKey key("memo_score");
+    memo_add_view(key, Q);
+    memo_add_view(key, K);
+    key.add(cfg.embedding_dim).add(cfg.rounding).add(cfg.dot_shift);
+    for (QFormat f : {cfg.input_vec, cfg.intermediate_product, cfg.product, cfg.dot, cfg.expmul_diff_in})
+        memo_add_format(key, f);
+    return key;
+}
+
+inline CacheKey memo_max_key(const CacheKey &score) {
+    CacheKey key("memo_max");
+    key.add(score.hex());
+    return key;
+}
+
+inline CacheKey memo_expmul_key(const CacheKey &max, MatrixView<const int8_t> V, const ModelConfig &cfg) {
+    CacheKey key("memo_expmul");
+    key.add(max.hex());
+    memo_add_view(key, V);
+    key.add(cfg.log2e_guard_bits);
+    for (QFormat f : {cfg.expmul_diff_out, cfg.log2e_out, cfg.expmul_exp, cfg.expmul_shift_stage, cfg.expmul_vec})
+        memo_add_format(key, f);
+    return key;
+}
+
+// ---------------------------
+// Memoized attention
+// ---------------------------
+// Same outputs as model_attention(Q, K, V, O, cfg, threads).
+inline void model_attention_memo(MatrixView<const int8_t> Q, MatrixView<const int8_t> K,
+                                 MatrixView<const int8_t> V, MatrixView<int8_t> O, const ModelConfig &cfg,
+                                 ModelMemo &memo, int threads = 1) {
+    if (cfg.profile || cfg.ops) {
+        model_attention(Q, K, V, O, cfg, threads);
+        return;
+    }
+    const size_t D = cfg.embedding_dim, rows_q = Q.rows, rows_kv = K.rows;
+    if (Q.cols != D || K.cols != D || V.cols != D || K.rows != V.rows)
+        throw runtime_error("Q/K/V shapes do not match the model's embedding dimension");
+    if (O.rows != Q.rows || O.cols != D) throw runtime_error("Output shape does not match Q");
+    stats_count(STAT_ROWS, rows_q);
+
+    CacheKey score_key = memo_score_key(Q, K, cfg);
+    auto S = memo.get(STAGE_SCORE, score_key, [&](vector<int64_t> &s) {
+        s.resize(rows_q * rows_kv);
+        parallel_rows((int)rows_q, threads, [&](int i) { model_score_row(Q.row(i), K, &s[i * rows_kv], cfg); });
+    });
+    CacheKey max_key = memo_max_key(score_key);
+    auto M = memo.get(STAGE_MAX, max_key, [&](vector<int64_t> &m) {
+        m.resize(rows_q * rows_kv);
+        for (size_t i = 0; i < rows_q; ++i) model_running_max(&(*S)[i * rows_kv], (int)rows_kv, &m[i * rows_kv]);
+    });
+    auto E = memo.get(STAGE_EXPMUL, memo_expmul_key(max_key, V, cfg), [&](vector<int64_t> &o) {
+        o.resize(rows_q * (D + 1));
+        vector<ModelLane> lanes(rows_q);
+        for (size_t i = 0; i < rows_q; ++i) {
+            lanes[i].V = V;
+            lanes[i].s = &(*S)[i * rows_kv];
+            lanes[i].m = &(*M)[i * rows_kv];
+            lanes[i].o_star = &o[i * (D + 1)];
+        }
+        model_attention_lanes(lanes, cfg, threads);
+    });
+
+    StatScope scope("normalize");
+    parallel_rows((int)rows_q, threads, [&](int i) { model_normalize(&(*E)[i * (D + 1)], O.row(i), cfg); });
+}
+
+#endif // AURA_MEMO_H
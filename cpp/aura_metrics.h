@@ -0,0 +1,90 @@
+// Q0.7 output comparison metrics (the ones reported by precision_measure.cpp).
+
+#ifndef AURA_METRICS_H
+#define AURA_METRICS_H
+
+#include "aura_matrix.h"
+
+// Acceptable thresholds for 8-bit fixed-point attention ASIC
+static constexpr double THRESHOLD_MAE = 3.0;
+static constexpr double THRESHOLD_RMSE = 5.0;
+static constexpr int THRESHOLD_MAX_ERROR = 15;
+static constexpr double THRESHOLD_REL_ERROR = 0.1; // 10%
+static constexpr double THRESHOLD_TOP1_MATCH = 0.95; // 95%
+
+struct Metrics {
+    int total_elements = 0;
+    int rows = 0;
+    double mae = 0.0;
+    double rmse = 0.0;
+    int max_abs_error = 0;
+    double mean_rel_error = 0.0;
+    int top1_match = 0;
+
+    double top1_ratio() const { return rows ? top1_match / double(rows) : 0.0; }
+
+    bool mae_ok() const { return mae <= THRESHOLD_MAE; }
+    bool rmse_ok() const { return rmse <= THRESHOLD_RMSE; }
+    bool max_ok() const { return max_abs_error <= THRESHOLD_MAX_ERROR; }
+    bool rel_ok() const { return mean_rel_error <= THRESHOLD_REL_ERROR; }
+    bool top1_ok() const { return top1_ratio() >= THRESHOLD_TOP1_MATCH; }
+    bool passed() const { return mae_ok() && rmse_ok() && max_ok() && rel_ok() && top1_ok(); }
+};
+
+// Works for any integer element type (Q0.7 int8, the 16-bit outputs, ...)
+template <class T>
+Metrics compare_outputs(MatrixView<const T> ref, MatrixView<const T> asic) {
+    if (ref.rows != asic.rows || ref.cols != asic.cols || ref.size() == 0)
+        throw runtime_error("Matrix dimensions do not match");
+    StatScope scope("compare");
+
+    Metrics m;
+    m.total_elements = (int)ref.size();
+    m.rows = (int)ref.rows;
+
+    double sum_rel = 0.0;
+    int count_rel = 0;
+    for (size_t r = 0; r < ref.rows; ++r) {
+        const T *fr = ref.row(r), *ar = asic.row(r);
+        for (size_t c = 0; c < ref.cols; ++c) {
+            int a = ar[c];
+            int f = fr[c];
+            int err = abs(a - f);
+            m.mae += err;
+            m.rmse += (double)err * err;
+            m.max_abs_error = max(m.max_abs_error, err);
+            if (f != 0) {
+                // signed denominator, as in precision_measure
+                sum_rel += err / (double)f;
+                count_rel++;
+            }
+        }
+        if (max_element(fr, fr + ref.cols) - fr == max_element(ar, ar + ref.cols) - ar)
+            m.top1_match++;
+    }
+    m.mae /= m.total_elements;
+    m.rmse = sqrt(m.rmse / m.total_elements);
+    m.mean_rel_error = (count_rel > 0) ? (sum_rel / count_rel) : 0.0;
+    return m;
+}
+
+inline Metrics compare_outputs(const vector<int8_t> &ref, const vector<int8_t> &asic,
+                               int cols = AURA_DK) {
+    if (ref.size() != asic.size() || ref.empty() || ref.size() % cols != 0)
+        throw runtime_error("Matrix dimensions do not match");
+    return compare_outputs(MatrixView<const int8_t>(ref, cols), MatrixView<const int8_t>(asic, cols));
+}
+
+inline void print_metrics(ostream &out, const Metrics &m) {
+    auto verdict = [](bool ok) { return ok ? "PASS" : "FAIL"; };
+    out << "===== Comparison Metrics =====\n";
+    out << "Total elements: " << m.total_elements << "\n";
+    out << "MAE           : " << m.mae << "  --> " << verdict(m.mae_ok()) << "\n";
+    out << "RMSE          : " << m.rmse << "  --> " << verdict(m.rmse_ok()) << "\n";
+    out << "Max abs error : " << m.max_abs_error << "  --> " << verdict(m.max_ok()) << "\n";
+    out << "Mean rel error: " << m.mean_rel_error << "  --> " << verdict(m.rel_ok()) << "\n";
+    out << "Top-1 row match: " << m.top1_match << " / " << m.rows
+        << " (" << (100.0 * m.top1_ratio()) << "%)  --> " << verdict(m.top1_ok()) << "\n";
+}
+
+#endif // AURA_METRICS_H
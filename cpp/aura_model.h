@@ -0,0 +1,682 @@
+// Bit-accurate C++ model of the AURA PE datapath.
+//
+// Mirrors verilog/PE.sv stage by stage with the Q-formats of include/sys_defs.svh:
+//   dot_product  : q*k (INTERMEDIATE_PRODUCT_QT) -> PRODUCT_QT, tree sum (DOT_QT),
+//                  >>> log2(sqrt(dk)), -> EXPMUL_DIFF_IN_QT score
+//   max          : running max that restarts from 0 for every query
+//   expmul       : Log2Exp approximation + barrel shift of o* and v* (EXPMUL_VEC_QT)
+//   vector_division : o*[1..d] / o*[0] through DIV_INPUT_QT and the divu iteration
+// Every q_convert follows q_align_frac/q_align_int (round-half-up when ROUNDING,
+// saturation when narrowing) and plain additions wrap like the RTL vectors.
+
+#ifndef AURA_MODEL_H
+#define AURA_MODEL_H
+
+#include "aura_matrix.h"
+
+// ---------------------------
+// Q-format helpers
+// ---------------------------
+struct QFormat {
+    int i = 0;  // integer bits
+    int f = 0;  // fraction bits
+    int width() const { return i + f + 1; }  // +1 for sign bit
+};
+
+// sign-extend the low w bits of v (two's complement wrap)
+inline int64_t q_wrap(int64_t v, int w) {
+    uint64_t m = (w >= 64) ? ~0ULL : ((1ULL << w) - 1);
+    uint64_t u = (uint64_t)v & m;
+    if (w < 64 && (u >> (w - 1)) & 1) u |= ~m;
+    return (int64_t)u;
+}
+
+inline int64_t q_saturate(int64_t v, int w) {
+    int64_t hi = (1LL << (w - 1)) - 1;
+    int64_t lo = -(1LL << (w - 1));
+    return v > hi ? hi : (v < lo ? lo : v);
+}
+
+// q_convert.sv: q_align_frac then q_align_int
+inline int64_t q_convert(int64_t in, QFormat from, QFormat to, int rounding) {
+    int64_t v;
+    if (to.f >= from.f) {
+        v = in * (1LL << (to.f - from.f));
+    } else {
+        int sh = from.f - to.f;
+        if (rounding) v = q_saturate((in + (1LL << (sh - 1))) >> sh, from.i + to.f + 1);
+        else v = in >> sh;
+    }
+    if (from.i > to.i) v = q_saturate(v, to.width());
+    return v;
+}
+
+// the same fraction bits without an integer limit: the value before saturation
+inline QFormat q_unbounded(QFormat f) { return {62 - f.f, f.f}; }
+
+// ---------------------------
+// Value-range probes
+// ---------------------------
+// Every intermediate is recorded on its own Q-format grid before the
+// saturation or wrap into that format (aura_profile analyses the ranges).
+enum ProbePoint {
+    PROBE_INTERMEDIATE_PRODUCT, PROBE_DOT, PROBE_EXPMUL_DIFF_IN, PROBE_EXPMUL_EXP,
+    PROBE_EXPMUL_SHIFT_STAGE, PROBE_EXPMUL_VEC, PROBE_DIV_INPUT, NUM_PROBES
+};
+
+struct RangeStats {
+    uint64_t count = 0, zeros = 0;
+    int64_t min = numeric_limits<int64_t>::max(), max = numeric_limits<int64_t>::min();
+    uint64_t mag_bits[64] = {};  // bits needed besides the sign
+    uint64_t low_zeros[64] = {}; // trailing zero bits of the non-zero values
+
+    void add(int64_t v) {
+        ++count;
+        min = v < min ? v : min;
+        max = v > max ? v : max;
+        uint64_t mag = (uint64_t)(v < 0 ? ~v : v);
+        mag_bits[mag ? 64 - __builtin_clzll(mag) : 0]++;
+        if (v) low_zeros[__builtin_ctzll((uint64_t)v)]++;
+        else ++zeros;
+    }
+
+    void merge(const RangeStats &o) {
+        count += o.count;
+        zeros += o.zeros;
+        min = o.min < min ? o.min : min;
+        max = o.max > max ? o.max : max;
+        for (int b = 0; b < 64; ++b) mag_bits[b] += o.mag_bits[b], low_zeros[b] += o.low_zeros[b];
+    }
+};
+
+struct RangeProfile {
+    RangeStats at[NUM_PROBES];
+
+    void record(ProbePoint p, int64_t v) { at[p].add(v); }
+    void merge(const RangeProfile &o) {
+        for (int p = 0; p < NUM_PROBES; ++p) at[p].merge(o.at[p]);
+    }
+};
+
+// ---------------------------
+// Operation counts
+// ---------------------------
+// Primitive datapath events summed over the PE passes (aura_energy.h weighs
+// them). Counted once per K/V row and once per output row, not per element.
+enum ModelOp {
+    OP_MUL8,       // int8 x int8 in dot_product
+    OP_TREE_ADD,   // tree_reduce / reduction_step additions
+    OP_MAX_CMP,    // running max
+    OP_LOG2E_ADD,  // a - b and x + (x >>> 1) - (x >>> 4) in expmul_stage
+    OP_EXP_SHIFT,  // barrel-shifter stages that shift (set bits of l_hat)
+    OP_VEC_ADD,    // o* = o* * 2^l_o + v* * 2^l_v
+    OP_DIV_ITER,   // int_division iterations
+    OP_RECIP_LUT,  // reciprocal seed lookups
+    OP_RECIP_MUL,  // Newton-Raphson and o* x 1/o*[0] multiplies
+    NUM_MODEL_OPS
+};
+
+inline const char *model_op_name(int op) {
+    static const char *names[NUM_MODEL_OPS] = {"mul8", "tree_add", "max_cmp", "log2e_add", "exp_shift",
+                                               "vec_add", "div_iter", "recip_lut", "recip_mul"};
+    return names[op];
+}
+
+struct OpCounts {
+    uint64_t n[NUM_MODEL_OPS] = {};
+
+    void merge(const OpCounts &o) {
+        for (int i = 0; i < NUM_MODEL_OPS; ++i) n[i] += o.n[i];
+    }
+};
+
+// ---------------------------
+// Configuration (sys_defs.svh)
+// ---------------------------
+struct ModelConfig {
+    // starting parameters
+    int integer_width = 8;       // `INTEGER_WIDTH
+    int embedding_dim = 64;      // `MAX_EMBEDDING_DIM
+    int max_seq_length = 512;    // `MAX_SEQ_LENGTH (sizes the accumulators)
+    int rounding = 1;            // `ROUNDING
+    int expmul_exp_i = 4;        // `EXPMUL_EXP_I (clipped exponent range)
+
+    // Extra fraction bits for x + (x >>> 1) - (x >>> 4) in expmul_stage.sv.
+    // 0 is the current RTL (shifts truncate at Q6.4); 4 is the x_diff_expanded
+    // (Q5.8) variant that produced models/bert-base-uncased/O_cleaned.mem.
+    int log2e_guard_bits = 0;
+
+    // Normalisation. 0 is vector_division.sv: one int_division per output
+    // element. P > 0 computes one reciprocal of o*[0] per row with P fraction
+    // bits (LUT seed of recip_seed_bits, then recip_iterations Newton-Raphson
+    // steps) and scales the o*[1..d] with one multiply each.
+    int recip_bits = 0;
+    int recip_seed_bits = 6;
+    int recip_iterations = 1;
+
+    // derived Q-formats, filled by derive()
+    QFormat input_vec, output_vec;
+    QFormat div_input;
+    QFormat expmul_vec, expmul_shift_stage, expmul_exp;
+    QFormat log2e_out;           // log_e_x in expmul_stage.sv
+    QFormat expmul_diff_out, expmul_diff_in;
+    QFormat dot, product, intermediate_product;
+    int dot_shift = 3;           // sum >>> 3 == / sqrt(dk)
+
+    // when set, every intermediate is recorded here (one profile per thread)
+    RangeProfile *profile = nullptr;
+    // when set, datapath operations are counted here (one per thread)
+    OpCounts *ops = nullptr;
+
+    ModelConfig() { derive(); }
+
+    void derive() {
+        const int R = rounding;
+        const int seq_bits = clog2(max_seq_length);
+        input_vec = {0, integer_width - 1};
+        output_vec = {0, integer_width - 1};
+
+        int div_input_f = output_vec.f + R;
+        int expmul_vec_f = seq_bits + input_vec.f + R;
+        int expmul_shift_stage_f = expmul_vec_f + 6;
+        int exp_log2e_out_f = R + 1;
+        int expmul_diff_out_f = exp_log2e_out_f + 1 + R;
+        int score_f = expmul_diff_out_f + R;
+        int dot_f = score_f + clog2(embedding_dim) + R;
+
+        int intermediate_product_i = 2 * input_vec.i + 1;
+        int dot_i = intermediate_product_i + clog2(embedding_dim);
+        int expmul_diff_in_i = dot_i - 3;
+        int expmul_diff_out_i = expmul_diff_in_i + 1;
+        int exp_log2e_out_i = expmul_diff_out_i + 1;
+        int expmul_shift_stage_i = seq_bits + input_vec.i;
+
+        intermediate_product = {intermediate_product_i, 2 * input_vec.f};
+        product = {intermediate_product_i, dot_f};
+        dot = {dot_i, dot_f};
+        expmul_diff_in = {expmul_diff_in_i, expmul_diff_out_f};
+        expmul_diff_out = {expmul_diff_out_i, expmul_diff_out_f};
+        log2e_out = {exp_log2e_out_i, expmul_diff_out_f};
+        expmul_exp = {expmul_exp_i, 0};
+        expmul_shift_stage = {expmul_shift_stage_i, expmul_shift_stage_f};
+        expmul_vec = {expmul_shift_stage_i, expmul_vec_f};
+        div_input = {seq_bits + input_vec.i, div_input_f};
+        dot_shift = clog2(embedding_dim) / 2;
+
+        if (recip_bits < 0 || recip_bits > 30) throw runtime_error("recip_bits must be in [0, 30]");
+        if (recip_seed_bits < 0 || recip_iterations < 0)
+            throw runtime_error("Reciprocal seed bits and iterations must be non-negative");
+    }
+
+    // every starting parameter, for cache keys and reports
+    string signature() const {
+        stringstream ss;
+        ss << "I" << integer_width << "_D" << embedding_dim << "_S" << max_seq_length
+           << "_R" << rounding << "_E" << expmul_exp_i << "_G" << log2e_guard_bits;
+        if (recip_bits) ss << "_RCP" << recip_bits << "." << recip_seed_bits << "." << recip_iterations;
+        return ss.str();
+    }
+};
+
+// ---------------------------
+// Datapath stages
+// ---------------------------
+
+// dot_product.sv: returns the EXPMUL_DIFF_IN_QT score
+inline int64_t model_score(const int8_t *q, const int8_t *k, const ModelConfig &cfg) {
+    int64_t sum = 0;
+    for (int d = 0; d < cfg.embedding_dim; ++d)
+        sum += q_convert((int64_t)q[d] * k[d], cfg.intermediate_product, cfg.product, cfg.rounding);
+    if (cfg.profile) {  // outside the loop, which stays vectorized
+        for (int d = 0; d < cfg.embedding_dim; ++d)
+            cfg.profile->record(PROBE_INTERMEDIATE_PRODUCT, (int64_t)q[d] * k[d]);
+        cfg.profile->record(PROBE_DOT, sum);
+        cfg.profile->record(PROBE_EXPMUL_DIFF_IN, q_convert(sum >> cfg.dot_shift, cfg.dot,
+                                                            q_unbounded(cfg.expmul_diff_in), cfg.rounding));
+    }
+    return q_convert(sum >> cfg.dot_shift, cfg.dot, cfg.expmul_diff_in, cfg.rounding);
+}
+
+// log_e_x in expmul_stage.sv, widened by the guard bits
+inline QFormat model_log2e_format(const ModelConfig &cfg) {
+    return {cfg.log2e_out.i, cfg.log2e_out.f + cfg.log2e_guard_bits};
+}
+
+// expmul_stage.sv stage 1a: x + (x >>> 1) - (x >>> 4) ~ (a - b) * log2(e)
+inline int64_t model_log2e(int64_t a, int64_t b, const ModelConfig &cfg) {
+    const int g = cfg.log2e_guard_bits;
+    int64_t x = q_wrap(a - b, cfg.expmul_diff_out.width()) * (1LL << g);
+    return q_wrap(x + (x >> 1) - (x >> 4), model_log2e_format(cfg).width());
+}
+
+// expmul_stage.sv stage 1: clipped exponent l_hat ~ round((a - b) * log2(e))
+inline int64_t model_log2exp(int64_t a, int64_t b, const ModelConfig &cfg) {
+    int64_t lx = model_log2e(a, b, cfg);
+    if (cfg.profile)
+        cfg.profile->record(PROBE_EXPMUL_EXP, q_convert(lx, model_log2e_format(cfg),
+                                                        q_unbounded(cfg.expmul_exp), cfg.rounding));
+    return q_convert(lx, model_log2e_format(cfg), cfg.expmul_exp, cfg.rounding);
+}
+
+// expmul_stage.sv stage 2: v * 2^l_hat through the barrel shifter
+inline int64_t model_exp_shift(int64_t v, int64_t l_hat, const ModelConfig &cfg) {
+    const int w = cfg.expmul_shift_stage.width();
+    const int lw = cfg.expmul_exp.width();
+    int64_t r = q_convert(v, cfg.expmul_vec, cfg.expmul_shift_stage, cfg.rounding);
+    if ((l_hat >> (lw - 1)) & 1) r >>= (1 << (lw - 1));
+    if (cfg.profile) {  // the shifted value before any wrap (shifts compose)
+        int up = 0;
+        for (int b = lw - 2; b >= 0; --b)
+            if ((l_hat >> b) & 1) up += 1 << b;
+        int64_t ideal = up + w < 63 ? r * (1LL << up)
+                                    : (r < 0 ? numeric_limits<int64_t>::min() : numeric_limits<int64_t>::max());
+        cfg.profile->record(PROBE_EXPMUL_SHIFT_STAGE, ideal);
+    }
+    for (int b = lw - 2; b >= 0; --b)
+        if ((l_hat >> b) & 1) r = q_wrap(r * (1LL << (1 << b)), w);
+    return q_convert(r, cfg.expmul_shift_stage, cfg.expmul_vec, cfg.rounding);
+}
+
+// divu: WIDTH+FBITS restoring iterations on {acc, quo}
+inline uint64_t model_divu(uint64_t a, uint64_t b, int W, int F) {
+    const uint64_t mask = (1ULL << W) - 1;
+    // while the quotient fits, the bits shifted back into acc are all zero
+    if (b && ((a << F) / b) <= mask) return (a << F) / b;
+
+    // overflow (or b == 0): quotient bits re-enter acc, iterate like the RTL
+    uint64_t acc = a >> (W - 1), quo = (a << 1) & mask;
+    for (int i = 0; i < W + F; ++i) {
+        uint64_t bit = quo >> (W - 1);
+        if (acc >= b) {
+            acc = (((acc - b) & mask) << 1) | bit;
+            quo = ((quo << 1) | 1) & mask;
+        } else {
+            acc = ((acc << 1) | bit) & ((mask << 1) | 1);
+            quo = (quo << 1) & mask;
+        }
+    }
+    return quo;
+}
+
+// int_division.sv (sign/magnitude around divu) followed by the output q_convert
+inline int8_t model_divide(int64_t num_vec, int64_t den_vec, const ModelConfig &cfg) {
+    const int W = cfg.div_input.width() - 1;
+    const uint64_t mask = (1ULL << W) - 1;
+    int64_t num = q_convert(num_vec, cfg.expmul_vec, cfg.div_input, cfg.rounding);
+    int64_t den = q_convert(den_vec, cfg.expmul_vec, cfg.div_input, cfg.rounding);
+    if (cfg.profile) {
+        for (int64_t x : {num_vec, den_vec})
+            cfg.profile->record(PROBE_DIV_INPUT, q_convert(x, cfg.expmul_vec, q_unbounded(cfg.div_input),
+                                                           cfg.rounding));
+    }
+
+    bool sign_q = (num < 0) != (den < 0);
+    uint64_t a = (uint64_t)(num < 0 ? -num : num) & mask;
+    uint64_t b = (uint64_t)(den < 0 ? -den : den) & mask;
+
+    uint64_t quo = model_divu(a, b, W, cfg.div_input.f);
+
+    // {sign_q, ~quo + 1} is sized by the 32-bit literal, so the sign bit falls
+    // off the 18-bit signed_q and the result is a plain negation
+    int64_t signed_q = sign_q ? -(int64_t)quo : (int64_t)quo;
+    return (int8_t)q_convert(signed_q, cfg.div_input, cfg.output_vec, cfg.rounding);
+}
+
+// ---------------------------
+// Reciprocal-multiply normalisation (cfg.recip_bits > 0)
+// ---------------------------
+// |den| in DIV_INPUT_QT is normalised to X in [2^(P-1), 2^P), i.e. x = X / 2^P
+// in [0.5, 1), so |den| = X * 2^(n-P) with n its bit length. y ~ 2^P / x has
+// P fraction bits and lies in (2^P, 2^(P+1)].
+struct ModelReciprocal {
+    uint64_t y = 0;
+    int n = 0;          // bit length of |den|; 0 when den is zero
+    bool neg = false;
+};
+
+inline ModelReciprocal model_reciprocal(int64_t den_vec, const ModelConfig &cfg) {
+    const int W = cfg.div_input.width() - 1, P = cfg.recip_bits;
+    int64_t den = q_convert(den_vec, cfg.expmul_vec, cfg.div_input, cfg.rounding);
+    if (cfg.profile)
+        cfg.profile->record(PROBE_DIV_INPUT, q_convert(den_vec, cfg.expmul_vec, q_unbounded(cfg.div_input),
+                                                       cfg.rounding));
+    ModelReciprocal r;
+    r.neg = den < 0;
+    uint64_t b = (uint64_t)(den < 0 ? -den : den) & ((1ULL << W) - 1);
+    if (!b) return r;
+    r.n = 64 - __builtin_clzll(b);
+    uint64_t X = r.n <= P ? b << (P - r.n) : b >> (r.n - P);
+
+    // seed: 2^P over the midpoint of the LUT interval holding x
+    const int s = min(cfg.recip_seed_bits, P - 1);
+    uint64_t idx = (X >> (P - 1 - s)) & ((1ULL << s) - 1);
+    uint64_t mid = (1ULL << (s + 1)) + 2 * idx + 1;  // midpoint * 2^(s+2)
+    uint64_t y = ((1ULL << (P + s + 2)) + mid / 2) / mid;
+
+    // Newton-Raphson: y <- y * (2 - x * y), each step two multiplies
+    for (int it = 0; it < cfg.recip_iterations; ++it) {
+        uint64_t xy = (X * y) >> P;
+        uint64_t two = 2ULL << P;
+        y = xy >= two ? 0 : min((y * (two - xy)) >> P, two);
+    }
+    r.y = y;
+    return r;
+}
+
+// num * (1 / den) in DIV_INPUT_QT, truncated like divu, then the output q_convert
+inline int8_t model_scale(int64_t num_vec, const ModelReciprocal &r, const ModelConfig &cfg) {
+    const int W = cfg.div_input.width() - 1, F = cfg.div_input.f, P = cfg.recip_bits;
+    const uint64_t mask = (1ULL << W) - 1;
+    int64_t num = q_convert(num_vec, cfg.expmul_vec, cfg.div_input, cfg.rounding);
+    if (cfg.profile)
+        cfg.profile->record(PROBE_DIV_INPUT, q_convert(num_vec, cfg.expmul_vec, q_unbounded(cfg.div_input),
+                                                       cfg.rounding));
+
+    uint64_t a = (uint64_t)(num < 0 ? -num : num) & mask;
+    uint64_t quo = mask;  // divu by zero returns all ones
+    if (r.n) {
+        // a / |den| = a * y / 2^(P + n); the quotient keeps F fraction bits
+        int sh = P + r.n - F;
+        unsigned __int128 p = (unsigned __int128)a * r.y;
+        p = sh >= 0 ? p >> sh : p << -sh;
+        quo = p > mask ? mask : (uint64_t)p;  // saturates where divu would overflow
+    }
+    bool sign_q = (num < 0) != r.neg;
+    int64_t signed_q = sign_q ? -(int64_t)quo : (int64_t)quo;
+    return (int8_t)q_convert(signed_q, cfg.div_input, cfg.output_vec, cfg.rounding);
+}
+
+// o_out[d] = o_star[d + 1] / o_star[0] through the configured normalisation
+inline void model_normalize(const int64_t *o_star, int8_t *o_out, const ModelConfig &cfg) {
+    const int D = cfg.embedding_dim;
+    if (!cfg.recip_bits) {
+        if (cfg.ops) cfg.ops->n[OP_DIV_ITER] += (uint64_t)D * (cfg.div_input.width() - 1 + cfg.div_input.f);
+        for (int d = 0; d < D; ++d) o_out[d] = model_divide(o_star[d + 1], o_star[0], cfg);
+        return;
+    }
+    if (cfg.ops) {
+        cfg.ops->n[OP_RECIP_LUT]++;
+        cfg.ops->n[OP_RECIP_MUL] += 2 * cfg.recip_iterations + D;
+    }
+    ModelReciprocal r = model_reciprocal(o_star[0], cfg);
+    for (int d = 0; d < D; ++d) o_out[d] = model_scale(o_star[d + 1], r, cfg);
+}
+
+// ---------------------------
+// Full attention: one PE pass per query row
+// ---------------------------
+// expmul_stage.sv for K/V row j: o* = o* * 2^l_o + v* * 2^l_v, with m the max
+// before row j and m_new = max(m, s) (first: o* starts empty). v_star is
+// D + 1 words of scratch.
+inline void model_expmul_step(int64_t *o_star, int64_t *v_star, const int8_t *v, int64_t s, int64_t m,
+                              int64_t m_new, bool first, const ModelConfig &cfg) {
+    const int D = cfg.embedding_dim;
+    const int vec_w = cfg.expmul_vec.width();
+    v_star[0] = 1LL << cfg.expmul_vec.f;
+    for (int d = 0; d < D; ++d)
+        v_star[d + 1] = q_convert(v[d], cfg.input_vec, cfg.expmul_vec, cfg.rounding);
+
+    int64_t l_o = model_log2exp(m, m_new, cfg);
+    int64_t l_v = model_log2exp(s, m_new, cfg);
+    for (int d = 0; d <= D; ++d) {
+        int64_t o = first ? 0 : model_exp_shift(o_star[d], l_o, cfg);
+        o += model_exp_shift(v_star[d], l_v, cfg);
+        if (cfg.profile) cfg.profile->record(PROBE_EXPMUL_VEC, o);
+        o_star[d] = q_wrap(o, vec_w);
+    }
+    if (cfg.ops) {
+        uint64_t *n = cfg.ops->n, lmask = (1ULL << cfg.expmul_exp.width()) - 1;
+        n[OP_MUL8] += D;
+        n[OP_TREE_ADD] += D - 1;
+        n[OP_MAX_CMP]++;
+        n[OP_LOG2E_ADD] += 2 * 3;
+        n[OP_EXP_SHIFT] += (uint64_t)(D + 1) * (__builtin_popcountll((uint64_t)l_v & lmask) +
+                                                (first ? 0 : __builtin_popcountll((uint64_t)l_o & lmask)));
+        n[OP_VEC_ADD] += D + 1;
+    }
+}
+
+// kv(j) returns the {k, v} row pointers of the j-th K/V row in processing order,
+// so the same datapath runs over contiguous tensors and over a ring KV cache.
+template <class KV>
+void model_attention_row_kv(const int8_t *q, int rows_kv, KV kv, int8_t *o_out,
+                            const ModelConfig &cfg) {
+    const int D = cfg.embedding_dim;
+    ScratchScope scratch;
+    int64_t *o_star = scratch.alloc<int64_t>(D + 1), *v_star = scratch.alloc<int64_t>(D + 1);
+    fill(o_star, o_star + D + 1, 0);
+    int64_t m = 0;
+
+    for (int j = 0; j < rows_kv; ++j) {
+        auto [k, v] = kv(j);
+        int64_t s = model_score(q, k, cfg);
+        int64_t m_new = s > m ? s : m;
+        model_expmul_step(o_star, v_star, v, s, m, m_new, j == 0, cfg);
+        m = m_new;
+    }
+
+    model_normalize(o_star, o_out, cfg);
+}
+
+// ---------------------------
+// The row pass split at its stage boundaries
+// ---------------------------
+// The scores and running max of model_attention_row_kv materialised per row
+// (aura_memo.h caches them across a parameter sweep); a ModelLane given them
+// runs expmul only, and model_normalize finishes the row with the same bits.
+
+// s[j]: EXPMUL_DIFF_IN_QT scores of q against every K row
+inline void model_score_row(const int8_t *q, MatrixView<const int8_t> K, int64_t *s, const ModelConfig &cfg) {
+    for (size_t j = 0; j < K.rows; ++j) s[j] = model_score(q, K.row(j), cfg);
+}
+
+// m[j]: the running max after K/V row j (the max restarts from 0 per query)
+inline void model_running_max(const int64_t *s, int n, int64_t *m) {
+    int64_t cur = 0;
+    for (int j = 0; j < n; ++j) m[j] = cur = s[j] > cur ? s[j] : cur;
+}
+
+// ---------------------------
+// Lane-batched passes
+// ---------------------------
+// MODEL_LANES independent PE passes (query rows of one case, or rows of
+// different cases) step through their K/V rows together, one pass per lane,
+// with the o* accumulators laid out [element][lane]. Every Q-format decision
+// is uniform across the lanes, so the inner loops over the lanes are plain
+// shifts, adds, clamps and selects that compile to vector instructions; what
+// branches per pass in model_attention_row (the l_hat bits of the barrel
+// shifter, a lane whose K/V rows have run out) is a per-lane shift or mask.
+// Scores and Log2Exp stay per lane (a few scalar ops per K/V row); expmul,
+// D + 1 shifts per K/V row, is what runs across the lanes. Same bits as
+// model_attention_row.
+static constexpr int MODEL_LANES = 8;   // one 512-bit vector of int64 per loop step
+
+// q_convert with the format decisions taken once: ((in << up) + add) >> sh,
+// clamped. The q_align_frac and q_align_int saturations are both ranges
+// around 0, so one clamp to their intersection does both.
+struct LaneConvert {
+    int up = 0, sh = 0;
+    int64_t add = 0, lo = numeric_limits<int64_t>::min(), hi = numeric_limits<int64_t>::max();
+
+    LaneConvert(QFormat from, QFormat to, int rounding) {
+        auto clamp_to = [&](int w) {
+            lo = max<int64_t>(lo, -(1LL << (w - 1)));
+            hi = min<int64_t>(hi, (1LL << (w - 1)) - 1);
+        };
+        if (to.f >= from.f) {
+            up = to.f - from.f;
+        } else {
+            sh = from.f - to.f;
+            if (rounding) {
+                add = 1LL << (sh - 1);
+                clamp_to(from.i + to.f + 1);
+            }
+        }
+        if (from.i > to.i) clamp_to(to.width());
+    }
+
+    int64_t operator()(int64_t in) const {
+        int64_t v = (int64_t)(((uint64_t)in << up) + (uint64_t)add) >> sh;
+        return v < lo ? lo : (v > hi ? hi : v);
+    }
+};
+
+// q_wrap for 1 <= w <= 64 without branches
+inline int64_t lane_wrap(int64_t v, int w) { return (int64_t)((uint64_t)v << (64 - w)) >> (64 - w); }
+
+// One pass. With s set the scores and running max come precomputed
+// (s[j], m[j] as model_score_row / model_running_max give them) and q, K are
+// not read. With o_star set the accumulators are written there and the
+// normalisation is left to the caller; otherwise the output row goes to o.
+struct ModelLane {
+    const int8_t *q = nullptr;
+    MatrixView<const int8_t> K, V;
+    const int64_t *s = nullptr, *m = nullptr;
+    int64_t *o_star = nullptr;
+    int8_t *o = nullptr;
+};
+
+// up to MODEL_LANES passes; not for configs with profile or ops set
+inline void model_attention_lanes(const ModelLane *lanes, int n, const ModelConfig &cfg) {
+    constexpr int L = MODEL_LANES;
+    const int D = cfg.embedding_dim;
+    const int lw = cfg.expmul_exp.width(), w = cfg.expmul_shift_stage.width(), vec_w = cfg.expmul_vec.width();
+    const int down = 1 << (lw - 1);
+    const int64_t up_mask = (1LL << (lw - 1)) - 1;
+    const LaneConvert v_in(cfg.input_vec, cfg.expmul_vec, cfg.rounding);
+    const LaneConvert to_stage(cfg.expmul_vec, cfg.expmul_shift_stage, cfg.rounding);
+    const LaneConvert from_stage(cfg.expmul_shift_stage, cfg.expmul_vec, cfg.rounding);
+
+    ScratchScope scratch;
+    int8_t *zero_row = scratch.alloc<int8_t>(D);  // v of the lanes that have finished
+    fill(zero_row, zero_row + D, 0);
+    int64_t *o_star = scratch.alloc<int64_t>((size_t)(D + 1) * L);
+    int64_t *v_star = scratch.alloc<int64_t>((size_t)(D + 1) * L);
+    int64_t *row = scratch.alloc<int64_t>(D + 1);
+    fill(o_star, o_star + (size_t)(D + 1) * L, 0);
+
+    int rows[L] = {}, rows_kv = 0;
+    int64_t m[L] = {};
+    for (int l = 0; l < n; ++l) rows_kv = max(rows_kv, rows[l] = (int)lanes[l].V.rows);
+
+    for (int j = 0; j < rows_kv; ++j) {
+        // per lane: activity, the shift amounts of o* and v*, the v row
+        alignas(64) int64_t keep[L], top_o[L], up_o[L], top_v[L], up_v[L];
+        const int8_t *v[L];
+        for (int l = 0; l < L; ++l) {
+            const ModelLane &ln = lanes[l < n ? l : 0];
+            bool active = l < n && j < rows[l];
+            v[l] = active ? ln.V.row(j) : zero_row;
+            keep[l] = !active;
+            top_o[l] = up_o[l] = top_v[l] = up_v[l] = 0;
+            if (!active) continue;
+            int64_t s = ln.s ? ln.s[j] : model_score(ln.q, ln.K.row(j), cfg);
+            int64_t m_new = ln.s ? ln.m[j] : (s > m[l] ? s : m[l]);
+            int64_t l_o = model_log2exp(m[l], m_new, cfg), l_v = model_log2exp(s, m_new, cfg);
+            top_o[l] = (l_o >> (lw - 1)) & 1;
+            up_o[l] = l_o & up_mask;
+            top_v[l] = (l_v >> (lw - 1)) & 1;
+            up_v[l] = l_v & up_mask;
+            m[l] = m_new;
+        }
+
+        for (int l = 0; l < L; ++l) v_star[l] = 1LL << cfg.expmul_vec.f;
+        for (int d = 0; d < D; ++d)
+            for (int l = 0; l < L; ++l) v_star[(size_t)(d + 1) * L + l] = v_in(v[l][d]);
+
+        // model_exp_shift: the >>> 2^(lw-1) stage, then the left stages, which
+        // compose into one shift by the low bits of l_hat before the wrap
+        const bool first = j == 0;
+        for (int d = 0; d <= D; ++d) {
+            int64_t *o = o_star + (size_t)d * L;
+            const int64_t *vs = v_star + (size_t)d * L;
+            for (int l = 0; l < L; ++l) {
+                int64_t rv = to_stage(vs[l]);
+                rv = top_v[l] ? rv >> down : rv;
+                int64_t acc = from_stage(lane_wrap((int64_t)((uint64_t)rv << up_v[l]), w));
+                int64_t ro = to_stage(o[l]);
+                ro = top_o[l] ? ro >> down : ro;
+                acc += first ? 0 : from_stage(lane_wrap((int64_t)((uint64_t)ro << up_o[l]), w));
+                o[l] = keep[l] ? o[l] : lane_wrap(acc, vec_w);
+            }
+        }
+    }
+
+    for (int l = 0; l < n; ++l) {
+        for (int d = 0; d <= D; ++d) row[d] = o_star[(size_t)d * L + l];
+        if (lanes[l].o_star) copy(row, row + D + 1, lanes[l].o_star);
+        else model_normalize(row, lanes[l].o, cfg);
+    }
+}
+
+// every pass, MODEL_LANES at a time over the threads
+inline void model_attention_lanes(const vector<ModelLane> &lanes, const ModelConfig &cfg, int threads = 1) {
+    const int groups = (int)((lanes.size() + MODEL_LANES - 1) / MODEL_LANES);
+    parallel_rows(groups, threads, [&](int g) {
+        size_t first = (size_t)g * MODEL_LANES;
+        model_attention_lanes(&lanes[first], (int)min<size_t>(MODEL_LANES, lanes.size() - first), cfg);
+    });
+}
+
+// Q is rows_q x dk, K and V are rows_kv x dk, all Q0.7 row-major.
+// Returns rows_q x dk Q0.7 outputs, identical to what the RTL writes to O.
+inline void model_attention_row(const int8_t *q, MatrixView<const int8_t> K,
+                                MatrixView<const int8_t> V, int rows_kv, int8_t *o_out,
+                                const ModelConfig &cfg) {
+    model_attention_row_kv(q, rows_kv, [&](int j) {
+        return pair<const int8_t *, const int8_t *>(K.row(j), V.row(j));
+    }, o_out, cfg);
+}
+
+inline void model_attention_row(const int8_t *q, const int8_t *K, const int8_t *V,
+                                int rows_kv, int8_t *o_out, const ModelConfig &cfg) {
+    const size_t D = cfg.embedding_dim;
+    model_attention_row(q, MatrixView<const int8_t>(K, rows_kv, D),
+                        MatrixView<const int8_t>(V, rows_kv, D), rows_kv, o_out, cfg);
+}
+
+inline void model_attention(MatrixView<const int8_t> Q, MatrixView<const int8_t> K,
+                            MatrixView<const int8_t> V, MatrixView<int8_t> O,
+                            const ModelConfig &cfg, int threads = 1) {
+    const size_t D = cfg.embedding_dim;
+    if (Q.cols != D || K.cols != D || V.cols != D || K.rows != V.rows)
+        throw runtime_error("Q/K/V shapes do not match the model's embedding dimension");
+    if (O.rows != Q.rows || O.cols != D) throw runtime_error("Output shape does not match Q");
+    StatScope scope("model");
+    stats_count(STAT_ROWS, Q.rows);
+    if (cfg.profile || cfg.ops) {
+        parallel_rows((int)Q.rows, threads, [&](int i) {
+            model_attention_row(Q.row(i), K, V, (int)K.rows, O.row(i), cfg);
+        });
+        return;
+    }
+    vector<ModelLane> lanes(Q.rows);
+    for (size_t i = 0; i < Q.rows; ++i) {
+        lanes[i].q = Q.row(i);
+        lanes[i].K = K;
+        lanes[i].V = V;
+        lanes[i].o = O.row(i);
+    }
+    model_attention_lanes(lanes, cfg, threads);
+}
+
+inline vector<int8_t> model_attention(const vector<int8_t> &Q, const vector<int8_t> &K,
+                                      const vector<int8_t> &V, const ModelConfig &cfg,
+                                      int threads = 1) {
+    const int D = cfg.embedding_dim;
+    vector<int8_t> O(Q.size());
+    model_attention(MatrixView<const int8_t>(Q, D), MatrixView<const int8_t>(K, D),
+                    MatrixView<const int8_t>(V, D), MatrixView<int8_t>(O, D), cfg, threads);
+    return O;
+}
+
+// Grouped-query / multi-query attention over head-major Q/K/V (see HeadLayout)
+inline vector<int8_t> model_attention_gqa(const vector<int8_t> &Q, const vector<int8_t> &K,
+                                          const vector<int8_t> &V, const HeadLayout &heads,
+                                          const ModelConfig &cfg, int threads = 1) {
+    return attention_by_head(Q, K, V, heads, cfg.embedding_dim,
+                             [&](const vector<int8_t> &q, const vector<int8_t> &k,
+                                 const vector<int8_t> &v) { return model_attention(q, k, v, cfg, threads); });
+}
+
+#endif // AURA_MODEL_H
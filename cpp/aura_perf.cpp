@@ -0,0 +1,439 @@
+#include "aura_perf.h"
+
+// -----------------------------------------------------
+// Performance model front end: cycles, time and PE utilization for one or
+// more configurations of the AURA top level (see aura_perf.h).
+// -----------------------------------------------------
+
+static void usage(const char *prog) {
+    PerfConfig d;
+    cerr << "Usage: " << prog << " [options]\n"
+         << "  --seq N              K/V rows (default " << d.seq_len << ")\n"
+         << "  --queries N          query rows (default " << d.q_rows << ")\n"
+         << "  --dk N               embedding dimension (default " << d.dk << ")\n"
+         << "  --pes N              processing elements (default " << d.num_pes << ")\n"
+         << "  --bus-bytes N        memory block size (default " << d.bus_bytes << ")\n"
+         << "  --latency N          memory latency in cycles (default " << d.mem_latency << ")\n"
+         << "  --tags N             outstanding memory tags (default " << d.mem_tags << ")\n"
+         << "  --clock-ns X         clock period (default " << d.clock_ns << ")\n"
+         << "  --kv-partitions LIST split-KV partitions, e.g. 1,2,4 (default 1)\n"
+         << "  --group LIST         GQA/MQA query heads per K/V head, e.g. 1,4,8\n"
+         << "  --kv-heads N         K/V heads per layer for --group (default 1)\n"
+         << "  --decode TOKENS      per-token decode latency, resident KV cache vs reload\n"
+         << "  --context N          tokens already in the cache before decoding (default 0)\n"
+         << "  --window W           sliding window in tokens (default " << AURA_SEQ << ")\n"
+         << "  --recip ITERS        reciprocal-multiply normalisation with ITERS Newton-Raphson steps\n"
+         << "  --policies LIST      memory-controller policies KV:ARB, e.g. serial:mode,stream:o-first\n"
+         << "                       (KV serial|stream, ARB mode|o-first|q-first|rr; 'all' for every one)\n"
+         << "  --seqs LIST          sequence lengths for --policies (default --seq)\n"
+         << "  --q-banks N          QSRAM tile buffers (default " << d.q_banks << ")\n"
+         << "  --o-banks N          OSRAM tile buffers (default " << d.o_banks << ")\n"
+         << "  --roofline           compute- vs bandwidth-bound sweep, analytical and simulated, over\n"
+         << "                       --seqs, --bus-bits, --latencies, --tags-list and --pes-list\n"
+         << "  --bus-bits LIST      bus widths for --roofline (default 64,128,256)\n"
+         << "  --latencies LIST     memory latencies for --roofline (default --latency)\n"
+         << "  --tags-list LIST     outstanding tags for --roofline (default --tags)\n"
+         << "  --pes-list LIST      PE counts for --roofline (default 1,2,4,8,16,32,64)\n"
+         << "  --csv FILE           also write the --roofline points as CSV\n"
+         << "  --instances LIST     AURA tops sharing one memory port, e.g. 1,2,4,8\n"
+         << "  --heads H            heads to process with --instances (default 12)\n"
+         << "  --shard heads|queries  one job per head, or each head's queries split over the instances\n"
+         << "  --schedule static|dynamic  deal jobs round robin up front, or to the first idle instance\n"
+         << "  --port rr|fixed      shared port arbitration (default rr)\n"
+         << "  --stalls             per-stage busy / bubble / stall cycles by cause\n"
+         << "  --timeline FILE      per-cycle stage states of the first configuration as CSV\n"
+         << "                       (one line per run of identical cycles)\n";
+}
+
+// One K/V load per group of query heads, against loading K/V for every head
+static void report_groups(const PerfConfig &cfg, const vector<int> &groups, int kv_heads) {
+    cout << "===== AURA Grouped-Query Estimate =====\n";
+    cout << "seq " << cfg.seq_len << ", queries/head " << cfg.q_rows << ", dk " << cfg.dk
+         << ", PEs " << cfg.num_pes << ", partitions " << cfg.kv_partitions << ", K/V heads "
+         << kv_heads << "\n";
+    cout << left << setw(8) << "group" << setw(10) << "tiles" << setw(12) << "cycles"
+         << setw(14) << "cycles/head" << setw(14) << "loads/head" << setw(10) << "vs MHA"
+         << setw(10) << "PE util" << setw(14) << "layer (us)" << "heads/s\n";
+
+    PerfConfig one = cfg;
+    one.group_size = 1;
+    const PerfResult mha = perf_simulate(one);
+    for (int g : groups) {
+        PerfConfig c = cfg;
+        c.group_size = g;
+        PerfResult r = perf_simulate(c);
+        double layer_us = r.time_us(c) * kv_heads;
+        cout << left << setw(8) << g << setw(10) << r.tiles << setw(12) << r.cycles << fixed
+             << setprecision(1) << setw(14) << (double)r.cycles / g << setw(14)
+             << (double)r.mem_loads / g << setprecision(2) << setw(10)
+             << (double)mha.cycles * g / r.cycles << setprecision(3) << setw(10)
+             << r.pe_utilization(c) << setprecision(2) << setw(14) << layer_us << setprecision(0)
+             << 1e6 * g / r.time_us(c) << "\n" << defaultfloat;
+    }
+}
+
+static void report_decode(const PerfConfig &cfg, int context, int tokens, int window) {
+    cout << "===== AURA Decode Estimate =====\n";
+    cout << "context " << context << ", tokens " << tokens << ", window " << window << ", dk "
+         << cfg.dk << ", bus " << cfg.bus_bytes << " B, latency " << cfg.mem_latency << "\n";
+    cout << left << setw(12) << "KV" << setw(12) << "first" << setw(12) << "last" << setw(12)
+         << "max" << setw(12) << "mean" << setw(14) << "us / token" << "tokens / s\n";
+
+    for (bool resident : {true, false}) {
+        PerfDecodeResult d = perf_decode(cfg, context, tokens, window, resident);
+        double us = d.mean() * cfg.clock_ns / 1000.0;
+        cout << left << setw(12) << (resident ? "resident" : "reload") << setw(12) << d.first
+             << setw(12) << d.last << setw(12) << d.max << setw(12) << fixed << setprecision(1)
+             << d.mean() << setw(14) << setprecision(3) << us << setprecision(0) << 1e6 / us
+             << "\n" << defaultfloat;
+    }
+}
+
+// ---------------------------
+// Memory-controller policies
+// ---------------------------
+static const char *kv_load_name(KvLoad k) { return k == KV_SERIAL ? "serial" : "stream"; }
+static const char *arbiter_name(BusArbiter a) {
+    static const char *names[] = {"mode", "o-first", "q-first", "rr"};
+    return names[a];
+}
+
+static vector<pair<KvLoad, BusArbiter>> parse_policies(const string &s) {
+    vector<pair<KvLoad, BusArbiter>> out;
+    if (s == "all") {
+        out.push_back({KV_SERIAL, ARB_MODE});
+        for (KvLoad k : {KV_SERIAL, KV_STREAM})
+            for (BusArbiter a : {ARB_O_FIRST, ARB_Q_FIRST, ARB_ROUND_ROBIN}) out.push_back({k, a});
+        return out;
+    }
+    stringstream ss(s);
+    for (string tok; getline(ss, tok, ',');) {
+        if (tok.empty()) continue;
+        size_t colon = tok.find(':');
+        string kv = tok.substr(0, colon), arb = colon == string::npos ? "o-first" : tok.substr(colon + 1);
+        if (kv != "serial" && kv != "stream") throw runtime_error("Unknown K/V schedule '" + kv + "'");
+        int a = 0;
+        while (a < 4 && arb != arbiter_name((BusArbiter)a)) ++a;
+        if (a == 4) throw runtime_error("Unknown arbiter '" + arb + "'");
+        out.push_back({kv == "serial" ? KV_SERIAL : KV_STREAM, (BusArbiter)a});
+    }
+    if (out.empty()) throw runtime_error("Empty policy list '" + s + "'");
+    return out;
+}
+
+// Time to first output and total cycles of every policy, relative to memory_controller.sv
+static void report_policies(const PerfConfig &cfg, const vector<pair<KvLoad, BusArbiter>> &policies,
+                            const vector<int> &seqs) {
+    cout << "===== AURA Memory-Controller Policies =====\n";
+    cout << "queries " << cfg.q_rows << ", dk " << cfg.dk << ", PEs " << cfg.num_pes << ", bus "
+         << cfg.bus_bytes << " B, latency " << cfg.mem_latency << ", tags " << cfg.mem_tags
+         << ", Q/O banks " << cfg.q_banks << "/" << cfg.o_banks << "\n";
+    cout << left << setw(8) << "seq" << setw(18) << "policy" << setw(12) << "first row" << setw(12)
+         << "first O" << setw(10) << "vs base" << setw(12) << "cycles" << setw(10) << "vs base"
+         << setw(14) << "K/V loaded" << "PE util\n";
+    for (int seq : seqs) {
+        PerfConfig b = cfg;
+        b.seq_len = seq;
+        b.kv_load = KV_SERIAL;
+        b.arbiter = ARB_MODE;
+        const PerfResult base = perf_simulate(b);
+        for (auto [kv, arb] : policies) {
+            PerfConfig c = b;
+            c.kv_load = kv;
+            c.arbiter = arb;
+            PerfResult r = perf_simulate(c);
+            cout << left << setw(8) << seq << setw(18) << string(kv_load_name(kv)) + ":" + arbiter_name(arb)
+                 << setw(12) << r.first_row << setw(12) << r.first_output << fixed << setprecision(2)
+                 << setw(10) << (double)base.first_output / r.first_output << setw(12) << r.cycles
+                 << setw(10) << (double)base.cycles / r.cycles << setw(14) << r.load_v_done
+                 << setprecision(3) << r.pe_utilization(c) << "\n" << defaultfloat;
+        }
+    }
+}
+
+// ---------------------------
+// Roofline / scaling sweep
+// ---------------------------
+struct RooflineSweep {
+    vector<int> seqs, bus_bits = {64, 128, 256}, latencies, tags, pes = {1, 2, 4, 8, 16, 32, 64};
+    string csv;
+};
+
+// One table per sequence length; queries = seq. Every point is simulated and
+// estimated; "bound" is the analytical steady-state limit of the tile loop.
+static void report_roofline(const PerfConfig &cfg, RooflineSweep sw) {
+    if (sw.seqs.empty()) sw.seqs = {cfg.seq_len};
+    if (sw.latencies.empty()) sw.latencies = {cfg.mem_latency};
+    if (sw.tags.empty()) sw.tags = {cfg.mem_tags};
+    ofstream csv;
+    if (!sw.csv.empty()) {
+        csv.open(sw.csv);
+        if (!csv) throw runtime_error("Cannot open " + sw.csv);
+        csv << "seq,bus_bits,latency,tags,pes,analytic_cycles,sim_cycles,macs_per_cycle,peak_macs,"
+               "intensity,bandwidth,bound,knee_pes\n";
+    }
+
+    cout << "===== AURA Roofline / Scaling =====\n";
+    cout << "dk " << cfg.dk << ", queries = seq, partitions " << cfg.kv_partitions << ", policy "
+         << (cfg.kv_load == KV_SERIAL ? "serial" : "stream") << (cfg.arbiter == ARB_MODE ? ":mode" : ":block")
+         << "\n";
+    for (int seq : sw.seqs) {
+        cout << "\nseq " << seq << "\n";
+        cout << left << setw(6) << "bus" << setw(6) << "lat" << setw(6) << "tags" << setw(6) << "PEs"
+             << setw(12) << "analytic" << setw(12) << "simulated" << setw(8) << "err" << setw(11)
+             << "MAC/cycle" << setw(8) << "peak" << setw(9) << "PE util" << setw(11) << "bound"
+             << "knee PEs\n";
+        for (int bits : sw.bus_bits)
+            for (int lat : sw.latencies)
+                for (int tags : sw.tags)
+                    for (int pes : sw.pes) {
+                        PerfConfig c = cfg;
+                        c.seq_len = c.q_rows = seq;
+                        c.bus_bytes = max(1, bits / 8);
+                        c.mem_latency = lat;
+                        c.mem_tags = tags;
+                        c.num_pes = pes;
+                        if (pes % c.kv_partitions) continue;
+                        PerfRoofline a = perf_roofline(c);
+                        PerfResult r = perf_simulate(c);
+                        double achieved = a.macs / r.cycles;
+                        const char *bound = a.bandwidth_bound() ? "bandwidth" : "compute";
+                        cout << left << setw(6) << bits << setw(6) << lat << setw(6) << tags << setw(6) << pes
+                             << setw(12) << (int64_t)llround(a.cycles) << setw(12) << r.cycles << fixed
+                             << setprecision(1) << setw(8) << 100.0 * (a.cycles - r.cycles) / r.cycles
+                             << setw(11) << achieved << setprecision(0) << setw(8) << a.peak_macs
+                             << setprecision(3) << setw(9) << r.pe_utilization(c) << setw(11) << bound
+                             << setprecision(1) << a.knee_pes(c) << "\n" << defaultfloat;
+                        if (csv)
+                            csv << seq << "," << bits << "," << lat << "," << tags << "," << pes << ","
+                                << a.cycles << "," << r.cycles << "," << achieved << "," << a.peak_macs << ","
+                                << a.intensity() << "," << a.bandwidth << "," << bound << ","
+                                << a.knee_pes(c) << "\n";
+                    }
+    }
+    cout << "\nknee PEs: where one tile's Q load + O drain takes as long as its K/V stream\n"
+         << "(sys_defs.svh MAX_NUM_PES with the measured block rate); above it the tile loop is\n"
+         << "bandwidth-bound. The K/V load before compute is memory time at every point.\n";
+    if (csv) cerr << "Wrote " << sw.csv << "\n";
+}
+
+// ---------------------------
+// Multi-instance contention
+// ---------------------------
+static void report_multi(const PerfConfig &cfg, MultiConfig m, const vector<int> &instances) {
+    cout << "===== AURA Multi-Instance Estimate =====\n";
+    cout << m.heads << " heads of seq " << cfg.seq_len << " x queries " << cfg.q_rows << ", PEs "
+         << cfg.num_pes << ", bus " << cfg.bus_bytes << " B, latency " << cfg.mem_latency << ", tags "
+         << cfg.mem_tags << ", shard " << (m.shard == SHARD_HEADS ? "heads" : "queries") << ", schedule "
+         << (m.schedule == SCHED_STATIC ? "static" : "dynamic") << ", port "
+         << (m.port == PORT_ROUND_ROBIN ? "rr" : "fixed") << "\n";
+    cout << left << setw(11) << "instances" << setw(12) << "makespan" << setw(12) << "heads/s" << setw(10)
+         << "speedup" << setw(12) << "efficiency" << setw(11) << "port util" << setw(14) << "mean slowdown"
+         << setw(13) << "max slowdown" << "fairness\n";
+    MultiResult last;
+    for (int n : instances) {
+        m.instances = n;
+        MultiResult r = perf_multi(cfg, m);
+        double mean = 0, worst = 0;
+        int used = 0;
+        for (const auto &i : r.inst)
+            if (i.jobs) mean += i.slowdown(), worst = max(worst, i.slowdown()), used++;
+        mean /= max(1, used);
+        cout << left << setw(11) << n << setw(12) << r.makespan << fixed << setprecision(0) << setw(12)
+             << m.heads / (r.makespan * cfg.clock_ns * 1e-9) << setprecision(2) << setw(10) << r.speedup()
+             << setw(12) << r.speedup() / n << setprecision(3) << setw(11) << r.port_utilization()
+             << setw(14) << mean << setw(13) << worst << r.fairness() << "\n" << defaultfloat;
+        last = r;
+    }
+
+    cout << "\nPer instance (" << last.inst.size() << " instances)\n";
+    cout << left << setw(10) << "instance" << setw(6) << "jobs" << setw(12) << "busy" << setw(12)
+         << "isolated" << setw(10) << "slowdown" << setw(13) << "port stalls" << "tag stalls\n";
+    for (size_t i = 0; i < last.inst.size(); ++i) {
+        const MultiInstance &in = last.inst[i];
+        cout << left << setw(10) << i << setw(6) << in.jobs << setw(12) << in.busy << setw(12) << in.isolated
+             << fixed << setprecision(3) << setw(10) << in.slowdown() << setw(13) << in.port_stalls
+             << in.tag_stalls << "\n" << defaultfloat;
+    }
+}
+
+// Busy / starved / stalled cycles of every PE handshake stage, by cause
+static void report_stalls(const PerfConfig &c, const PerfResult &r) {
+    cout << "\nStall attribution (partitions " << c.kv_partitions << ", " << r.cycles << " cycles)\n";
+    cout << left << setw(9) << "stage" << setw(9) << "busy" << setw(11) << "occupancy" << setw(10)
+         << "bubbles" << setw(10) << "stalls" << setw(9) << "idle" << "by cause\n";
+    int64_t worst = 0;
+    string worst_name;
+    for (int s = 0; s < NUM_PIPE_STAGES; ++s) {
+        const PipeCounters &p = r.pipe[s];
+        stringstream causes;
+        for (int k = 0; k < NUM_PIPE_CAUSES; ++k) {
+            if (p.starved[k]) causes << " starved:" << pipe_cause_name(k) << "=" << p.starved[k];
+            if (p.stalled[k]) causes << " stalled:" << pipe_cause_name(k) << "=" << p.stalled[k];
+            if (p.stalled[k] > worst) worst = p.stalled[k], worst_name = string(pipe_stage_name(s)) +
+                                                                         " waiting on " + pipe_cause_name(k);
+        }
+        cout << left << setw(9) << pipe_stage_name(s) << setw(9) << p.busy << fixed << setprecision(3)
+             << setw(11) << p.occupancy / max<int64_t>(1, r.cycles) << setw(10) << p.total_starved()
+             << setw(10) << p.total_stalled() << setw(9) << p.idle << causes.str() << "\n" << defaultfloat;
+    }
+    if (worst)
+        cout << "Largest back-pressure: " << worst_name << " (" << worst
+             << " cycles, the bound on what one more buffer stage there can recover)\n";
+}
+
+// Run-length CSV of the per-cycle states
+static void write_timeline(const string &path, const PerfTimeline &t) {
+    ofstream out(path);
+    if (!out) throw runtime_error("Cannot open " + path);
+    out << "begin,end";
+    for (int s = 0; s < NUM_PIPE_STAGES; ++s) out << "," << pipe_stage_name(s);
+    out << "\n";
+    for (size_t b = 0, e; b < t.size(); b = e) {
+        for (e = b + 1; e < t.size() && t[e] == t[b]; ++e) {}
+        out << b << "," << e - 1;
+        for (int s = 0; s < NUM_PIPE_STAGES; ++s) out << "," << pipe_state_name(t[b][s]);
+        out << "\n";
+    }
+    cerr << "Wrote " << path << " (" << t.size() << " cycles)\n";
+}
+
+int main(int argc, char **argv) {
+    stats_init(argc, argv);
+    PerfConfig cfg;
+    vector<int> partitions = {1};
+    int decode_tokens = 0, context = 0, window = AURA_SEQ;
+    vector<int> groups;
+    int kv_heads = 1;
+    bool stalls = false;
+    string timeline_path;
+    vector<pair<KvLoad, BusArbiter>> policies;
+    vector<int> seqs;
+    bool roofline = false;
+    RooflineSweep sweep;
+    vector<int> instances;
+    MultiConfig multi;
+
+    try {
+        for (int i = 1; i < argc; ++i) {
+            string a = argv[i];
+            auto need = [&]() -> string {
+                if (i + 1 >= argc) throw runtime_error("Missing value for " + a);
+                return argv[++i];
+            };
+            if (a == "--seq") cfg.seq_len = stoi(need());
+            else if (a == "--queries") cfg.q_rows = stoi(need());
+            else if (a == "--dk") cfg.dk = stoi(need());
+            else if (a == "--pes") cfg.num_pes = stoi(need());
+            else if (a == "--bus-bytes") cfg.bus_bytes = stoi(need());
+            else if (a == "--latency") cfg.mem_latency = stoi(need());
+            else if (a == "--tags") cfg.mem_tags = stoi(need());
+            else if (a == "--clock-ns") cfg.clock_ns = stod(need());
+            else if (a == "--kv-partitions") partitions = parse_list(need());
+            else if (a == "--group") groups = parse_list(need());
+            else if (a == "--kv-heads") kv_heads = stoi(need());
+            else if (a == "--decode") decode_tokens = stoi(need());
+            else if (a == "--context") context = stoi(need());
+            else if (a == "--window") window = stoi(need());
+            else if (a == "--policies") policies = parse_policies(need());
+            else if (a == "--seqs") seqs = parse_list(need());
+            else if (a == "--q-banks") cfg.q_banks = stoi(need());
+            else if (a == "--o-banks") cfg.o_banks = stoi(need());
+            else if (a == "--roofline") roofline = true;
+            else if (a == "--bus-bits") sweep.bus_bits = parse_list(need());
+            else if (a == "--latencies") sweep.latencies = parse_list(need());
+            else if (a == "--tags-list") sweep.tags = parse_list(need());
+            else if (a == "--pes-list") sweep.pes = parse_list(need());
+            else if (a == "--csv") sweep.csv = need();
+            else if (a == "--instances") instances = parse_list(need());
+            else if (a == "--heads") multi.heads = stoi(need());
+            else if (a == "--shard") {
+                string v = need();
+                if (v != "heads" && v != "queries") throw runtime_error("Unknown shard '" + v + "'");
+                multi.shard = v == "heads" ? SHARD_HEADS : SHARD_QUERIES;
+            }
+            else if (a == "--schedule") {
+                string v = need();
+                if (v != "static" && v != "dynamic") throw runtime_error("Unknown schedule '" + v + "'");
+                multi.schedule = v == "static" ? SCHED_STATIC : SCHED_DYNAMIC;
+            }
+            else if (a == "--port") {
+                string v = need();
+                if (v != "rr" && v != "fixed") throw runtime_error("Unknown port arbitration '" + v + "'");
+                multi.port = v == "rr" ? PORT_ROUND_ROBIN : PORT_FIXED;
+            }
+            else if (a == "--stalls") stalls = true;
+            else if (a == "--timeline") timeline_path = need();
+            else if (a == "--recip") {
+                cfg.recip_norm = true;
+                cfg.recip_iterations = stoi(need());
+            }
+            else if (a == "-h" || a == "--help") {
+                usage(argv[0]);
+                return 0;
+            }
+            else throw runtime_error("Unknown option " + a);
+        }
+
+        if (!instances.empty()) {
+            report_multi(cfg, multi, instances);
+            return 0;
+        }
+        if (roofline) {
+            sweep.seqs = seqs;
+            report_roofline(cfg, sweep);
+            return 0;
+        }
+        if (!policies.empty()) {
+            if (seqs.empty()) seqs = {cfg.seq_len};
+            report_policies(cfg, policies, seqs);
+            return 0;
+        }
+        if (decode_tokens > 0) {
+            report_decode(cfg, context, decode_tokens, window);
+            return 0;
+        }
+        if (!groups.empty()) {
+            cfg.kv_partitions = partitions.front();
+            report_groups(cfg, groups, kv_heads);
+            return 0;
+        }
+
+        cout << "===== AURA Performance Model =====\n";
+        cout << "seq " << cfg.seq_len << ", queries " << cfg.q_rows << ", dk " << cfg.dk
+             << ", PEs " << cfg.num_pes << ", bus " << cfg.bus_bytes << " B, latency "
+             << cfg.mem_latency << ", tags " << cfg.mem_tags << ", normalisation "
+             << (cfg.recip_norm ? "reciprocal" : "int_division") << " (" << cfg.norm_latency() << " cycles)\n";
+        cout << left << setw(12) << "partitions" << setw(10) << "tiles" << setw(12) << "cycles"
+             << setw(12) << "time (us)" << setw(10) << "speedup" << setw(12) << "compute"
+             << setw(10) << "speedup" << setw(10) << "PE util" << setw(14) << "load K/V end"
+             << "first O\n";
+
+        // compute = cycles after PH_LOAD_V, the part split-KV can shorten
+        int64_t base = 0, base_compute = 0;
+        vector<pair<PerfConfig, PerfResult>> runs;
+        PerfTimeline timeline;
+        for (int p : partitions) {
+            PerfConfig c = cfg;
+            c.kv_partitions = p;
+            if (!timeline_path.empty() && runs.empty()) c.timeline = &timeline;
+            PerfResult r = perf_simulate(c);
+            runs.push_back({c, r});
+            int64_t compute = r.cycles - r.load_v_done;
+            if (base == 0) base = r.cycles, base_compute = compute;
+            cout << left << setw(12) << p << setw(10) << r.tiles << setw(12) << r.cycles
+                 << setw(12) << fixed << setprecision(2) << r.time_us(c)
+                 << setw(10) << (double)base / r.cycles << setw(12) << compute
+                 << setw(10) << (double)base_compute / compute
+                 << setw(10) << setprecision(3) << r.pe_utilization(c)
+                 << setw(14) << r.load_v_done << r.first_output << "\n" << defaultfloat;
+        }
+        if (stalls)
+            for (const auto &[c, r] : runs) report_stalls(c, r);
+        if (!timeline_path.empty()) write_timeline(timeline_path, timeline);
+    } catch (const exception &e) {
+        cerr << "ERROR: " << e.what() << "\n";
+        return 1;
+    }
+    return 0;
+}
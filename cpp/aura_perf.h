@@ -0,0 +1,815 @@
+// Cycle-level performance model of the AURA top level.
+//
+// Models the handshakes of verilog/AURA.sv rather than the datapath values:
+//   mem               : test/mem.sv, one command per cycle, NUM_MEM_TAGS tags,
+//                       MEM_LATENCY_IN_CYCLES latency, one load return per cycle
+//   memory_controller : PH_LOAD_K -> PH_LOAD_V -> PH_COMPUTE, where compute
+//                       alternates CMP_LOAD_Q / CMP_DRAIN_O with an idle cycle
+//                       between modes (O drains have priority)
+//   QSRAM / OSRAM     : two banks of one tile each (q_banks / o_banks)
+//   KSRAM / VSRAM     : hold the whole sequence and are re-read for every tile
+//   PEs               : one K/V row per cycle in lockstep, then the
+//                       dot/max/expmul pipeline and the divu iterations (or,
+//                       with recip_norm, one reciprocal and a multiply)
+// With kv_partitions > 1 each query's K/V range is split over that many PEs
+// (split-KV); the partial (m, o*) pairs are merged with expmul-style rescaling
+// before the division, so a tile holds num_pes / kv_partitions queries.
+// With kv_resident > 0 that many K/V rows are already in KSRAM/VSRAM (a
+// persistent decode cache) and PH_LOAD_K/V only fetch the remaining rows.
+// The controller's scheduling policy is configurable (PerfConfig::kv_load and
+// ::arbiter): KV_STREAM interleaves K and V row by row and loads them
+// alongside compute instead of in two phases before it, and the per-block
+// arbiters grant the bus to O stores, Q loads and K/V loads every cycle
+// (fixed priority or round robin) instead of one whole tile per mode.
+// With group_size > 1 (GQA/MQA) one K/V load serves that many query heads: the
+// Q tiles of every head in the group stream through the PEs before the next
+// group's PH_LOAD_K.
+//
+// Every cycle each stage of the PE handshake chain (PE.sv) is classified as
+// busy, starved (no valid input: a bubble), stalled (valid output but the next
+// stage is not ready) or idle, with the cause of every bubble and stall:
+//   STREAM : dot_product fed from QSRAM / KSRAM / VSRAM, one K/V row per cycle
+//   EXPMUL : the dot -> max -> expmul pipeline (busy while rows are in flight)
+//   DIV    : vector_division (int_division or the reciprocal multiply)
+//   OSRAM  : the O tile drained to memory by the controller
+
+#ifndef AURA_PERF_H
+#define AURA_PERF_H
+
+#include "aura_common.h"
+
+// ---------------------------
+// Stall attribution
+// ---------------------------
+enum PipeStage { PIPE_STREAM, PIPE_EXPMUL, PIPE_DIV, PIPE_OSRAM, NUM_PIPE_STAGES };
+enum PipeKind : uint8_t { PIPE_BUSY, PIPE_STARVED, PIPE_STALLED, PIPE_IDLE };
+enum PipeCause : uint8_t {
+    CAUSE_NONE,
+    CAUSE_QSRAM,     // no Q tile loaded
+    CAUSE_KSRAM,     // K row not yet in KSRAM
+    CAUSE_VSRAM,     // V row not yet in VSRAM
+    CAUSE_UPSTREAM,  // the previous stage has nothing for this one
+    CAUSE_DIV,       // int_division still busy with the previous tile
+    CAUSE_OSRAM,     // both OSRAM banks full
+    CAUSE_BUS,       // the memory bus is loading Q (or switching modes)
+    CAUSE_TAGS,      // no free memory tag
+    NUM_PIPE_CAUSES
+};
+
+inline const char *pipe_stage_name(int s) {
+    static const char *names[NUM_PIPE_STAGES] = {"STREAM", "EXPMUL", "DIV", "OSRAM"};
+    return names[s];
+}
+inline const char *pipe_cause_name(int c) {
+    static const char *names[NUM_PIPE_CAUSES] = {"-", "QSRAM", "KSRAM", "VSRAM", "upstream",
+                                                 "int_division", "OSRAM", "bus", "tags"};
+    return names[c];
+}
+
+struct PipeState {
+    PipeKind kind = PIPE_IDLE;
+    PipeCause cause = CAUSE_NONE;
+
+    bool operator==(const PipeState &o) const { return kind == o.kind && cause == o.cause; }
+    bool operator!=(const PipeState &o) const { return !(*this == o); }
+};
+
+// "busy", "idle", "starved:KSRAM", "stalled:OSRAM"
+inline string pipe_state_name(PipeState s) {
+    static const char *kinds[] = {"busy", "starved", "stalled", "idle"};
+    string n = kinds[s.kind];
+    if (s.cause != CAUSE_NONE) n += string(":") + pipe_cause_name(s.cause);
+    return n;
+}
+
+struct PipeCounters {
+    int64_t busy = 0, idle = 0;
+    int64_t starved[NUM_PIPE_CAUSES] = {}, stalled[NUM_PIPE_CAUSES] = {};
+    double occupancy = 0;  // summed per cycle: busy or holding a result (EXPMUL: share of its slots)
+
+    void add(PipeState s) {
+        switch (s.kind) {
+        case PIPE_BUSY: busy++; break;
+        case PIPE_IDLE: idle++; break;
+        case PIPE_STARVED: starved[s.cause]++; break;
+        case PIPE_STALLED: stalled[s.cause]++; break;
+        }
+    }
+    int64_t total_starved() const { return accumulate(starved, starved + NUM_PIPE_CAUSES, int64_t(0)); }
+    int64_t total_stalled() const { return accumulate(stalled, stalled + NUM_PIPE_CAUSES, int64_t(0)); }
+};
+
+// one entry per cycle, filled when PerfConfig::timeline is set
+using PerfTimeline = vector<array<PipeState, NUM_PIPE_STAGES>>;
+
+enum KvLoad { KV_SERIAL, KV_STREAM };
+enum BusArbiter { ARB_MODE, ARB_O_FIRST, ARB_Q_FIRST, ARB_ROUND_ROBIN };
+
+struct PerfConfig {
+    // problem
+    int seq_len = AURA_SEQ;       // K/V rows
+    int q_rows = AURA_SEQ;        // queries
+    int dk = AURA_DK;
+    int elem_bytes = 1;           // `INTEGER_WIDTH / 8
+
+    // hardware (sys_defs.svh)
+    int num_pes = 4;              // `NUM_PES
+    int bus_bytes = 8;            // `MEM_BLOCK_SIZE_BYTES
+    int mem_latency = 10;         // `MEM_LATENCY_IN_CYCLES at CLOCK_PERIOD 10
+    int mem_tags = 15;            // `NUM_MEM_TAGS
+    double clock_ns = 10.0;       // CLOCK_PERIOD
+    int kv_partitions = 1;        // split-KV partitions per query (divides num_pes)
+    int kv_resident = 0;          // K/V rows already held in KSRAM/VSRAM
+    int group_size = 1;           // query heads sharing one K/V head (q_rows per head)
+
+    // memory-controller scheduling (memory_controller.sv is KV_SERIAL + ARB_MODE)
+    KvLoad kv_load = KV_SERIAL;
+    BusArbiter arbiter = ARB_MODE;
+    int q_banks = 2, o_banks = 2; // QSRAM / OSRAM tile buffers
+
+    // PE pipeline latencies in cycles
+    int dot_latency = 4;          // input latch + NUM_REDUCE_STAGES
+    int max_latency = 1;
+    int expmul_latency = 2;
+    int div_latency = 27;         // start + WIDTH+FBITS iterations + valid
+    int merge_latency = 3;        // one split-KV combine level (expmul + add)
+
+    // reciprocal-multiply normalisation instead of int_division: LUT seed,
+    // two multiplies per Newton-Raphson step, the shared o* multiply, valid
+    bool recip_norm = false;
+    int recip_iterations = 1;
+
+    // when set, the per-cycle stage states are appended here
+    PerfTimeline *timeline = nullptr;
+
+    int norm_latency() const { return recip_norm ? 3 + 2 * recip_iterations : div_latency; }
+    int expmul_pipe_latency() const {
+        return dot_latency + max_latency + expmul_latency + merge_levels() * merge_latency;
+    }
+
+    int blocks_per_vec() const { return (dk * elem_bytes + bus_bytes - 1) / bus_bytes; }
+    int queries_per_tile() const { return num_pes / kv_partitions; }
+    int rows_per_partition() const { return (seq_len + kv_partitions - 1) / kv_partitions; }
+    int tiles_per_head() const { return (q_rows + queries_per_tile() - 1) / queries_per_tile(); }
+    int num_tiles() const { return tiles_per_head() * group_size; }
+    int merge_levels() const { return clog2(kv_partitions); }
+
+    void validate() const {
+        if (seq_len <= 0 || q_rows <= 0 || dk <= 0 || num_pes <= 0 || bus_bytes <= 0)
+            throw runtime_error("Perf config sizes must be positive");
+        if (mem_tags <= 0 || mem_latency < 0) throw runtime_error("Bad memory parameters");
+        if (kv_partitions <= 0 || num_pes % kv_partitions != 0)
+            throw runtime_error("kv_partitions must divide num_pes");
+        if (group_size <= 0) throw runtime_error("group_size must be positive");
+        if (kv_resident < 0 || kv_resident > seq_len)
+            throw runtime_error("kv_resident must be in [0, seq_len]");
+        if (recip_iterations < 0) throw runtime_error("recip_iterations must be non-negative");
+        if (q_banks <= 0 || o_banks <= 0) throw runtime_error("QSRAM/OSRAM need at least one bank");
+        if (kv_load == KV_STREAM && arbiter == ARB_MODE)
+            throw runtime_error("Streaming K/V needs a per-block bus arbiter");
+    }
+};
+
+// on-chip buffers; accesses are counted in dk-element vectors
+enum PerfSram { SRAM_Q, SRAM_K, SRAM_V, SRAM_O, NUM_SRAMS };
+
+struct PerfResult {
+    int64_t cycles = 0;
+    int64_t load_k_done = 0;      // cycle the last K vector reached KSRAM
+    int64_t load_v_done = 0;
+    int64_t first_row = 0;        // cycle the first K/V row entered the PEs
+    int64_t first_output = 0;     // cycle the first O tile finished draining
+    int64_t mem_loads = 0, mem_stores = 0;
+    int64_t tag_stalls = 0;       // cycles a request waited for a free tag
+    int64_t port_stalls = 0;      // cycles another instance held the shared memory port
+    int64_t pe_row_cycles = 0;    // K/V rows processed summed over PEs
+    int64_t sram_reads[NUM_SRAMS] = {}, sram_writes[NUM_SRAMS] = {};
+    int tiles = 0;
+    array<PipeCounters, NUM_PIPE_STAGES> pipe;  // stall attribution per stage
+
+    double time_us(const PerfConfig &c) const { return cycles * c.clock_ns / 1000.0; }
+    double pe_utilization(const PerfConfig &c) const {
+        return cycles ? pe_row_cycles / double(cycles * c.num_pes) : 0.0;
+    }
+};
+
+// ---------------------------
+// test/mem.sv: tags held for the latency (loads until their data is returned)
+// ---------------------------
+class PerfMemory {
+public:
+    PerfMemory(int latency, int tags) : latency_(latency), tag_free_(tags, 0) {}
+
+    // Issue a command at cycle `now`; returns the data return cycle for loads,
+    // `now` for stores, -1 when no tag is free or -2 when the port already took
+    // a command this cycle (only when instances share the memory).
+    int64_t issue(int64_t now, bool load) {
+        if (now == last_issue_) return -2;
+        auto it = find_if(tag_free_.begin(), tag_free_.end(), [&](int64_t t) { return t <= now; });
+        if (it == tag_free_.end()) return -1;
+        last_issue_ = now;
+        if (!load) {
+            *it = now + latency_ + 1;
+            return now;
+        }
+        int64_t ret = max<int64_t>(now + latency_, last_return_ + 1);  // one return per cycle
+        last_return_ = ret;
+        *it = ret + 1;
+        return ret;
+    }
+
+private:
+    int latency_;
+    vector<int64_t> tag_free_;
+    int64_t last_return_ = -1, last_issue_ = -1;
+};
+
+// ---------------------------
+// Top-level simulation
+// ---------------------------
+class PerfSim {
+public:
+    // With `shared`, the instance issues into a memory other instances also use,
+    // and its cycle 0 is global cycle `start`
+    explicit PerfSim(const PerfConfig &cfg, PerfMemory *shared = nullptr, int64_t start = 0)
+        : c(cfg), own_mem(cfg.mem_latency, cfg.mem_tags), mem(shared ? *shared : own_mem), t0(start) {
+        c.validate();
+        bpv = c.blocks_per_vec();
+        tiles = c.num_tiles();
+        expmul_latency = c.expmul_pipe_latency();
+        pipe_latency = expmul_latency + c.norm_latency();
+        k_rows = v_rows = c.kv_resident;
+        if (c.kv_load == KV_STREAM) phase = PH_COMPUTE;  // K/V load alongside compute
+    }
+
+    PerfResult run() {
+        const int64_t q_total = (int64_t)c.q_rows * c.group_size;
+        const int64_t limit = 64 + 4LL * (c.seq_len + q_total) * bpv * (c.mem_latency + 2) +
+                              (int64_t)tiles * (c.rows_per_partition() + pipe_latency + 4 * bpv * c.num_pes);
+        for (now = 0; !done(); ++now) {
+            if (now > limit) throw runtime_error("Perf model did not finish (deadlock)");
+            step_controller();
+            step_pes();
+            attribute();
+        }
+        return result();
+    }
+
+    // external clocking (perf_multi): one cycle per call until finished()
+    bool finished() const { return done(); }
+    int64_t commands() const { return r.mem_loads + r.mem_stores; }
+    void step() {
+        step_controller();
+        step_pes();
+        attribute();
+        ++now;
+    }
+    PerfResult result() {
+        r.cycles = now;
+        r.tiles = tiles;
+        r.sram_writes[SRAM_K] = r.sram_writes[SRAM_V] = c.seq_len - c.kv_resident;
+        return r;
+    }
+
+private:
+    PerfConfig c;
+    PerfMemory own_mem;
+    PerfMemory &mem;
+    int64_t t0 = 0;               // global cycle of local cycle 0
+    PerfResult r;
+    int bpv = 1, tiles = 0, pipe_latency = 0, expmul_latency = 0;
+    int64_t now = 0;
+
+    // memory controller
+    enum Phase { PH_LOAD_K, PH_LOAD_V, PH_COMPUTE } phase = PH_LOAD_K;
+    enum Mode { CMP_IDLE, CMP_LOAD_Q, CMP_DRAIN_O } mode = CMP_IDLE;
+    int64_t issued = 0, received = 0, phase_blocks = 0;
+    enum Load : uint8_t { LOAD_K, LOAD_V, LOAD_Q };
+    deque<pair<int64_t, Load>> returns;  // data return cycles of in-flight loads
+    int k_rows = 0, v_rows = 0;   // vectors resident in KSRAM / VSRAM
+    int q_tiles_loaded = 0, o_tiles_drained = 0;
+
+    // per-block arbitration (arbiter != ARB_MODE)
+    int64_t kv_issued = 0, k_blocks = 0, v_blocks = 0;
+    int q_started = 0, q_issued = 0;  // Q tiles whose loads began; blocks of the newest
+    deque<int> q_pending;         // outstanding returns of every Q tile in flight
+    int o_issued = 0;             // blocks of the front OSRAM bank already stored
+    int rr_next = 0;              // round robin: requester after the last grant
+
+    // QSRAM / OSRAM banks
+    int q_banks_full = 0, o_banks_full = 0;
+    deque<int> o_bank_queries;    // queries held by each full OSRAM bank
+
+    // PE array
+    bool streaming = false;
+    int tile = 0, tile_row = 0;
+    int64_t div_ready = -1;       // cycle the divided tile is ready for OSRAM
+    int div_tile = -1;
+
+    // stall attribution: states set by the step functions this cycle
+    PipeState stream_state, osram_state;
+    deque<int64_t> expmul_rows;   // cycles the rows in the expmul pipeline entered it
+    deque<PipeState> stream_history;  // STREAM states of the last expmul_latency cycles
+
+    // tiles never straddle heads: tile t is tile t % tiles_per_head of its head
+    int tile_queries(int t) const {
+        int local = t % c.tiles_per_head();
+        return min(c.queries_per_tile(), c.q_rows - local * c.queries_per_tile());
+    }
+    bool done() const { return o_tiles_drained == tiles; }
+
+    // one command per cycle on the bus
+    PipeCause blocked = CAUSE_NONE;  // why the last request was refused
+    bool request(bool load, Load kind = LOAD_Q) {
+        int64_t ret = mem.issue(now + t0, load);
+        if (ret == -2) {
+            r.port_stalls++;
+            blocked = CAUSE_BUS;
+            return false;
+        }
+        if (ret < 0) {
+            r.tag_stalls++;
+            blocked = CAUSE_TAGS;
+            return false;
+        }
+        if (load) {
+            returns.push_back({ret - t0, kind});
+            r.mem_loads++;
+        } else {
+            r.mem_stores++;
+        }
+        return true;
+    }
+
+    // blocks whose data returns this cycle
+    int64_t take_returns() {
+        int64_t n = 0;
+        while (!returns.empty() && returns.front().first <= now) {
+            returns.pop_front();
+            ++n;
+        }
+        return n;
+    }
+
+    void step_controller() {
+        osram_state = {done() ? PIPE_IDLE : PIPE_STARVED, done() ? CAUSE_NONE : CAUSE_UPSTREAM};
+        switch (phase) {
+        case PH_LOAD_K:
+        case PH_LOAD_V: {
+            phase_blocks = (int64_t)(c.seq_len - c.kv_resident) * bpv;
+            if (issued < phase_blocks && request(true, phase == PH_LOAD_K ? LOAD_K : LOAD_V)) issued++;
+            received += take_returns();
+            int &rows = (phase == PH_LOAD_K) ? k_rows : v_rows;
+            rows = c.kv_resident + (int)(received / bpv);
+            if (rows == c.seq_len) {
+                if (phase == PH_LOAD_K) {
+                    r.load_k_done = now;
+                    phase = PH_LOAD_V;
+                } else {
+                    r.load_v_done = now;
+                    phase = PH_COMPUTE;
+                }
+                issued = received = 0;
+            }
+            break;
+        }
+        case PH_COMPUTE:
+            if (c.arbiter == ARB_MODE) step_compute();
+            else step_bus();
+            break;
+        }
+    }
+
+    void step_compute() {
+        blocked = CAUSE_NONE;
+        if (mode == CMP_DRAIN_O)
+            osram_state = {PIPE_BUSY, CAUSE_NONE};
+        else if (o_banks_full > 0)
+            osram_state = {PIPE_STALLED, CAUSE_BUS};
+        if (mode == CMP_IDLE) {
+            if (o_banks_full > 0 && o_tiles_drained < tiles) {
+                mode = CMP_DRAIN_O;
+                phase_blocks = (int64_t)o_bank_queries.front() * bpv;
+                issued = 0;
+            } else if (q_banks_full < c.q_banks && q_tiles_loaded < tiles) {
+                mode = CMP_LOAD_Q;
+                phase_blocks = (int64_t)tile_queries(q_tiles_loaded) * bpv;
+                issued = received = 0;
+            }
+            return;  // the mode takes effect next cycle
+        }
+
+        if (mode == CMP_DRAIN_O) {
+            if (issued < phase_blocks && request(false)) issued++;
+            if (blocked) osram_state = {PIPE_STALLED, blocked};
+            if (issued == phase_blocks) {
+                o_banks_full--;
+                r.sram_reads[SRAM_O] += o_bank_queries.front();
+                o_bank_queries.pop_front();
+                if (o_tiles_drained++ == 0) r.first_output = now;
+                mode = CMP_IDLE;
+            }
+        } else {
+            if (issued < phase_blocks && request(true)) issued++;
+            received += take_returns();
+            if (received == phase_blocks) {
+                q_banks_full++;
+                r.sram_writes[SRAM_Q] += tile_queries(q_tiles_loaded);
+                q_tiles_loaded++;
+                mode = CMP_IDLE;
+            }
+        }
+    }
+
+    // One command per cycle granted to an O store, a Q load or (KV_STREAM) a
+    // K/V load, with no turnaround between them. Q tiles may be in flight while
+    // a bank is free for them; K/V rows arrive as K row, V row, K row, ...
+    void step_bus() {
+        blocked = CAUSE_NONE;
+        const int64_t kv_total = c.kv_load == KV_STREAM ? 2LL * (c.seq_len - c.kv_resident) * bpv : 0;
+        const bool q_open = q_started > 0 && q_issued < tile_queries(q_started - 1) * bpv;
+        const bool want[3] = {
+            o_banks_full > 0,
+            q_open || (q_started < tiles && q_banks_full + (int)q_pending.size() < c.q_banks),
+            kv_issued < kv_total};
+        enum { REQ_O, REQ_Q, REQ_KV, REQ_NONE };
+
+        int grant = REQ_NONE;
+        static const int order_o[3] = {REQ_O, REQ_Q, REQ_KV}, order_q[3] = {REQ_Q, REQ_O, REQ_KV};
+        for (int i = 0; i < 3 && grant == REQ_NONE; ++i) {
+            int k = c.arbiter == ARB_O_FIRST   ? order_o[i]
+                    : c.arbiter == ARB_Q_FIRST ? order_q[i]
+                                               : (rr_next + i) % 3;
+            if (want[k]) grant = k;
+        }
+
+        if (grant == REQ_O) {
+            if (request(false)) {
+                osram_state = {PIPE_BUSY, CAUSE_NONE};
+                if (++o_issued == o_bank_queries.front() * bpv) {
+                    o_banks_full--;
+                    r.sram_reads[SRAM_O] += o_bank_queries.front();
+                    o_bank_queries.pop_front();
+                    o_issued = 0;
+                    if (o_tiles_drained++ == 0) r.first_output = now;
+                }
+                rr_next = REQ_O + 1;
+            } else {
+                osram_state = {PIPE_STALLED, blocked};
+            }
+        } else {
+            if (want[REQ_O]) osram_state = {PIPE_STALLED, CAUSE_BUS};
+            if (grant == REQ_Q) {
+                bool fresh = !q_open;
+                if (request(true, LOAD_Q)) {
+                    if (fresh) {
+                        q_started++;
+                        q_issued = 0;
+                        q_pending.push_back(tile_queries(q_started - 1) * bpv);
+                    }
+                    q_issued++;
+                    rr_next = REQ_Q + 1;
+                }
+            } else if (grant == REQ_KV) {
+                bool is_k = kv_issued % (2 * bpv) < bpv;
+                if (request(true, is_k ? LOAD_K : LOAD_V)) {
+                    kv_issued++;
+                    rr_next = (REQ_KV + 1) % 3;
+                }
+            }
+        }
+
+        while (!returns.empty() && returns.front().first <= now) {
+            Load kind = returns.front().second;
+            returns.pop_front();
+            if (kind == LOAD_K) k_blocks++;
+            else if (kind == LOAD_V) v_blocks++;
+            else if (--q_pending.front() == 0) {
+                q_pending.pop_front();
+                q_banks_full++;
+                r.sram_writes[SRAM_Q] += tile_queries(q_tiles_loaded);
+                q_tiles_loaded++;
+            }
+        }
+        if (kv_total) {
+            k_rows = c.kv_resident + (int)(k_blocks / bpv);
+            v_rows = c.kv_resident + (int)(v_blocks / bpv);
+            if (k_rows == c.seq_len && !r.load_k_done) r.load_k_done = now;
+            if (v_rows == c.seq_len && !r.load_v_done) r.load_v_done = now;
+        }
+    }
+
+    void step_pes() {
+        // divided outputs of the previous tile go to the OSRAM fill bank
+        if (div_tile >= 0 && now >= div_ready && o_banks_full < c.o_banks) {
+            o_banks_full++;
+            o_bank_queries.push_back(tile_queries(div_tile));
+            r.sram_writes[SRAM_O] += tile_queries(div_tile);
+            div_tile = -1;
+        }
+
+        if (!streaming) {
+            // Q is latched together with the first K/V row, no bubble between tiles
+            if (tile >= tiles) {
+                stream_state = {PIPE_IDLE, CAUSE_NONE};
+                return;
+            }
+            if (q_banks_full == 0) {
+                // Q tiles only load in PH_COMPUTE: before that the wait is the K/V load
+                stream_state = {PIPE_STARVED, phase == PH_COMPUTE ? CAUSE_QSRAM
+                                              : phase == PH_LOAD_K ? CAUSE_KSRAM : CAUSE_VSRAM};
+                return;
+            }
+            q_banks_full--;
+            r.sram_reads[SRAM_Q] += tile_queries(tile);
+            streaming = true;
+            tile_row = 0;
+        }
+
+        const int rpp = c.rows_per_partition();
+        // K/V rows needed this cycle by the last partition
+        int need = min(c.seq_len, (c.kv_partitions - 1) * rpp + tile_row + 1);
+        bool kv_ready = k_rows >= need && v_rows >= need;
+        // the last row can only leave expmul once the divider is free
+        bool last = tile_row == rpp - 1;
+        if (!kv_ready) {
+            stream_state = {PIPE_STARVED, k_rows < need ? CAUSE_KSRAM : CAUSE_VSRAM};
+            return;
+        }
+        if (last && div_tile >= 0) {
+            stream_state = {PIPE_STALLED, now < div_ready ? CAUSE_DIV : CAUSE_OSRAM};
+            return;
+        }
+        stream_state = {PIPE_BUSY, CAUSE_NONE};
+        expmul_rows.push_back(now);
+        if (r.pe_row_cycles == 0) r.first_row = now;
+
+        int rows_now = 0;
+        for (int p = 0; p < c.kv_partitions; ++p)
+            if (p * rpp + tile_row < c.seq_len) rows_now++;
+        r.pe_row_cycles += (int64_t)rows_now * tile_queries(tile);
+        r.sram_reads[SRAM_K] += rows_now;  // one read per partition, broadcast to its PEs
+        r.sram_reads[SRAM_V] += rows_now;
+
+        if (++tile_row == rpp) {
+            div_tile = tile;
+            div_ready = now + pipe_latency;
+            streaming = false;
+            tile++;
+        }
+    }
+
+    // classify every stage for this cycle
+    void attribute() {
+        array<PipeState, NUM_PIPE_STAGES> st;
+        st[PIPE_STREAM] = stream_state;
+
+        // EXPMUL: busy while rows are in flight; a bubble here is a STREAM
+        // bubble expmul_latency cycles ago
+        while (!expmul_rows.empty() && expmul_rows.front() + expmul_latency <= now) expmul_rows.pop_front();
+        stream_history.push_back(stream_state);
+        PipeState past = stream_history.front();
+        if ((int)stream_history.size() > expmul_latency) stream_history.pop_front();
+        if (!expmul_rows.empty())
+            st[PIPE_EXPMUL] = {PIPE_BUSY, CAUSE_NONE};
+        else if (tile >= tiles && !streaming)
+            st[PIPE_EXPMUL] = {PIPE_IDLE, CAUSE_NONE};
+        else
+            st[PIPE_EXPMUL] = {PIPE_STARVED, past.kind == PIPE_BUSY ? CAUSE_UPSTREAM : past.cause};
+
+        // DIV: busy for its latency, then holds the tile until an OSRAM bank frees
+        if (div_tile >= 0 && now >= div_ready)
+            st[PIPE_DIV] = {PIPE_STALLED, CAUSE_OSRAM};
+        else if (div_tile >= 0 && now >= div_ready - c.norm_latency())
+            st[PIPE_DIV] = {PIPE_BUSY, CAUSE_NONE};
+        else if (div_tile < 0 && tile >= tiles)
+            st[PIPE_DIV] = {PIPE_IDLE, CAUSE_NONE};
+        else
+            st[PIPE_DIV] = {PIPE_STARVED, stream_state.kind == PIPE_STARVED ? stream_state.cause : CAUSE_UPSTREAM};
+
+        st[PIPE_OSRAM] = osram_state;
+
+        for (int s = 0; s < NUM_PIPE_STAGES; ++s) {
+            r.pipe[s].add(st[s]);
+            if (s != PIPE_EXPMUL) r.pipe[s].occupancy += st[s].kind == PIPE_BUSY || st[s].kind == PIPE_STALLED;
+        }
+        r.pipe[PIPE_EXPMUL].occupancy += expmul_rows.size() / (double)max(1, expmul_latency);
+        if (c.timeline) c.timeline->push_back(st);
+    }
+};
+
+inline PerfResult perf_simulate(const PerfConfig &cfg) {
+    StatScope scope("simulate");
+    return PerfSim(cfg).run();
+}
+
+// ---------------------------
+// Analytical (roofline) estimate of the same configuration. One block per
+// cycle at most, and at most mem_tags blocks in flight per latency + 1 cycles.
+// Steady state, each tile streams rows_per_partition K/V rows (compute) while
+// the bus loads the next Q tile and drains the previous O tile (memory), so a
+// tile costs the larger of the two; PH_LOAD_K/V before it is pure memory time,
+// and the last tile only adds its rows, the pipeline and its own O drain.
+// ---------------------------
+struct PerfRoofline {
+    double block_rate = 0;        // blocks per cycle the bus and tags sustain
+    double load_kv = 0;           // PH_LOAD_K + PH_LOAD_V
+    double tile_compute = 0, tile_memory = 0;
+    double cycles = 0;
+    double macs = 0;              // Q.K^T and P.V multiply-accumulates
+    double bytes = 0;             // K, V and Q loaded, O stored
+    double peak_macs = 0;         // per cycle, every PE busy
+    double bandwidth = 0;         // bytes per cycle
+
+    bool bandwidth_bound() const { return tile_memory > tile_compute; }
+    double intensity() const { return bytes ? macs / bytes : 0.0; }
+    // PEs at which the tile traffic catches up with the compute (MAX_NUM_PES with the full bus)
+    double knee_pes(const PerfConfig &c) const {
+        return c.rows_per_partition() * block_rate * c.kv_partitions / (2.0 * c.blocks_per_vec());
+    }
+};
+
+inline PerfRoofline perf_roofline(const PerfConfig &c) {
+    c.validate();
+    PerfRoofline a;
+    const int bpv = c.blocks_per_vec(), qpt = c.queries_per_tile();
+    const double q_total = (double)c.q_rows * c.group_size;
+    a.block_rate = min(1.0, (double)c.mem_tags / (c.mem_latency + 1));
+    a.load_kv = 2.0 * (c.seq_len - c.kv_resident) * bpv / a.block_rate + 2 * c.mem_latency;
+    a.tile_compute = c.rows_per_partition();
+    // Q in and O out; the tile-per-mode controller waits for the Q returns and
+    // spends an idle cycle on each mode switch
+    a.tile_memory = 2.0 * qpt * bpv / a.block_rate + (c.arbiter == ARB_MODE ? c.mem_latency + 2 : 0);
+    const double first_q = qpt * bpv / a.block_rate + c.mem_latency + 1;
+    const double tail = c.expmul_pipe_latency() + c.norm_latency() + qpt * bpv / a.block_rate + 2;
+    a.cycles = (c.kv_load == KV_SERIAL ? a.load_kv + first_q : first_q) +
+               (c.num_tiles() - 1) * max(a.tile_compute, a.tile_memory) + a.tile_compute + tail;
+    if (c.kv_load == KV_STREAM) a.cycles = max(a.cycles, a.load_kv + a.tile_compute + tail);
+    a.macs = 2.0 * c.dk * q_total * c.seq_len;
+    a.bytes = (2.0 * (c.seq_len - c.kv_resident) + 2.0 * q_total) * c.dk * c.elem_bytes;
+    a.peak_macs = 2.0 * c.dk * c.num_pes;
+    a.bandwidth = c.bus_bytes * a.block_rate;
+    return a;
+}
+
+// ---------------------------
+// Incremental decode: one query per token over a growing (or sliding) context.
+// With a resident cache only the new token's K/V row is loaded per step;
+// otherwise the whole window is reloaded through PH_LOAD_K/V every token.
+// A sliding window needs KSRAM/VSRAM addressed as a ring, so the window is
+// limited to their depth.
+// ---------------------------
+struct PerfDecodeResult {
+    int64_t total = 0, first = 0, last = 0, max = 0;
+    int tokens = 0;
+
+    double mean() const { return tokens ? double(total) / tokens : 0.0; }
+};
+
+inline PerfDecodeResult perf_decode(const PerfConfig &cfg, int context, int tokens, int window,
+                                    bool resident) {
+    if (context < 0 || tokens <= 0) throw runtime_error("Decode needs context >= 0 and tokens > 0");
+    if (window <= 0 || window > AURA_SEQ)
+        throw runtime_error("Decode window must be in [1, " + to_string(AURA_SEQ) + "]");
+
+    PerfDecodeResult d;
+    for (int t = 0; t < tokens; ++t) {
+        PerfConfig c = cfg;
+        c.q_rows = 1;
+        c.seq_len = min(context + t + 1, window);
+        c.kv_resident = resident ? min(context + t, window - 1) : 0;
+        int64_t cycles = perf_simulate(c).cycles;
+        if (t == 0) d.first = cycles;
+        d.last = cycles;
+        d.max = max(d.max, cycles);
+        d.total += cycles;
+        d.tokens++;
+    }
+    return d;
+}
+
+// ---------------------------
+// Several AURA tops sharing one memory port (test/mem.sv: one command per
+// cycle, shared tags and latency, one load return per cycle). The work is
+// `heads` heads, either one job per head or each head's queries split into one
+// shard per instance (every shard loads the whole K/V). STATIC deals the jobs
+// round robin up front; DYNAMIC hands the next job to whichever instance goes
+// idle first. The port is granted round robin (the instance after the last
+// one granted asks first) or by fixed instance priority.
+// ---------------------------
+enum MultiShard { SHARD_HEADS, SHARD_QUERIES };
+enum MultiSchedule { SCHED_STATIC, SCHED_DYNAMIC };
+enum PortPriority { PORT_ROUND_ROBIN, PORT_FIXED };
+
+struct MultiConfig {
+    int instances = 2;
+    int heads = 12;
+    MultiShard shard = SHARD_HEADS;
+    MultiSchedule schedule = SCHED_DYNAMIC;
+    PortPriority port = PORT_ROUND_ROBIN;
+};
+
+struct MultiInstance {
+    int jobs = 0;
+    int64_t busy = 0;             // cycles with a job, shared memory
+    int64_t isolated = 0;         // the same jobs, each alone with the memory
+    int64_t port_stalls = 0, tag_stalls = 0;
+
+    double slowdown() const { return isolated ? (double)busy / isolated : 1.0; }
+};
+
+struct MultiResult {
+    int64_t makespan = 0;         // cycles until the last job finished
+    int64_t serial = 0;           // every head back to back on one instance
+    int64_t mem_commands = 0;
+    vector<MultiInstance> inst;
+
+    double speedup() const { return makespan ? (double)serial / makespan : 0.0; }
+    double port_utilization() const { return makespan ? (double)mem_commands / makespan : 0.0; }
+    // Jain's index over the per-instance progress rates (1 / slowdown); 1 is perfectly fair
+    double fairness() const {
+        double sum = 0, sq = 0;
+        int n = 0;
+        for (const auto &i : inst)
+            if (i.jobs) {
+                double x = 1.0 / i.slowdown();
+                sum += x, sq += x * x, n++;
+            }
+        return sq ? sum * sum / (n * sq) : 1.0;
+    }
+};
+
+inline MultiResult perf_multi(const PerfConfig &cfg, const MultiConfig &m) {
+    if (m.instances <= 0 || m.heads <= 0) throw runtime_error("Need at least one instance and one head");
+    cfg.validate();
+
+    // the jobs and their cycles alone
+    vector<PerfConfig> jobs;
+    for (int h = 0; h < m.heads; ++h) {
+        if (m.shard == SHARD_HEADS) {
+            jobs.push_back(cfg);
+            continue;
+        }
+        int per = (cfg.q_rows + m.instances - 1) / m.instances;
+        for (int b = 0; b < cfg.q_rows; b += per) {
+            PerfConfig c = cfg;
+            c.q_rows = min(per, cfg.q_rows - b);
+            jobs.push_back(c);
+        }
+    }
+    map<int, int64_t> alone;      // q_rows -> isolated cycles
+    for (const auto &j : jobs)
+        if (!alone.count(j.q_rows)) alone[j.q_rows] = perf_simulate(j).cycles;
+
+    MultiResult res;
+    res.inst.resize(m.instances);
+    res.serial = m.heads * (alone.count(cfg.q_rows) ? alone[cfg.q_rows] : perf_simulate(cfg).cycles);
+
+    vector<deque<int>> queue(m.schedule == SCHED_STATIC ? m.instances : 1);
+    for (int j = 0; j < (int)jobs.size(); ++j) queue[m.schedule == SCHED_STATIC ? j % m.instances : 0].push_back(j);
+
+    PerfMemory mem(cfg.mem_latency, cfg.mem_tags);
+    vector<unique_ptr<PerfSim>> sim(m.instances);
+    vector<int> running(m.instances, -1);
+    vector<int64_t> started(m.instances, 0);
+    size_t finished = 0;
+    int last_grant = m.instances - 1;
+    int64_t total_alone = 0;
+    for (const auto &j : jobs) total_alone += alone[j.q_rows];
+    const int64_t limit = 16 * total_alone + 1024;
+
+    for (int64_t now = 0; finished < jobs.size(); ++now) {
+        if (now > limit) throw runtime_error("Multi-instance model did not finish (deadlock)");
+        const int first = m.port == PORT_ROUND_ROBIN ? (last_grant + 1) % m.instances : 0;
+        for (int k = 0; k < m.instances; ++k) {
+            const int i = (first + k) % m.instances;
+            auto &q = queue[m.schedule == SCHED_STATIC ? i : 0];
+            if (!sim[i] && !q.empty()) {
+                running[i] = q.front();
+                q.pop_front();
+                started[i] = now;
+                sim[i] = make_unique<PerfSim>(jobs[running[i]], &mem, now);
+            }
+            if (!sim[i]) continue;
+            int64_t before = sim[i]->commands();
+            sim[i]->step();
+            if (sim[i]->commands() != before) last_grant = i;
+            if (!sim[i]->finished()) continue;
+
+            PerfResult r = sim[i]->result();
+            MultiInstance &in = res.inst[i];
+            in.jobs++;
+            in.busy += now + 1 - started[i];
+            in.isolated += alone[jobs[running[i]].q_rows];
+            in.port_stalls += r.port_stalls;
+            in.tag_stalls += r.tag_stalls;
+            res.mem_commands += r.mem_loads + r.mem_stores;
+            res.makespan = max(res.makespan, now + 1);
+            sim[i].reset();
+            finished++;
+        }
+    }
+    return res;
+}
+
+#endif // AURA_PERF_H
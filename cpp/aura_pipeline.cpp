@@ -0,0 +1,327 @@
+#include "aura_mem.h"
+#include "aura_model.h"
+#include "aura_reference.h"
+#include "aura_metrics.h"
+#include "aura_cache.h"
+#include "aura_import.h"
+
+#include <fcntl.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+// -----------------------------------------------------
+// End-to-end flow in one process:
+//   convert   : FP32 Q/K/V -> Q0.7            (fp32_to_f8)
+//   reference : FP32/FP64 attention -> Q0.7   (attention_fp32 + fp32_to_f8)
+//   model     : bit-accurate C++ PE model, or build/AURA.simv through temp files
+//   compare   : precision_measure metrics
+// Intermediate .mem files are only written when --dump is given. With --cache DIR
+// (or $AURA_CACHE_DIR) stage outputs are reused across runs by content hash.
+// -----------------------------------------------------
+
+struct Options {
+    string q32, k32, v32;        // FP32 inputs
+    string q, k, v;              // Q0.7 inputs (skip convert)
+    string reference = "";       // fp32 | fp64 (default: fp32 when FP32 inputs exist)
+    string model = "cmodel";     // cmodel | simv | none
+    string simv = "build/AURA.simv";
+    string asic;                 // compare an existing output instead of running a model
+    string expected;             // compare against an existing reference instead of computing it
+    string dump;                 // directory for intermediate .mem files
+    string cache;                // result cache directory (default $AURA_CACHE_DIR)
+    bool no_cache = false;
+    int threads = default_threads();
+    int split_kv = 1;            // K/V partitions per query in the reference
+    HeadLayout heads;            // stacked heads, query heads per K/V head (GQA/MQA)
+    ModelConfig cfg;
+};
+
+static void usage(const char *prog) {
+    cerr << "Usage: " << prog << " [options]\n"
+         << "  --test NAME           inputs from models/NAME/ (Q32/K32/V32.mem, else Q/K/V.mem)\n"
+         << "  --q32 F --k32 F --v32 F   FP32 inputs, converted to Q0.7 in memory: .mem, .bin,\n"
+         << "                        FILE.npy[INDEX] or FILE.safetensors[:TENSOR][INDEX] (aura_import.h)\n"
+         << "  --q F --k F --v F     Q0.7 inputs (no convert stage)\n"
+         << "  --reference fp32|fp64 reference precision (fp32 needs FP32 inputs)\n"
+         << "  --split-kv P          split-KV reference: P partial softmaxes merged by log-sum-exp\n"
+         << "  --q-heads H           Q holds H heads stacked by rows (default 1)\n"
+         << "  --kv-heads N          K/V hold N heads, each shared by H/N query heads\n"
+         << "                        (default H; 1 is multi-query attention)\n"
+         << "  --expected F          use an existing Q0.7 reference (e.g. O_fixed_correct.mem)\n"
+         << "  --model cmodel|simv|none  implementation under test (default cmodel)\n"
+         << "  --simv PATH           simulator executable for --model simv\n"
+         << "  --asic F              compare an existing Q0.7 output (e.g. O_cleaned.mem)\n"
+         << "  --guard-bits N        extra Log2Exp fraction bits in the C++ model (default 0)\n"
+         << "  --recip-bits P        normalise with a P-bit reciprocal per row instead of int_division\n"
+         << "  --dump DIR            write the intermediate .mem files to DIR\n"
+         << "  --cache DIR           reuse stage outputs from DIR (default $AURA_CACHE_DIR)\n"
+         << "  --no-cache            always recompute\n"
+         << "  -j N                  worker threads (default " << default_threads() << ")\n";
+}
+
+static Options parse_args(int argc, char **argv) {
+    Options o;
+    auto need = [&](int &i) -> string {
+        if (i + 1 >= argc) throw runtime_error(string("Missing value for ") + argv[i]);
+        return argv[++i];
+    };
+    auto exists = [](const string &f) { return access(f.c_str(), R_OK) == 0; };
+    int kv_heads = 0;  // default: one K/V head per query head
+
+    for (int i = 1; i < argc; ++i) {
+        string a = argv[i];
+        if (a == "--test") {
+            string dir = "models/" + need(i) + "/";
+            if (exists(dir + "Q32.mem")) {
+                o.q32 = dir + "Q32.mem"; o.k32 = dir + "K32.mem"; o.v32 = dir + "V32.mem";
+            } else {
+                o.q = dir + "Q.mem"; o.k = dir + "K.mem"; o.v = dir + "V.mem";
+            }
+        }
+        else if (a == "--q32") o.q32 = need(i);
+        else if (a == "--k32") o.k32 = need(i);
+        else if (a == "--v32") o.v32 = need(i);
+        else if (a == "--q") o.q = need(i);
+        else if (a == "--k") o.k = need(i);
+        else if (a == "--v") o.v = need(i);
+        else if (a == "--reference") o.reference = need(i);
+        else if (a == "--expected") o.expected = need(i);
+        else if (a == "--split-kv") o.split_kv = max(1, stoi(need(i)));
+        else if (a == "--q-heads") o.heads.q_heads = stoi(need(i));
+        else if (a == "--kv-heads") kv_heads = stoi(need(i));
+        else if (a == "--model") o.model = need(i);
+        else if (a == "--simv") o.simv = need(i);
+        else if (a == "--asic") o.asic = need(i);
+        else if (a == "--guard-bits") o.cfg.log2e_guard_bits = stoi(need(i));
+        else if (a == "--recip-bits") o.cfg.recip_bits = stoi(need(i));
+        else if (a == "--dump") o.dump = need(i);
+        else if (a == "--cache") o.cache = need(i);
+        else if (a == "--no-cache") o.no_cache = true;
+        else if (a == "-j") o.threads = max(1, stoi(need(i)));
+        else throw runtime_error("Unknown option " + a);
+    }
+
+    if (kv_heads == 0) kv_heads = o.heads.q_heads;
+    o.heads.kv_heads = kv_heads;
+
+    bool have32 = !o.q32.empty() && !o.k32.empty() && !o.v32.empty();
+    bool have8 = !o.q.empty() && !o.k.empty() && !o.v.empty();
+    if (!have32 && !have8) throw runtime_error("No Q/K/V inputs given");
+    if (o.reference.empty()) o.reference = have32 ? "fp32" : "fp64";
+    if (o.reference != "fp32" && o.reference != "fp64")
+        throw runtime_error("Unknown reference " + o.reference);
+    if (o.reference == "fp32" && !have32 && o.expected.empty())
+        throw runtime_error("--reference fp32 needs FP32 inputs");
+    if (o.model != "cmodel" && o.model != "simv" && o.model != "none")
+        throw runtime_error("Unknown model " + o.model);
+    o.cfg.derive();
+    return o;
+}
+
+// -----------------------------------------------------
+// simv through temp files (the same plusargs as 'make output/%.out')
+// -----------------------------------------------------
+static vector<int8_t> run_simv(const Options &o, const vector<int8_t> &Q,
+                               const vector<int8_t> &K, const vector<int8_t> &V) {
+    char tmpl[] = "/tmp/aura_pipeline.XXXXXX";
+    if (!mkdtemp(tmpl)) throw runtime_error("Cannot create temp directory");
+    string dir = tmpl;
+    write_int8_mem(dir + "/Q.mem", Q);
+    write_int8_mem(dir + "/K.mem", K);
+    write_int8_mem(dir + "/V.mem", V);
+
+    // no shell: the paths go to simv as they are, its stdout to O.log
+    const string log = dir + "/O.log";
+    vector<string> args = {o.simv, "+Q_MEMORY=" + dir + "/Q.mem", "+K_MEMORY=" + dir + "/K.mem",
+                           "+V_MEMORY=" + dir + "/V.mem", "+OUTPUT=" + dir + "/O"};
+    vector<char *> argv;
+    for (auto &a : args) argv.push_back(&a[0]);
+    argv.push_back(nullptr);
+    cerr << "Running " << o.simv << " (log " << log << ")\n";
+    int fd = open(log.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    if (fd < 0) throw runtime_error("Cannot open for writing " + log);
+    pid_t pid = fork();
+    if (pid == 0) {
+        dup2(fd, STDOUT_FILENO);
+        execvp(argv[0], argv.data());
+        _exit(127);
+    }
+    close(fd);
+    int status = 0;
+    if (pid < 0) throw runtime_error("Cannot start " + o.simv);
+    if (waitpid(pid, &status, 0) < 0 || !WIFEXITED(status) || WEXITSTATUS(status) != 0)
+        throw runtime_error("simv failed (" +
+                            (WIFEXITED(status) ? "exit " + to_string(WEXITSTATUS(status)) : string("killed")) +
+                            "), see " + log);
+
+    // strip_out_file.py: first 16 digit hex token of each line
+    string text = read_file(dir + "/O.out"), cleaned;
+    static const regex hex16("\\b([0-9a-fA-F]{16})\\b");
+    istringstream lines(text);
+    for (string line; getline(lines, line);) {
+        smatch m;
+        if (regex_search(line, m, hex16)) cleaned += m.str(1) + "\n";
+    }
+    {
+        ofstream fout(dir + "/O_cleaned.mem");
+        fout << cleaned;
+        fout.close();
+        if (!fout) throw runtime_error("Cannot write " + dir + "/O_cleaned.mem");
+    }
+    auto O = read_int8_mem(dir + "/O_cleaned.mem");
+    error_code ec;
+    filesystem::remove_all(dir, ec);
+    if (ec) cerr << "WARNING: Cannot remove " << dir << ": " << ec.message() << "\n";
+    return O;
+}
+
+// -----------------------------------------------------
+// main
+// -----------------------------------------------------
+int main(int argc, char **argv) {
+    stats_init(argc, argv);
+    ios::sync_with_stdio(false);
+
+    if (argc < 2) {
+        usage(argv[0]);
+        return 1;
+    }
+
+    try {
+        Options o = parse_args(argc, argv);
+        auto dump = [&](const string &name, const auto &data) {
+            if (o.dump.empty()) return;
+            string path = o.dump + "/" + name;
+            if constexpr (is_same_v<decay_t<decltype(data)>, vector<float>>) write_fp32_mem(path, data);
+            else write_int8_mem(path, data);
+            cerr << "Wrote " << path << "\n";
+        };
+        if (!o.dump.empty()) {
+            error_code ec;
+            filesystem::create_directories(o.dump, ec);
+            if (ec) throw runtime_error("Cannot create " + o.dump + ": " + ec.message());
+        }
+        ResultCache cache(o.cache, !o.no_cache);
+
+        // ---- convert ----
+        vector<float> Q32, K32, V32;
+        vector<int8_t> Q, K, V;
+        if (!o.q32.empty()) {
+            StatScope scope("convert");
+            Q32 = read_fp32_input(o.q32);
+            K32 = read_fp32_input(o.k32);
+            V32 = read_fp32_input(o.v32);
+            Q = quantize_q07(Q32);
+            K = quantize_q07(K32);
+            V = quantize_q07(V32);
+            dump("Q.mem", Q);
+            dump("K.mem", K);
+            dump("V.mem", V);
+        } else {
+            StatScope scope("read");
+            Q = read_int8_mem(o.q);
+            K = read_int8_mem(o.k);
+            V = read_int8_mem(o.v);
+        }
+        if (K.size() != V.size()) throw runtime_error("K and V have different sizes");
+        o.heads.validate(Q.size(), K.size(), AURA_DK);
+        if (!o.heads.single())
+            cerr << o.heads.q_heads << " query heads, " << o.heads.kv_heads << " K/V heads (group "
+                 << o.heads.group() << ")\n";
+        // every stage below runs once per query head against its shared K/V head
+        auto by_head = [&](const auto &q, const auto &k, const auto &v, auto attend) {
+            return attention_by_head(q, k, v, o.heads, AURA_DK, attend);
+        };
+        auto add_heads = [&](CacheKey &key) {
+            if (!o.heads.single()) key.add(o.heads.q_heads).add(o.heads.kv_heads);
+        };
+
+        // ---- reference ----
+        vector<int8_t> O_ref;
+        if (!o.expected.empty()) {
+            O_ref = read_int8_mem(o.expected);
+        } else {
+            StatScope scope(o.reference == "fp32" ? "reference fp32" : "reference fp64");
+            if (o.reference == "fp32") {
+                CacheKey key(o.split_kv > 1 ? "reference_fp32_split" : "reference_fp32");
+                if (o.split_kv > 1) key.add(o.split_kv);
+                add_heads(key);
+                key.add(Q32).add(K32).add(V32);
+                auto O_float = cache.get_or_compute<float>(key, [&] {
+                    return by_head(Q32, K32, V32, [&](const vector<float> &q, const vector<float> &k,
+                                                      const vector<float> &v) {
+                        if (o.split_kv > 1)
+                            return reference_attention_split(q, k, v, o.split_kv, AURA_DK, o.threads);
+                        return reference_attention(q, k, v, AURA_DK, o.threads);
+                    });
+                });
+                dump("O_float_correct.mem", O_float);
+                O_ref = quantize_q07(O_float);
+            } else {
+                CacheKey key("reference_fp64");
+                key.add(o.split_kv);
+                add_heads(key);
+                key.add(Q).add(K).add(V);
+                O_ref = cache.get_or_compute<int8_t>(key, [&] {
+                    auto Qd = dequantize_q07<double>(Q), Kd = dequantize_q07<double>(K),
+                         Vd = dequantize_q07<double>(V);
+                    return quantize_q07(by_head(Qd, Kd, Vd, [&](const vector<double> &q,
+                                                                 const vector<double> &k,
+                                                                 const vector<double> &v) {
+                        return o.split_kv > 1
+                            ? reference_attention_split(q, k, v, o.split_kv, AURA_DK, o.threads)
+                            : reference_attention(q, k, v, AURA_DK, o.threads);
+                    }));
+                });
+            }
+            dump("O_fixed_correct.mem", O_ref);
+        }
+
+        // ---- model ----
+        vector<int8_t> O_asic;
+        if (!o.asic.empty()) {
+            O_asic = read_int8_mem(o.asic);
+        } else if (o.model == "cmodel") {
+            StatScope scope("model cmodel");
+            CacheKey key("cmodel");
+            key.add(o.cfg.signature());
+            add_heads(key);
+            key.add(Q).add(K).add(V);
+            O_asic = cache.get_or_compute<int8_t>(key, [&] {
+                return model_attention_gqa(Q, K, V, o.heads, o.cfg, o.threads);
+            });
+            dump("O_cleaned.mem", O_asic);
+        } else if (o.model == "simv") {
+            StatScope scope("model simv");
+            struct stat st {};
+            stat(o.simv.c_str(), &st);
+            CacheKey key("simv");
+            key.add(o.simv).add((int64_t)st.st_mtime).add((int64_t)st.st_size);
+            add_heads(key);
+            key.add(Q).add(K).add(V);
+            O_asic = cache.get_or_compute<int8_t>(key, [&] {
+                return by_head(Q, K, V, [&](const vector<int8_t> &q, const vector<int8_t> &k,
+                                            const vector<int8_t> &v) { return run_simv(o, q, k, v); });
+            });
+            dump("O_cleaned.mem", O_asic);
+        } else {
+            return 0;
+        }
+
+        // ---- compare ----
+        CacheKey key("metrics");
+        key.add(O_ref).add(O_asic);
+        Metrics m = cache.get_or_compute<Metrics>(key, [&] {
+            return vector<Metrics>{compare_outputs(O_ref, O_asic)};
+        })[0];
+        print_metrics(cout, m);
+        cout << "Overall       : " << (m.passed() ? "PASS" : "FAIL") << "\n";
+        if (cache.enabled())
+            cerr << "[cache] " << cache.hits() << " hits, " << cache.misses() << " misses\n";
+
+    } catch (const exception &e) {
+        cerr << "ERROR: " << e.what() << "\n";
+        return 1;
+    }
+    return 0;
+}
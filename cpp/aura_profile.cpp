@@ -0,0 +1,229 @@
+#include "aura_mem.h"
+#include "aura_model.h"
+
+// -----------------------------------------------------
+// Value-range profile of every intermediate Q-format of the PE datapath.
+//
+// Runs the bit-accurate model over a corpus of Q/K/V cases with the range
+// probes enabled (ModelConfig::profile, one RangeProfile per thread) and
+// reports per format:
+//   range     : observed min / max in real units
+//   sat       : values outside the current format (saturated or wrapped)
+//   LSB used  : share of non-zero values with the lowest fraction bit set
+//   I / F     : the fewest integer bits with at most --target of the values
+//               saturating, and the fewest fraction bits that lose nothing
+//               (low bits that are zero in every value)
+// --check reruns the model with the recommended integer widths and counts
+// the output elements that change.
+// -----------------------------------------------------
+
+struct ProfileOptions {
+    vector<string> tests;
+    string models = "models";
+    double target = 0;   // tolerated saturation rate
+    bool histogram = false, check = false, help = false;
+    int threads = default_threads();
+    ModelConfig cfg;
+};
+
+static void usage(const char *prog) {
+    cerr << "Usage: " << prog << " [options]\n"
+         << "  --test NAME           add models/NAME/ (repeatable; default every case under --models)\n"
+         << "  --models DIR          case root (default models)\n"
+         << "  --guard-bits N        extra Log2Exp fraction bits (default 0)\n"
+         << "  --target R            tolerated saturation rate for the integer bits (default 0)\n"
+         << "  --histogram           print the magnitude histogram of every format\n"
+         << "  --check               rerun with the recommended integer bits and compare outputs\n"
+         << "  -j N                  worker threads (default " << default_threads() << ")\n";
+}
+
+static ProfileOptions parse_args(int argc, char **argv) {
+    ProfileOptions o;
+    auto need = [&](int &i) -> string {
+        if (i + 1 >= argc) throw runtime_error(string("Missing value for ") + argv[i]);
+        return argv[++i];
+    };
+    for (int i = 1; i < argc; ++i) {
+        string a = argv[i];
+        if (a == "--test") o.tests.push_back(need(i));
+        else if (a == "--models") o.models = need(i);
+        else if (a == "--guard-bits") o.cfg.log2e_guard_bits = parse_int(need(i));
+        else if (a == "--target") o.target = max(0.0, parse_double(need(i)));
+        else if (a == "--histogram") o.histogram = true;
+        else if (a == "--check") o.check = true;
+        else if (a == "-j") o.threads = max(1, parse_int(need(i)));
+        else if (a == "-h" || a == "--help") {
+            o.help = true;
+            return o;
+        }
+        else throw runtime_error("Unknown option " + a);
+    }
+    if (o.tests.empty()) o.tests = discover_tests(o.models);
+    if (o.tests.empty()) throw runtime_error("No cases under " + o.models);
+    o.cfg.derive();
+    return o;
+}
+
+// -----------------------------------------------------
+// Probe points and the formats they land in
+// -----------------------------------------------------
+static const char *probe_name(int p) {
+    static const char *names[NUM_PROBES] = {
+        "INTERMEDIATE_PRODUCT_QT", "DOT_QT", "EXPMUL_DIFF_IN_QT", "EXPMUL_EXP_QT",
+        "EXPMUL_SHIFT_STAGE_QT", "EXPMUL_VEC_QT", "DIV_INPUT_QT"};
+    return names[p];
+}
+
+static QFormat &probe_format(ModelConfig &cfg, int p) {
+    switch (p) {
+    case PROBE_INTERMEDIATE_PRODUCT: return cfg.intermediate_product;
+    case PROBE_DOT: return cfg.dot;
+    case PROBE_EXPMUL_DIFF_IN: return cfg.expmul_diff_in;
+    case PROBE_EXPMUL_EXP: return cfg.expmul_exp;
+    case PROBE_EXPMUL_SHIFT_STAGE: return cfg.expmul_shift_stage;
+    case PROBE_EXPMUL_VEC: return cfg.expmul_vec;
+    default: return cfg.div_input;
+    }
+}
+
+static string qname(QFormat f) { return "Q" + to_string(f.i) + "." + to_string(f.f); }
+
+// values that do not fit in i integer bits (plus sign) at f fraction bits
+static uint64_t saturating(const RangeStats &s, int i, int f) {
+    uint64_t n = 0;
+    for (int b = max(0, i + f + 1); b < 64; ++b) n += s.mag_bits[b];
+    return n;
+}
+
+struct Recommendation {
+    int i = 0, f = 0;
+};
+
+static Recommendation recommend(const RangeStats &s, QFormat cur, double target) {
+    Recommendation r;
+    const uint64_t allowed = (uint64_t)floor(target * s.count);
+    r.i = -cur.f;  // an all-zero (or nearly all-zero) format needs no integer bits
+    while (r.i < 62 - cur.f && saturating(s, r.i, cur.f) > allowed) ++r.i;
+    r.i = max(r.i, 0);
+    int low = 0;  // fraction bits that are zero in every value
+    while (low < cur.f && s.low_zeros[low] == 0) ++low;
+    r.f = s.count > s.zeros ? cur.f - low : 0;
+    return r;
+}
+
+// -----------------------------------------------------
+// Corpus run
+// -----------------------------------------------------
+struct Case {
+    string name;
+    vector<int8_t> Q, K, V;
+};
+
+static Case load_case(const ProfileOptions &o, const string &name) {
+    Case c{name, {}, {}, {}};
+    CaseInputs in = read_case(o.models, name);
+    c.Q = std::move(in.Q), c.K = std::move(in.K), c.V = std::move(in.V);
+    return c;
+}
+
+// Model outputs of every case; rows interleaved over the threads, each with its own profile
+static vector<vector<int8_t>> run_corpus(const vector<Case> &cases, const ModelConfig &cfg, int threads,
+                                         RangeProfile *merged) {
+    vector<vector<int8_t>> outs;
+    vector<RangeProfile> profiles(merged ? threads : 0);
+    for (const auto &c : cases) {
+        const int D = cfg.embedding_dim, rows = (int)(c.Q.size() / D), rows_kv = (int)(c.K.size() / D);
+        vector<int8_t> O(c.Q.size());
+        MatrixView<const int8_t> K(c.K, D), V(c.V, D);
+        parallel_rows(threads, threads, [&](int t) {
+            ModelConfig local = cfg;
+            local.profile = merged ? &profiles[t] : nullptr;
+            for (int i = t; i < rows; i += threads)
+                model_attention_row(&c.Q[(size_t)i * D], K, V, rows_kv, &O[(size_t)i * D], local);
+        });
+        outs.push_back(std::move(O));
+    }
+    if (merged)
+        for (auto &p : profiles) merged->merge(p);
+    return outs;
+}
+
+static void print_histogram(const RangeStats &s, QFormat cur) {
+    cout << "  bits  values        (sign excluded; > " << cur.i + cur.f << " saturates)\n";
+    for (int b = 0; b < 64; ++b)
+        if (s.mag_bits[b])
+            cout << "  " << setw(4) << b << "  " << setw(12) << s.mag_bits[b] << "  "
+                 << string((size_t)ceil(40.0 * s.mag_bits[b] / s.count), '#') << "\n";
+}
+
+int main(int argc, char **argv) {
+    stats_init(argc, argv);
+    ios::sync_with_stdio(false);
+
+    ProfileOptions o;
+    try {
+        o = parse_args(argc, argv);
+    } catch (const exception &e) {
+        cerr << "ERROR: " << e.what() << "\n";
+        return 1;
+    }
+    if (o.help) {
+        usage(argv[0]);
+        return 0;
+    }
+
+    try {
+        vector<Case> cases;
+        for (const auto &t : o.tests) cases.push_back(load_case(o, t));
+
+        RangeProfile profile;
+        auto t0 = chrono::steady_clock::now();
+        auto baseline = run_corpus(cases, o.cfg, o.threads, &profile);
+        double secs = chrono::duration<double>(chrono::steady_clock::now() - t0).count();
+
+        cout << "===== Q-format Range Profile =====\n";
+        cout << "Corpus        : ";
+        for (size_t i = 0; i < o.tests.size(); ++i) cout << (i ? ", " : "") << o.tests[i];
+        cout << "\nModel         : " << o.cfg.signature() << ", " << fixed << setprecision(2) << secs
+             << " s profiled\n" << defaultfloat;
+        cout << "Target        : saturation rate <= " << o.target << "\n\n";
+
+        cout << left << setw(25) << "format" << setw(9) << "current" << setw(28) << "range" << setw(14)
+             << "values" << setw(11) << "sat" << setw(10) << "LSB used" << setw(11) << "recommend"
+             << "bits saved\n";
+        ModelConfig narrowed = o.cfg;
+        for (int p = 0; p < NUM_PROBES; ++p) {
+            const RangeStats &s = profile.at[p];
+            QFormat cur = probe_format(o.cfg, p);
+            Recommendation r = recommend(s, cur, o.target);
+            QFormat rec{r.i, r.f};
+            probe_format(narrowed, p).i = r.i;
+
+            stringstream range;
+            if (s.count)
+                range << "[" << ldexp((double)s.min, -cur.f) << ", " << ldexp((double)s.max, -cur.f) << "]";
+            uint64_t nonzero = s.count - s.zeros;
+            cout << left << setw(25) << probe_name(p) << setw(9) << qname(cur) << setw(28) << range.str()
+                 << setw(14) << s.count << setw(11) << saturating(s, cur.i, cur.f) << setprecision(3)
+                 << setw(10) << (nonzero ? (double)s.low_zeros[0] / nonzero : 0.0) << setw(11) << qname(rec)
+                 << cur.width() - rec.width() << "\n" << setprecision(6);
+            if (o.histogram) print_histogram(s, cur);
+        }
+
+        if (o.check) {
+            auto outs = run_corpus(cases, narrowed, o.threads, nullptr);
+            size_t changed = 0, total = 0;
+            for (size_t c = 0; c < outs.size(); ++c) {
+                total += outs[c].size();
+                for (size_t e = 0; e < outs[c].size(); ++e) changed += outs[c][e] != baseline[c][e];
+            }
+            cout << "\nCheck (recommended integer bits, current fraction bits): " << changed << " of "
+                 << total << " output elements change\n";
+        }
+
+    } catch (const exception &e) {
+        cerr << "ERROR: " << e.what() << "\n";
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,196 @@
+#include "aura_mem.h"
+#include "aura_model.h"
+#include "aura_reference.h"
+#include "aura_metrics.h"
+#include "aura_perf.h"
+
+// -----------------------------------------------------
+// Reciprocal-multiply normalisation against vector_division.sv.
+//
+// vector_division.sv runs one int_division per output element although all
+// of them share the denominator o*[0]. The alternative computes one
+// reciprocal per row (LUT seed + Newton-Raphson, ModelConfig::recip_*) and
+// scales o*[1..d] with one multiply each. For every combination of --bits,
+// --seed and --iters this reports over the corpus:
+//   changed   : output elements that differ from the division path
+//   max diff  : largest such difference in LSB
+//   MAE       : against the fp64 attention of the Q0.7 inputs (the division
+//               path is on the first line)
+// and from the performance model the normalisation latency, the cycles of a
+// full 512 x 512 pass and of one decode token over a resident cache.
+// -----------------------------------------------------
+
+struct RecipOptions {
+    vector<string> tests;
+    string models = "models";
+    vector<int> bits = {10, 12, 16, 20}, seeds = {6}, iters = {0, 1, 2};
+    int threads = default_threads();
+    bool help = false;
+    ModelConfig cfg;
+};
+
+static void usage(const char *prog) {
+    cerr << "Usage: " << prog << " [options]\n"
+         << "  --test NAME           add models/NAME/ (repeatable; default every case under --models)\n"
+         << "  --models DIR          case root (default models)\n"
+         << "  --guard-bits N        extra Log2Exp fraction bits (default 0)\n"
+         << "  --bits LIST           reciprocal fraction bits (default 10,12,16,20)\n"
+         << "  --seed LIST           LUT seed index bits (default 6)\n"
+         << "  --iters LIST          Newton-Raphson steps (default 0,1,2)\n"
+         << "  -j N                  worker threads (default " << default_threads() << ")\n";
+}
+
+static RecipOptions parse_args(int argc, char **argv) {
+    RecipOptions o;
+    auto need = [&](int &i) -> string {
+        if (i + 1 >= argc) throw runtime_error(string("Missing value for ") + argv[i]);
+        return argv[++i];
+    };
+    for (int i = 1; i < argc; ++i) {
+        string a = argv[i];
+        if (a == "--test") o.tests.push_back(need(i));
+        else if (a == "--models") o.models = need(i);
+        else if (a == "--guard-bits") o.cfg.log2e_guard_bits = parse_int(need(i));
+        else if (a == "--bits") o.bits = parse_list(need(i));
+        else if (a == "--seed") o.seeds = parse_list(need(i));
+        else if (a == "--iters") o.iters = parse_list(need(i));
+        else if (a == "-j") o.threads = max(1, parse_int(need(i)));
+        else if (a == "-h" || a == "--help") {
+            o.help = true;
+            return o;
+        }
+        else throw runtime_error("Unknown option " + a);
+    }
+    if (o.tests.empty()) o.tests = discover_tests(o.models);
+    if (o.tests.empty()) throw runtime_error("No cases under " + o.models);
+    o.cfg.derive();
+    return o;
+}
+
+struct Case {
+    string name;
+    vector<int8_t> Q, K, V, O_ref;
+};
+
+static Case load_case(const RecipOptions &o, const string &name) {
+    Case c{name, {}, {}, {}, {}};
+    CaseInputs in = read_case(o.models, name);
+    c.Q = std::move(in.Q), c.K = std::move(in.K), c.V = std::move(in.V);
+    c.O_ref = quantize_q07(reference_attention(dequantize_q07<double>(c.Q), dequantize_q07<double>(c.K),
+                                               dequantize_q07<double>(c.V), AURA_DK, o.threads));
+    return c;
+}
+
+// Corpus-wide comparison of one configuration
+struct RecipResult {
+    size_t changed = 0, total = 0;
+    int max_diff = 0;
+    double mae = 0;   // against the fp64 reference, element-weighted over the corpus
+    double secs = 0;
+};
+
+static RecipResult evaluate(const vector<Case> &cases, const vector<vector<int8_t>> &division,
+                            const ModelConfig &cfg, int threads) {
+    RecipResult r;
+    double err = 0;
+    for (size_t c = 0; c < cases.size(); ++c) {
+        auto t0 = chrono::steady_clock::now();
+        auto O = model_attention(cases[c].Q, cases[c].K, cases[c].V, cfg, threads);
+        r.secs += chrono::duration<double>(chrono::steady_clock::now() - t0).count();
+        for (size_t e = 0; e < O.size(); ++e) {
+            int d = abs(O[e] - division[c][e]);
+            r.changed += d != 0;
+            r.max_diff = max(r.max_diff, d);
+        }
+        err += compare_outputs(cases[c].O_ref, O).mae * O.size();
+        r.total += O.size();
+    }
+    r.mae = err / r.total;
+    return r;
+}
+
+int main(int argc, char **argv) {
+    stats_init(argc, argv);
+    ios::sync_with_stdio(false);
+
+    RecipOptions o;
+    try {
+        o = parse_args(argc, argv);
+    } catch (const exception &e) {
+        cerr << "ERROR: " << e.what() << "\n";
+        return 1;
+    }
+    if (o.help) {
+        usage(argv[0]);
+        return 0;
+    }
+
+    try {
+        vector<Case> cases;
+        for (const auto &t : o.tests) cases.push_back(load_case(o, t));
+
+        vector<vector<int8_t>> division;
+        auto t0 = chrono::steady_clock::now();
+        for (const auto &c : cases) division.push_back(model_attention(c.Q, c.K, c.V, o.cfg, o.threads));
+        double div_secs = chrono::duration<double>(chrono::steady_clock::now() - t0).count();
+        RecipResult base = evaluate(cases, division, o.cfg, o.threads);
+
+        cout << "===== Reciprocal Normalisation =====\n";
+        cout << "Corpus        : ";
+        for (size_t i = 0; i < o.tests.size(); ++i) cout << (i ? ", " : "") << o.tests[i];
+        cout << "\nModel         : " << o.cfg.signature() << ", DIV_INPUT_QT Q" << o.cfg.div_input.i << "."
+             << o.cfg.div_input.f << "\n";
+        cout << "Reference     : fp64 attention of the Q0.7 inputs\n\n";
+
+        cout << left << setw(16) << "normalisation" << setw(6) << "bits" << setw(6) << "seed" << setw(7)
+             << "iters" << setw(12) << "changed" << setw(10) << "max diff" << setw(10) << "MAE"
+             << "model (s)\n";
+        cout << left << setw(16) << "int_division" << setw(6) << "-" << setw(6) << "-" << setw(7) << "-"
+             << setw(12) << 0 << setw(10) << 0 << fixed << setprecision(5) << setw(10) << base.mae
+             << setprecision(3) << div_secs << "\n" << defaultfloat;
+        for (int b : o.bits)
+            for (int s : o.seeds)
+                for (int it : o.iters) {
+                    ModelConfig cfg = o.cfg;
+                    cfg.recip_bits = b;
+                    cfg.recip_seed_bits = s;
+                    cfg.recip_iterations = it;
+                    cfg.derive();
+                    RecipResult r = evaluate(cases, division, cfg, o.threads);
+                    cout << left << setw(16) << "reciprocal" << setw(6) << b << setw(6) << s << setw(7) << it
+                         << setw(12) << r.changed << setw(10) << r.max_diff << fixed << setprecision(5)
+                         << setw(10) << r.mae << setprecision(3) << r.secs << "\n" << defaultfloat;
+                }
+        cout << "(" << base.total << " output elements)\n";
+
+        // performance model: the normalisation sits at the end of every tile
+        PerfConfig pc;
+        const int W = o.cfg.div_input.width() - 1;
+        cout << "\nPerformance model (" << pc.num_pes << " PEs, " << pc.seq_len << " x " << pc.q_rows
+             << " prefill; one decode token with " << AURA_SEQ - 1 << " rows resident)\n";
+        cout << left << setw(16) << "normalisation" << setw(7) << "iters" << setw(10) << "latency"
+             << setw(12) << "prefill" << setw(10) << "saved" << setw(12) << "decode" << setw(10) << "saved"
+             << "hardware per PE\n";
+        PerfResult div_full = perf_simulate(pc);
+        double div_tok = perf_decode(pc, AURA_SEQ - 1, 1, AURA_SEQ, true).mean();
+        cout << left << setw(16) << "int_division" << setw(7) << "-" << setw(10) << pc.norm_latency()
+             << setw(12) << div_full.cycles << setw(10) << 0 << setw(12) << div_tok << setw(10) << 0
+             << o.cfg.embedding_dim << " x int_division (" << W + o.cfg.div_input.f << " iterations)\n";
+        for (int it : o.iters) {
+            PerfConfig c = pc;
+            c.recip_norm = true;
+            c.recip_iterations = it;
+            PerfResult r = perf_simulate(c);
+            double tok = perf_decode(c, AURA_SEQ - 1, 1, AURA_SEQ, true).mean();
+            cout << left << setw(16) << "reciprocal" << setw(7) << it << setw(10) << c.norm_latency()
+                 << setw(12) << r.cycles << setw(10) << div_full.cycles - r.cycles << setw(12) << tok
+                 << setw(10) << div_tok - tok << "1 seed LUT + " << 2 * it + o.cfg.embedding_dim
+                 << " multipliers\n";
+        }
+
+    } catch (const exception &e) {
+        cerr << "ERROR: " << e.what() << "\n";
+        return 1;
+    }
+    return 0;
+}
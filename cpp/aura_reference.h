@@ -0,0 +1,165 @@
+// Floating point attention references.
+//
+// reference_attention<float> reproduces attention_fp32.cpp (the O_float_correct.mem
+// generator) operation for operation, and reference_attention<double> reproduces
+// generate_output_fp64.cpp, so both can run in-process without changing results.
+
+#ifndef AURA_REFERENCE_H
+#define AURA_REFERENCE_H
+
+#include "aura_matrix.h"
+
+// softmax(q K^T / sqrt(dk)) V for one query row; kv(j) returns the {k, v}
+// row pointers of the j-th K/V row (contiguous tensors or a ring KV cache)
+template <class T, class KV>
+void reference_attention_row_kv(const T *q, int rows_kv, KV kv, int dk, T *out) {
+    const double scale = 1.0 / sqrt((double)dk);
+    ScratchScope scratch;
+    T *scores = scratch.alloc<T>(rows_kv);
+
+    T max_score = -numeric_limits<T>::infinity();
+    for (int j = 0; j < rows_kv; ++j) {
+        const T *k = kv(j).first;
+        T dot = 0;
+        for (int d = 0; d < dk; ++d) dot += q[d] * k[d];
+        T s = dot * scale;
+        scores[j] = s;
+        max_score = max(max_score, s);
+    }
+
+    T sumexp = 0;
+    for (int j = 0; j < rows_kv; ++j) {
+        T e = exp(scores[j] - max_score);
+        scores[j] = e;
+        sumexp += e;
+    }
+    if (sumexp == T(0)) sumexp = T(1e-12);
+    for (int j = 0; j < rows_kv; ++j) scores[j] /= sumexp;
+
+    fill(out, out + dk, T(0));
+    for (int j = 0; j < rows_kv; ++j) {
+        const T *v = kv(j).second;
+        for (int d = 0; d < dk; ++d) out[d] += scores[j] * v[d];
+    }
+}
+
+template <class T>
+void reference_attention_row(const T *q, MatrixView<const T> K, MatrixView<const T> V, int rows_kv,
+                             T *out) {
+    reference_attention_row_kv(q, rows_kv, [&](int j) {
+        return pair<const T *, const T *>(K.row(j), V.row(j));
+    }, (int)K.cols, out);
+}
+
+template <class T>
+void reference_attention_row(const T *q, const T *K, const T *V, int rows_kv, int dk, T *out) {
+    reference_attention_row(q, MatrixView<const T>(K, rows_kv, dk), MatrixView<const T>(V, rows_kv, dk),
+                            rows_kv, out);
+}
+
+// O = attention(Q, K, V) over views with any row stride
+template <class T>
+void reference_attention(MatrixView<const T> Q, MatrixView<const T> K, MatrixView<const T> V,
+                         MatrixView<T> O, int threads = 1) {
+    if (K.rows != V.rows || K.cols != V.cols || Q.cols != K.cols)
+        throw runtime_error("Q/K/V shapes do not match");
+    if (O.rows != Q.rows || O.cols != Q.cols) throw runtime_error("Output shape does not match Q");
+    StatScope scope("reference");
+    stats_count(STAT_ROWS, Q.rows);
+    parallel_rows((int)Q.rows, threads, [&](int i) {
+        reference_attention_row(Q.row(i), K, V, (int)K.rows, O.row(i));
+    });
+}
+
+// Q is rows_q x dk, K and V are rows_kv x dk, all row-major
+template <class T>
+vector<T> reference_attention(const vector<T> &Q, const vector<T> &K, const vector<T> &V,
+                              int dk = AURA_DK, int threads = 1) {
+    if (V.size() != K.size()) throw runtime_error("K and V have different sizes");
+    vector<T> O(Q.size());
+    reference_attention<T>(MatrixView<const T>(Q, dk), MatrixView<const T>(K, dk),
+                           MatrixView<const T>(V, dk), MatrixView<T>(O, dk), threads);
+    return O;
+}
+
+// Grouped-query / multi-query attention over head-major Q/K/V (see HeadLayout)
+template <class T>
+vector<T> reference_attention_gqa(const vector<T> &Q, const vector<T> &K, const vector<T> &V,
+                                  const HeadLayout &heads, int dk = AURA_DK, int threads = 1) {
+    return attention_by_head(Q, K, V, heads, dk, [&](const vector<T> &q, const vector<T> &k,
+                                                     const vector<T> &v) {
+        return reference_attention(q, k, v, dk, threads);
+    });
+}
+
+// ---------------------------
+// Split-KV (flash-decoding) reference
+// ---------------------------
+// Each K/V partition produces the same (m, o*) pair the PE accumulates in
+// expmul.sv: o*[0] is the sum of e^(s_j - m) and o*[1..dk] the weighted V sum.
+template <class T>
+void reference_partial(const T *q, const T *K, const T *V, int begin, int end, int dk,
+                       T &m, T *o_star) {
+    const double scale = 1.0 / sqrt((double)dk);
+    m = -numeric_limits<T>::infinity();
+    fill(o_star, o_star + dk + 1, T(0));
+    for (int j = begin; j < end; ++j) {
+        const T *k = K + (size_t)j * dk;
+        const T *v = V + (size_t)j * dk;
+        T dot = 0;
+        for (int d = 0; d < dk; ++d) dot += q[d] * k[d];
+        T s = dot * scale;
+        T m_new = max(m, s);
+        T corr = exp(m - m_new), p = exp(s - m_new);
+        o_star[0] = o_star[0] * corr + p;
+        for (int d = 0; d < dk; ++d) o_star[d + 1] = o_star[d + 1] * corr + p * v[d];
+        m = m_new;
+    }
+}
+
+// log-sum-exp merge: o* = sum_p o*_p * e^(m_p - max_p m_p)
+template <class T>
+void merge_partials(const T *m, const T *o_star, int parts, int dk, T *out) {
+    T m_all = -numeric_limits<T>::infinity();
+    for (int p = 0; p < parts; ++p) m_all = max(m_all, m[p]);
+    ScratchScope scratch;
+    T *acc = scratch.alloc<T>(dk + 1);
+    fill(acc, acc + dk + 1, T(0));
+    for (int p = 0; p < parts; ++p) {
+        if (m[p] == -numeric_limits<T>::infinity()) continue;  // empty partition
+        T w = exp(m[p] - m_all);
+        for (int d = 0; d <= dk; ++d) acc[d] += o_star[(size_t)p * (dk + 1) + d] * w;
+    }
+    T l = acc[0] == T(0) ? T(1e-12) : acc[0];
+    for (int d = 0; d < dk; ++d) out[d] = acc[d + 1] / l;
+}
+
+// K/V split into `partitions` ranges; the (query, partition) pairs are spread
+// over the threads, so a handful of queries still keeps every core busy.
+template <class T>
+vector<T> reference_attention_split(const vector<T> &Q, const vector<T> &K, const vector<T> &V,
+                                    int partitions, int dk = AURA_DK, int threads = 1) {
+    const int rows_q = (int)(Q.size() / dk);
+    const int rows_kv = (int)(K.size() / dk);
+    if (V.size() != K.size()) throw runtime_error("K and V have different sizes");
+    partitions = max(1, min(partitions, rows_kv));
+    StatScope scope("reference");
+    stats_count(STAT_ROWS, rows_q);
+    const int chunk = (rows_kv + partitions - 1) / partitions;
+
+    vector<T> m((size_t)rows_q * partitions), o_star((size_t)rows_q * partitions * (dk + 1));
+    parallel_rows(rows_q * partitions, threads, [&](int item) {
+        int i = item / partitions, p = item % partitions;
+        int begin = min(rows_kv, p * chunk), end = min(rows_kv, begin + chunk);
+        reference_partial(&Q[(size_t)i * dk], K.data(), V.data(), begin, end, dk,
+                          m[item], &o_star[(size_t)item * (dk + 1)]);
+    });
+
+    vector<T> O(Q.size());
+    for (int i = 0; i < rows_q; ++i)
+        merge_partials(&m[(size_t)i * partitions], &o_star[(size_t)i * partitions * (dk + 1)],
+                       partitions, dk, &O[(size_t)i * dk]);
+    return O;
+}
+
+#endif // AURA_REFERENCE_H
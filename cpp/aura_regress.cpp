@@ -0,0 +1,435 @@
+#include "aura_mem.h"
+#include "aura_model.h"
+#include "aura_reference.h"
+#include "aura_metrics.h"
+
+#include <dirent.h>
+#include <sys/stat.h>
+
+// -----------------------------------------------------
+// Regression runner over every case under models/.
+//
+// Each case (a directory with Q32.mem or Q.mem) is checked in parallel with
+// the others:
+//   model      : the C++ model against the reference (fp32 attention of the
+//                FP32 inputs when they exist, else fp64 of the Q0.7 inputs)
+//   rtl        : the RTL dump (O_cleaned.mem, or O_fixed_clean.mem) against
+//                the reference, and how many elements the model disagrees with
+//   files      : the checked-in O_fixed_correct.mem and O_float_correct.mem
+//                against what the reference computes today, and every X.dec
+//                against the FP32 decoding of its X.mem
+// Every number, and the load / reference / model / check times, is compared
+// with the previous run of the same model configuration: the baseline file
+// (--baseline) keeps one section per ModelConfig signature, and holds times of
+// this machine, so it is not checked in. An accuracy metric that gets worse by
+// any amount, or a time that grows by more than --speed-tol and --min-time, is
+// a regression: the tool exits 1 and keeps the old baseline. Otherwise, or
+// with --update, the section becomes this run; stored times are the mean of
+// this run and the previous baseline, so one fast outlier does not make the
+// next ordinary run look slow.
+// -----------------------------------------------------
+
+struct Options {
+    vector<string> tests;
+    string models = "models";
+    string baseline = "output/regress_baseline.txt";
+    bool update = false, help = false;
+    double speed_tol = 0.5;      // relative slowdown allowed
+    double min_time = 0.01;      // and absolute, in seconds (timer noise)
+    int threads = default_threads();
+    ModelConfig cfg;
+};
+
+static void usage(const char *prog) {
+    Options d;
+    cerr << "Usage: " << prog << " [options]\n"
+         << "  --test NAME           add models/NAME/ (repeatable; default every case under --models)\n"
+         << "  --models DIR          case root (default " << d.models << ")\n"
+         << "  --baseline FILE       previous run to compare with and update (default " << d.baseline << ")\n"
+         << "  --update              accept this run as the baseline even with regressions\n"
+         << "  --speed-tol X         flag times more than X slower, relative (default " << d.speed_tol << ")\n"
+         << "  --min-time S          ... and by more than S seconds (default " << d.min_time << ")\n"
+         << "  --guard-bits N        extra Log2Exp fraction bits in the C++ model (default 0)\n"
+         << "  -j N                  worker threads (default " << default_threads() << ")\n";
+}
+
+// every X.dec in dir, as X
+static vector<string> discover_dec(const string &dir) {
+    vector<string> names;
+    DIR *d = opendir(dir.c_str());
+    if (!d) return names;
+    while (dirent *e = readdir(d)) {
+        string name = e->d_name;
+        if (name.size() > 4 && name.compare(name.size() - 4, 4, ".dec") == 0)
+            names.push_back(name.substr(0, name.size() - 4));
+    }
+    closedir(d);
+    sort(names.begin(), names.end());
+    return names;
+}
+
+static Options parse_args(int argc, char **argv) {
+    Options o;
+    auto need = [&](int &i) -> string {
+        if (i + 1 >= argc) throw runtime_error(string("Missing value for ") + argv[i]);
+        return argv[++i];
+    };
+    for (int i = 1; i < argc; ++i) {
+        string a = argv[i];
+        if (a == "--test") o.tests.push_back(need(i));
+        else if (a == "--models") o.models = need(i);
+        else if (a == "--baseline") o.baseline = need(i);
+        else if (a == "--update") o.update = true;
+        else if (a == "--speed-tol") o.speed_tol = parse_double(need(i));
+        else if (a == "--min-time") o.min_time = parse_double(need(i));
+        else if (a == "--guard-bits") o.cfg.log2e_guard_bits = parse_int(need(i));
+        else if (a == "-j") o.threads = max(1, parse_int(need(i)));
+        else if (a == "-h" || a == "--help") {
+            o.help = true;
+            return o;
+        }
+        else throw runtime_error("Unknown option " + a);
+    }
+    if (o.tests.empty()) o.tests = discover_tests(o.models);
+    if (o.tests.empty()) throw runtime_error("No cases under " + o.models);
+    o.cfg.derive();
+    return o;
+}
+
+// -----------------------------------------------------
+// Metrics
+// -----------------------------------------------------
+enum MetricKind { LOWER_IS_BETTER, HIGHER_IS_BETTER, TIMING };
+
+struct MetricDef {
+    const char *name;
+    MetricKind kind;
+};
+
+static const MetricDef METRICS[] = {
+    {"model_mae", LOWER_IS_BETTER},      {"model_rmse", LOWER_IS_BETTER},
+    {"model_max", LOWER_IS_BETTER},      {"model_top1", HIGHER_IS_BETTER},
+    {"rtl_mae", LOWER_IS_BETTER},        {"rtl_max", LOWER_IS_BETTER},
+    {"rtl_model_diff", LOWER_IS_BETTER}, {"ref_file_max", LOWER_IS_BETTER},
+    {"float_file_max", LOWER_IS_BETTER}, {"dec_stale", LOWER_IS_BETTER},
+    {"load_s", TIMING},                  {"reference_s", TIMING},
+    {"model_s", TIMING},                 {"check_s", TIMING},
+};
+
+static const MetricDef *metric_def(const string &name) {
+    for (const auto &m : METRICS)
+        if (name == m.name) return &m;
+    return nullptr;
+}
+
+struct CaseResult {
+    string name, reference, error;
+    map<string, double> values;  // only the checks whose files exist
+    vector<string> notes;
+};
+
+static double seconds_since(chrono::steady_clock::time_point t0) {
+    return chrono::duration<double>(chrono::steady_clock::now() - t0).count();
+}
+
+// X.dec (python/convert_to_decimal.py, %.6f per float) against the FP32 words of X.mem:
+// values that do not print the same
+static size_t stale_dec_values(const string &dec, const string &mem) {
+    auto words = parse_hex_words(read_file(mem), 8, mem);
+    string text = read_file(dec);
+    replace(text.begin(), text.end(), ',', ' ');
+    stringstream ss(text);
+    size_t i = 0, stale = 0;
+    for (string t; ss >> t; ++i) {
+        if (i >= words.size()) return stale + 1;
+        uint32_t bits = __builtin_bswap32((uint32_t)words[i]);
+        float f;
+        memcpy(&f, &bits, sizeof(f));
+        char want[64];
+        snprintf(want, sizeof(want), "%.6f", (double)f);  // both sides round the exact binary value
+        stale += isnan(f) ? (t != "nan" && t != "-nan") : t != want;
+    }
+    return stale + (words.size() - i);
+}
+
+static CaseResult run_case(const Options &o, const string &name, int threads) {
+    CaseResult r;
+    r.name = name;
+    auto &v = r.values;
+    const string dir = o.models + "/" + name + "/";
+    const int D = AURA_DK;
+
+    auto t0 = chrono::steady_clock::now();
+    CaseInputs in = read_case(o.models, name);
+    const vector<float> &Q32 = in.Q32, &K32 = in.K32, &V32 = in.V32;
+    const vector<int8_t> &Q = in.Q, &K = in.K, &V = in.V;
+    r.reference = in.has_fp32() ? "fp32" : "fp64";
+    v["load_s"] = seconds_since(t0);
+
+    t0 = chrono::steady_clock::now();
+    vector<float> O_float;
+    vector<int8_t> O_ref;
+    if (r.reference == "fp32") {
+        O_float = reference_attention(Q32, K32, V32, D, threads);
+        O_ref = quantize_q07(O_float);
+    } else {
+        O_ref = quantize_q07(reference_attention(dequantize_q07<double>(Q), dequantize_q07<double>(K),
+                                                 dequantize_q07<double>(V), D, threads));
+    }
+    v["reference_s"] = seconds_since(t0);
+
+    t0 = chrono::steady_clock::now();
+    vector<int8_t> O_model = model_attention(Q, K, V, o.cfg, threads);
+    v["model_s"] = seconds_since(t0);
+
+    t0 = chrono::steady_clock::now();
+    Metrics m = compare_outputs(O_ref, O_model);
+    v["model_mae"] = m.mae;
+    v["model_rmse"] = m.rmse;
+    v["model_max"] = m.max_abs_error;
+    v["model_top1"] = m.top1_ratio();
+
+    string rtl = readable(dir + "O_cleaned.mem") ? "O_cleaned.mem"
+               : readable(dir + "O_fixed_clean.mem") ? "O_fixed_clean.mem" : "";
+    if (!rtl.empty()) {
+        auto O_rtl = read_int8_mem(dir + rtl);
+        Metrics mr = compare_outputs(O_ref, O_rtl);
+        v["rtl_mae"] = mr.mae;
+        v["rtl_max"] = mr.max_abs_error;
+        size_t diff = 0;
+        for (size_t i = 0; i < O_rtl.size(); ++i) diff += O_rtl[i] != O_model[i];
+        v["rtl_model_diff"] = (double)diff;
+    } else {
+        r.notes.push_back("no RTL dump");
+    }
+
+    if (readable(dir + "O_fixed_correct.mem")) {
+        auto O_file = read_int8_mem(dir + "O_fixed_correct.mem");
+        if (O_file.size() != O_ref.size()) throw runtime_error(name + ": O_fixed_correct.mem has the wrong size");
+        int worst = 0;
+        for (size_t i = 0; i < O_file.size(); ++i) worst = max(worst, abs(O_file[i] - O_ref[i]));
+        v["ref_file_max"] = worst;
+    }
+    if (!O_float.empty() && readable(dir + "O_float_correct.mem")) {
+        auto O_file = read_fp32_mem(dir + "O_float_correct.mem");
+        if (O_file.size() != O_float.size()) throw runtime_error(name + ": O_float_correct.mem has the wrong size");
+        double worst = 0;
+        for (size_t i = 0; i < O_file.size(); ++i) worst = max(worst, (double)fabs(O_file[i] - O_float[i]));
+        v["float_file_max"] = worst;
+    }
+
+    size_t stale = 0, decs = 0;
+    for (const auto &base : discover_dec(dir)) {
+        if (!readable(dir + base + ".mem")) {
+            r.notes.push_back(base + ".dec has no .mem");
+            continue;
+        }
+        size_t n = stale_dec_values(dir + base + ".dec", dir + base + ".mem");
+        if (n) r.notes.push_back(base + ".dec stale");
+        stale += n;
+        ++decs;
+    }
+    if (decs) v["dec_stale"] = (double)stale;
+    v["check_s"] = seconds_since(t0);
+    return r;
+}
+
+// -----------------------------------------------------
+// Baseline: a '# model SIGNATURE' section per model configuration, each
+// followed by 'case metric value' lines
+// -----------------------------------------------------
+using CaseValues = map<string, map<string, double>>;   // case -> metric -> value
+
+struct Baseline {
+    map<string, CaseValues> models;   // signature -> its last accepted run
+};
+
+static Baseline read_baseline(const string &path) {
+    Baseline b;
+    ifstream fin(path);
+    if (!fin) return b;
+    CaseValues *section = nullptr;
+    for (string line; getline(fin, line);) {
+        if (line.rfind("# model ", 0) == 0) section = &b.models[line.substr(8)];
+        if (line.empty() || line[0] == '#') continue;
+        stringstream ss(line);
+        string c, metric;
+        double value;
+        if (!(ss >> c >> metric >> value) || !section)
+            throw runtime_error("Malformed baseline line in " + path + ": " + line);
+        (*section)[c][metric] = value;
+    }
+    return b;
+}
+
+// this run replaces the section of its own signature; the others are kept
+static void write_baseline(const string &path, const Options &o, const Baseline &prev,
+                           const vector<CaseResult> &results) {
+    const string sig = o.cfg.signature();
+    size_t slash = path.find_last_of('/');
+    if (slash != string::npos) mkdir(path.substr(0, slash).c_str(), 0777);
+    string tmp = path + ".tmp" + to_string(getpid());
+    {
+        ofstream fout(tmp);
+        if (!fout) throw runtime_error("Cannot open for writing " + tmp);
+        fout << "# aura_regress baseline: '# model' sections of case metric value\n" << setprecision(17);
+        for (const auto &[model, cases] : prev.models) {
+            if (model == sig) continue;
+            fout << "# model " << model << "\n";
+            for (const auto &[c, values] : cases)
+                for (const auto &[metric, value] : values) fout << c << " " << metric << " " << value << "\n";
+        }
+        auto own = prev.models.find(sig);
+        fout << "# model " << sig << "\n";
+        for (const auto &r : results)
+            for (const auto &m : METRICS) {
+                if (!r.values.count(m.name)) continue;
+                double value = r.values.at(m.name);
+                if (m.kind == TIMING && own != prev.models.end()) {
+                    auto c = own->second.find(r.name);
+                    if (c != own->second.end() && c->second.count(m.name))
+                        value = 0.5 * (value + c->second.at(m.name));
+                }
+                fout << r.name << " " << m.name << " " << value << "\n";
+            }
+        if (!fout) throw runtime_error("Cannot write " + tmp);
+    }
+    if (rename(tmp.c_str(), path.c_str()) != 0) throw runtime_error("Cannot rename " + tmp);
+}
+
+struct Change {
+    string test, metric;
+    double before, after;
+    bool regression;
+};
+
+static vector<Change> diff_baseline(const Options &o, const CaseValues &b, const vector<CaseResult> &results) {
+    vector<Change> out;
+    for (const auto &r : results) {
+        auto it = b.find(r.name);
+        if (it == b.end()) continue;
+        for (const auto &[metric, after] : r.values) {
+            auto bt = it->second.find(metric);
+            const MetricDef *def = metric_def(metric);
+            if (bt == it->second.end() || !def) continue;
+            double before = bt->second, eps = 1e-9 * max(1.0, fabs(before));
+            if (def->kind == TIMING) {
+                if (after > before * (1 + o.speed_tol) && after - before > o.min_time)
+                    out.push_back({r.name, metric, before, after, true});
+            } else if (fabs(after - before) > eps) {
+                bool worse = def->kind == LOWER_IS_BETTER ? after > before : after < before;
+                out.push_back({r.name, metric, before, after, worse});
+            }
+        }
+        for (const auto &[metric, before] : it->second)
+            if (!r.values.count(metric) && metric_def(metric) && metric_def(metric)->kind != TIMING)
+                out.push_back({r.name, metric, before, NAN, true});  // a check that no longer runs
+    }
+    return out;
+}
+
+// -----------------------------------------------------
+// Report
+// -----------------------------------------------------
+static string cell(const CaseResult &r, const char *metric, int precision) {
+    auto it = r.values.find(metric);
+    if (it == r.values.end()) return "-";
+    stringstream ss;
+    ss << fixed << setprecision(precision) << it->second;
+    return ss.str();
+}
+
+int main(int argc, char **argv) {
+    stats_init(argc, argv);
+    ios::sync_with_stdio(false);
+
+    Options o;
+    try {
+        o = parse_args(argc, argv);
+    } catch (const exception &e) {
+        cerr << "ERROR: " << e.what() << "\n";
+        return 1;
+    }
+    if (o.help) {
+        usage(argv[0]);
+        return 0;
+    }
+
+    try {
+        Baseline base = read_baseline(o.baseline);
+        // only a run of the same model configuration is comparable
+        const CaseValues &prev = base.models[o.cfg.signature()];
+        auto t0 = chrono::steady_clock::now();
+
+        // cases in parallel; spare threads go to the rows of each case
+        vector<CaseResult> results(o.tests.size());
+        const int outer = min<int>(o.threads, (int)o.tests.size());
+        const int inner = max(1, o.threads / max(1, outer));
+        parallel_rows((int)o.tests.size(), outer, [&](int i) {
+            try {
+                results[i] = run_case(o, o.tests[i], inner);
+            } catch (const exception &e) {
+                results[i].name = o.tests[i];
+                results[i].error = e.what();
+            }
+        });
+        double wall = seconds_since(t0);
+
+        cout << "===== AURA Regression =====\n";
+        cout << "Cases         : " << results.size() << " under " << o.models << "\n";
+        cout << "Model         : " << o.cfg.signature() << "\n";
+        cout << "Baseline      : " << o.baseline;
+        if (prev.empty()) cout << " (none yet for this model)";
+        cout << "\n\n";
+
+        cout << left << setw(20) << "case" << setw(6) << "ref" << setw(9) << "MAE" << setw(9) << "RMSE"
+             << setw(5) << "max" << setw(7) << "top-1" << setw(9) << "RTL MAE" << setw(10) << "RTL diff"
+             << setw(9) << "ref file" << setw(12) << "float file" << setw(5) << "dec" << setw(9) << "ref s"
+             << setw(9) << "model s" << "notes\n";
+        int failed = 0;
+        for (const auto &r : results) {
+            if (!r.error.empty()) {
+                ++failed;
+                cout << left << setw(20) << r.name << "ERROR: " << r.error << "\n";
+                continue;
+            }
+            string notes;
+            for (const auto &n : r.notes) notes += (notes.empty() ? "" : ", ") + n;
+            cout << left << setw(20) << r.name << setw(6) << r.reference << setw(9) << cell(r, "model_mae", 4)
+                 << setw(9) << cell(r, "model_rmse", 4) << setw(5) << cell(r, "model_max", 0) << setw(7)
+                 << cell(r, "model_top1", 3) << setw(9) << cell(r, "rtl_mae", 4) << setw(10)
+                 << cell(r, "rtl_model_diff", 0) << setw(9) << cell(r, "ref_file_max", 0) << setw(12)
+                 << cell(r, "float_file_max", 7) << setw(5) << cell(r, "dec_stale", 0) << setw(9)
+                 << cell(r, "reference_s", 3) << setw(9) << cell(r, "model_s", 3) << notes << "\n";
+        }
+
+        vector<Change> changes = diff_baseline(o, prev, results);
+        int regressions = failed;
+        for (const auto &c : changes) regressions += c.regression;
+        if (!changes.empty()) {
+            cout << "\n" << left << setw(20) << "case" << setw(16) << "metric" << setw(16) << "baseline"
+                 << setw(16) << "now" << "\n";
+            for (const auto &c : changes) {
+                cout << left << setw(20) << c.test << setw(16) << c.metric << setprecision(6) << setw(16)
+                     << c.before << setw(16);
+                if (isnan(c.after)) cout << "missing";
+                else cout << c.after;
+                cout << (c.regression ? "REGRESSION" : "improved") << "\n" << defaultfloat;
+            }
+        }
+
+        cout << "\nWall time     : " << fixed << setprecision(3) << wall << " s\n" << defaultfloat;
+        if (regressions == 0 || o.update) {
+            write_baseline(o.baseline, o, base, results);
+            cout << "Baseline      : " << (prev.empty() ? "written" : "updated") << "\n";
+        } else {
+            cout << "Baseline      : kept (--update accepts this run)\n";
+        }
+        cout << "Overall       : " << (regressions ? to_string(regressions) + " regression(s)" : "PASS") << "\n";
+        return regressions ? 1 : 0;
+
+    } catch (const exception &e) {
+        cerr << "ERROR: " << e.what() << "\n";
+        return 1;
+    }
+}
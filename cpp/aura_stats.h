@@ -0,0 +1,225 @@
+// Phase timing and counters for every tool: --stats, --stats-json FILE, --stats-perf.
+//
+// stats_init(argc, argv) at the top of main() takes the three options out of
+// argv (so each tool's own parsing never sees them) and prints the report when
+// the process exits:
+//   phases   : StatScope("name") wall time and calls, summed over threads;
+//              scopes nest, so an outer phase includes its inner ones
+//   counters : bytes parsed and written, attention rows computed, elements
+//              converted (stats_count)
+//   perf     : with --stats-perf, process-wide hardware counters from
+//              perf_event_open (cycles, instructions, cache and branch misses)
+// --stats prints a table to stderr, --stats-json FILE ('-' = stdout) the same
+// as one JSON object. Disabled, a scope or a count is one branch on a global
+// flag; the clock is never read.
+
+#ifndef AURA_STATS_H
+#define AURA_STATS_H
+
+#include <bits/stdc++.h>
+#include <linux/perf_event.h>
+#include <sys/stat.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+using namespace std;
+
+enum StatCounter { STAT_BYTES_READ, STAT_BYTES_WRITTEN, STAT_ROWS, STAT_ELEMENTS, NUM_STAT_COUNTERS };
+
+inline const char *stat_counter_name(int c) {
+    static const char *names[NUM_STAT_COUNTERS] = {"bytes_read", "bytes_written", "rows_computed",
+                                                   "elements_converted"};
+    return names[c];
+}
+
+enum StatPerf { STAT_CYCLES, STAT_INSTRUCTIONS, STAT_CACHE_MISSES, STAT_BRANCH_MISSES, NUM_STAT_PERF };
+
+inline const char *stat_perf_name(int p) {
+    static const char *names[NUM_STAT_PERF] = {"cycles", "instructions", "cache_misses", "branch_misses"};
+    return names[p];
+}
+
+// set once by stats_init(), before any worker thread exists
+inline bool stats_on = false;
+
+struct StatPhase {
+    string name;
+    uint64_t calls = 0;
+    double seconds = 0;
+};
+
+struct StatsState {
+    bool text = false, perf = false;
+    string json, tool;
+    chrono::steady_clock::time_point start;
+    atomic<uint64_t> counters[NUM_STAT_COUNTERS] = {};
+    mutex m;
+    vector<StatPhase> phases;   // first-use order
+    int perf_fd[NUM_STAT_PERF] = {-1, -1, -1, -1};
+    string perf_error;
+};
+
+inline StatsState &stats_state() {
+    static StatsState s;
+    return s;
+}
+
+inline void stats_count(StatCounter c, uint64_t n) {
+    if (stats_on) stats_state().counters[c].fetch_add(n, memory_order_relaxed);
+}
+
+// whole-file reads by tools that parse with their own stream loop
+inline void stats_count_file(const string &filename) {
+    struct stat st {};
+    if (stats_on && stat(filename.c_str(), &st) == 0) stats_count(STAT_BYTES_READ, (uint64_t)st.st_size);
+}
+
+inline void stats_record(const char *name, double seconds) {
+    StatsState &s = stats_state();
+    lock_guard<mutex> lock(s.m);
+    for (auto &p : s.phases)
+        if (p.name == name) {
+            p.calls++;
+            p.seconds += seconds;
+            return;
+        }
+    s.phases.push_back({name, 1, seconds});
+}
+
+class StatScope {
+public:
+    explicit StatScope(const char *name) : name_(stats_on ? name : nullptr) {
+        if (name_) start_ = chrono::steady_clock::now();
+    }
+    ~StatScope() {
+        if (name_) stats_record(name_, chrono::duration<double>(chrono::steady_clock::now() - start_).count());
+    }
+    StatScope(const StatScope &) = delete;
+    StatScope &operator=(const StatScope &) = delete;
+
+private:
+    const char *name_;
+    chrono::steady_clock::time_point start_;
+};
+
+// ---------------------------
+// Hardware counters
+// ---------------------------
+inline void stats_open_perf(StatsState &s) {
+    static const uint64_t config[NUM_STAT_PERF] = {PERF_COUNT_HW_CPU_CYCLES, PERF_COUNT_HW_INSTRUCTIONS,
+                                                   PERF_COUNT_HW_CACHE_MISSES, PERF_COUNT_HW_BRANCH_MISSES};
+    for (int p = 0; p < NUM_STAT_PERF; ++p) {
+        perf_event_attr attr{};
+        attr.size = sizeof(attr);
+        attr.type = PERF_TYPE_HARDWARE;
+        attr.config = config[p];
+        attr.inherit = 1;           // threads created later are counted too
+        attr.exclude_kernel = 1;
+        attr.exclude_hv = 1;
+        s.perf_fd[p] = (int)syscall(SYS_perf_event_open, &attr, 0, -1, -1, 0);
+        if (s.perf_fd[p] < 0 && s.perf_error.empty())
+            s.perf_error = string(stat_perf_name(p)) + ": " + strerror(errno);
+    }
+}
+
+inline bool stats_read_perf(const StatsState &s, int p, uint64_t &value) {
+    return s.perf_fd[p] >= 0 && read(s.perf_fd[p], &value, sizeof(value)) == (ssize_t)sizeof(value);
+}
+
+// ---------------------------
+// Report
+// ---------------------------
+inline string stats_json_escape(const string &in) {
+    string out;
+    for (char c : in) {
+        if (c == '"' || c == '\\') out += '\\';
+        out += c;
+    }
+    return out;
+}
+
+inline void stats_report() {
+    StatsState &s = stats_state();
+    const double wall = chrono::duration<double>(chrono::steady_clock::now() - s.start).count();
+    uint64_t perf[NUM_STAT_PERF];
+    bool have_perf[NUM_STAT_PERF] = {};
+    if (s.perf)
+        for (int p = 0; p < NUM_STAT_PERF; ++p) have_perf[p] = stats_read_perf(s, p, perf[p]);
+    lock_guard<mutex> lock(s.m);
+
+    if (s.text) {
+        ostringstream out;
+        out << "===== Stats: " << s.tool << " =====\n";
+        out << left << setw(22) << "phase" << setw(10) << "calls" << setw(12) << "total (s)" << "share\n";
+        for (const auto &p : s.phases)
+            out << left << setw(22) << p.name << setw(10) << p.calls << fixed << setprecision(4) << setw(12)
+                << p.seconds << setprecision(1) << 100.0 * p.seconds / max(wall, 1e-12) << "%\n" << defaultfloat;
+        out << left << setw(32) << "wall" << fixed << setprecision(4) << wall << "\n" << defaultfloat;
+        for (int c = 0; c < NUM_STAT_COUNTERS; ++c)
+            out << left << setw(32) << stat_counter_name(c) << s.counters[c].load() << "\n";
+        if (s.perf) {
+            for (int p = 0; p < NUM_STAT_PERF; ++p)
+                if (have_perf[p]) out << left << setw(32) << stat_perf_name(p) << perf[p] << "\n";
+            if (have_perf[STAT_CYCLES] && have_perf[STAT_INSTRUCTIONS] && perf[STAT_CYCLES])
+                out << left << setw(32) << "IPC" << fixed << setprecision(2)
+                    << (double)perf[STAT_INSTRUCTIONS] / perf[STAT_CYCLES] << "\n" << defaultfloat;
+            if (!s.perf_error.empty()) out << "perf_event unavailable (" << s.perf_error << ")\n";
+        }
+        cerr << out.str();
+    }
+
+    if (!s.json.empty()) {
+        ostringstream j;
+        j << setprecision(9) << "{\"tool\": \"" << stats_json_escape(s.tool) << "\", \"wall_s\": " << wall
+          << ", \"phases\": [";
+        for (size_t i = 0; i < s.phases.size(); ++i)
+            j << (i ? ", " : "") << "{\"name\": \"" << stats_json_escape(s.phases[i].name)
+              << "\", \"calls\": " << s.phases[i].calls << ", \"seconds\": " << s.phases[i].seconds << "}";
+        j << "], \"counters\": {";
+        for (int c = 0; c < NUM_STAT_COUNTERS; ++c)
+            j << (c ? ", " : "") << "\"" << stat_counter_name(c) << "\": " << s.counters[c].load();
+        j << "}";
+        if (s.perf) {
+            j << ", \"perf\": {";
+            bool first = true;
+            for (int p = 0; p < NUM_STAT_PERF; ++p)
+                if (have_perf[p]) {
+                    j << (first ? "" : ", ") << "\"" << stat_perf_name(p) << "\": " << perf[p];
+                    first = false;
+                }
+            j << "}";
+        }
+        j << "}\n";
+        if (s.json == "-") {
+            cout << j.str() << flush;
+        } else {
+            ofstream f(s.json);
+            if (f) f << j.str();
+            else cerr << "ERROR: Cannot open " << s.json << "\n";
+        }
+    }
+}
+
+// Strips --stats, --stats-json FILE and --stats-perf from argv
+inline void stats_init(int &argc, char **argv) {
+    StatsState &s = stats_state();
+    int out = 1;
+    for (int i = 1; i < argc; ++i) {
+        string a = argv[i];
+        if (a == "--stats") s.text = true;
+        else if (a == "--stats-perf") s.perf = true;
+        else if (a == "--stats-json" && i + 1 < argc) s.json = argv[++i];
+        else argv[out++] = argv[i];
+    }
+    argc = out;
+    argv[argc] = nullptr;
+    if (s.perf && s.json.empty()) s.text = true;
+    if (!s.text && s.json.empty()) return;
+    s.tool = argv[0];
+    s.tool = s.tool.substr(s.tool.find_last_of('/') + 1);
+    s.start = chrono::steady_clock::now();
+    if (s.perf) stats_open_perf(s);
+    stats_on = true;
+    atexit(stats_report);
+}
+
+#endif // AURA_STATS_H
@@ -0,0 +1,286 @@
+#include "aura_mem.h"
+#include "aura_memo.h"
+#include "aura_reference.h"
+#include "aura_metrics.h"
+
+// -----------------------------------------------------
+// Design-space sweep of the fixed-point model over the corpus.
+//
+// Every combination of the list options is one point, evaluated against the
+// fp64 attention of the Q0.7 inputs. The grid runs upstream parameters
+// outermost (ROUNDING, then the expmul_stage ones, then the normalisation),
+// and ModelMemo (aura_memo.h) keeps the scores, running max and o*
+// accumulators of the previous points, so a point that only moves
+// DIV_INPUT_QT, OUTPUT_VEC_QT or the reciprocal reruns just the
+// normalisation, and one that moves EXPMUL_EXP_I or the guard bits reruns
+// expmul and normalisation. The "reran" column shows which stages ran.
+//
+// ROUNDING is a single `define used by every q_convert of the PE, so changing
+// it reruns every stage. --output-f narrows OUTPUT_VEC_QT below Q0.7; those
+// outputs are shifted back onto the Q0.7 grid before the comparison.
+//
+// --verify checks every point's outputs, memoized or not, against
+// model_attention_row one query row at a time, and reruns the lane model with
+// a different K/V length per lane so lanes of one group finish at different rows.
+// -----------------------------------------------------
+
+struct SweepOptions {
+    vector<string> tests;
+    string models = "models";
+    vector<int> rounding = {1}, exp_i = {4}, guard = {0}, div_f, out_f, recip = {0};
+    bool memo = true, verify = false, help = false;
+    size_t memo_mb = 1024;
+    int threads = default_threads();
+};
+
+static void usage(const char *prog) {
+    cerr << "Usage: " << prog << " [options]\n"
+         << "  --test NAME           add models/NAME/ (repeatable; default every case under --models)\n"
+         << "  --models DIR          case root (default models)\n"
+         << "  --rounding LIST       `ROUNDING values (default 1)\n"
+         << "  --exp-i LIST          EXPMUL_EXP_I, clipped exponent integer bits (default 4)\n"
+         << "  --guard-bits LIST     extra Log2Exp fraction bits (default 0)\n"
+         << "  --div-input-f LIST    DIV_INPUT_QT fraction bits (default derived: OUTPUT_VEC_F + ROUNDING)\n"
+         << "  --output-f LIST       OUTPUT_VEC_QT fraction bits, 1..7 (default 7)\n"
+         << "  --recip-bits LIST     reciprocal fraction bits, 0 = int_division (default 0)\n"
+         << "  --no-memo             evaluate every point in full (for timing)\n"
+         << "  --verify              check every point against the row-by-row model\n"
+         << "  --memo-mb N           intermediates kept in memory (default 1024)\n"
+         << "  -j N                  worker threads (default " << default_threads() << ")\n";
+}
+
+static SweepOptions parse_args(int argc, char **argv) {
+    SweepOptions o;
+    auto need = [&](int &i) -> string {
+        if (i + 1 >= argc) throw runtime_error(string("Missing value for ") + argv[i]);
+        return argv[++i];
+    };
+    for (int i = 1; i < argc; ++i) {
+        string a = argv[i];
+        if (a == "--test") o.tests.push_back(need(i));
+        else if (a == "--models") o.models = need(i);
+        else if (a == "--rounding") o.rounding = parse_list(need(i));
+        else if (a == "--exp-i") o.exp_i = parse_list(need(i));
+        else if (a == "--guard-bits") o.guard = parse_list(need(i));
+        else if (a == "--div-input-f") o.div_f = parse_list(need(i));
+        else if (a == "--output-f") o.out_f = parse_list(need(i));
+        else if (a == "--recip-bits") o.recip = parse_list(need(i));
+        else if (a == "--no-memo") o.memo = false;
+        else if (a == "--verify") o.verify = true;
+        else if (a == "--memo-mb") o.memo_mb = max(0, parse_int(need(i)));
+        else if (a == "-j") o.threads = max(1, parse_int(need(i)));
+        else if (a == "-h" || a == "--help") {
+            o.help = true;
+            return o;
+        }
+        else throw runtime_error("Unknown option " + a);
+    }
+    for (int f : o.out_f)
+        if (f < 1 || f > 7) throw runtime_error("--output-f values must be in [1, 7]");
+    for (int f : o.div_f)
+        if (f < 1 || f > 26) throw runtime_error("--div-input-f values must be in [1, 26]");
+    for (int e : o.exp_i)
+        if (e < 1 || e > 5) throw runtime_error("--exp-i values must be in [1, 5]");
+    if (o.tests.empty()) o.tests = discover_tests(o.models);
+    if (o.tests.empty()) throw runtime_error("No cases under " + o.models);
+    return o;
+}
+
+struct Case {
+    string name;
+    vector<int8_t> Q, K, V, O_ref;
+};
+
+static Case load_case(const SweepOptions &o, const string &name) {
+    Case c{name, {}, {}, {}, {}};
+    CaseInputs in = read_case(o.models, name);
+    c.Q = std::move(in.Q), c.K = std::move(in.K), c.V = std::move(in.V);
+    c.O_ref = quantize_q07(reference_attention(dequantize_q07<double>(c.Q), dequantize_q07<double>(c.K),
+                                               dequantize_q07<double>(c.V), AURA_DK, o.threads));
+    return c;
+}
+
+// One point of the grid
+struct SweepPoint {
+    int rounding, exp_i, guard, div_f, out_f, recip;  // div_f / out_f 0 = derived
+
+    ModelConfig config() const {
+        ModelConfig cfg;
+        cfg.rounding = rounding;
+        cfg.expmul_exp_i = exp_i;
+        cfg.log2e_guard_bits = guard;
+        cfg.recip_bits = recip;
+        cfg.derive();
+        if (out_f) cfg.output_vec.f = out_f;
+        if (div_f) cfg.div_input.f = div_f;
+        else if (out_f) cfg.div_input.f = out_f + rounding;
+        return cfg;
+    }
+};
+
+static vector<SweepPoint> grid(const SweepOptions &o) {
+    vector<int> div_f = o.div_f.empty() ? vector<int>{0} : o.div_f;
+    vector<int> out_f = o.out_f.empty() ? vector<int>{0} : o.out_f;
+    vector<SweepPoint> points;
+    for (int r : o.rounding)
+        for (int g : o.guard)
+            for (int e : o.exp_i)
+                for (int of : out_f)
+                    for (int df : div_f)
+                        for (int p : o.recip) points.push_back({r, e, g, df, of, p});
+    return points;
+}
+
+// Corpus-wide metrics of one point
+struct SweepResult {
+    double mae = 0, rmse = 0, secs = 0;
+    int max_err = 0, top1 = 0, rows = 0, passed = 0;
+    int reran = 0;          // first stage that ran (NUM_MODEL_STAGES: normalize only)
+    bool mismatch = false;  // --verify: the lane or memoized output differs from the row model
+};
+
+// --verify for one case: O (the sweep's output) and the lane model over mixed
+// K/V lengths against model_attention_row
+static bool matches_row_model(const Case &c, const vector<int8_t> &O, const ModelConfig &cfg, int threads) {
+    const int D = cfg.embedding_dim, rows_q = (int)(c.Q.size() / D), rows_kv = (int)(c.K.size() / D);
+    vector<int> len(rows_q);
+    for (int i = 0; i < rows_q; ++i) len[i] = 1 + (int)((uint64_t)i * 7919 % rows_kv);
+
+    vector<int8_t> O_mixed(c.Q.size());
+    vector<ModelLane> lanes(rows_q);
+    for (int i = 0; i < rows_q; ++i) {
+        lanes[i].q = &c.Q[(size_t)i * D];
+        lanes[i].K = MatrixView<const int8_t>(c.K, D).slice(0, len[i]);
+        lanes[i].V = MatrixView<const int8_t>(c.V, D).slice(0, len[i]);
+        lanes[i].o = &O_mixed[(size_t)i * D];
+    }
+    model_attention_lanes(lanes, cfg, threads);
+
+    atomic<bool> same{true};
+    parallel_rows(rows_q, threads, [&](int i) {
+        vector<int8_t> want(D), want_mixed(D);
+        const size_t at = (size_t)i * D;
+        model_attention_row(&c.Q[at], c.K.data(), c.V.data(), rows_kv, want.data(), cfg);
+        model_attention_row(&c.Q[at], c.K.data(), c.V.data(), len[i], want_mixed.data(), cfg);
+        if (!equal(want.begin(), want.end(), &O[at]) || !equal(want_mixed.begin(), want_mixed.end(), &O_mixed[at]))
+            same = false;
+    });
+    return same;
+}
+
+static SweepResult evaluate(const vector<Case> &cases, const SweepPoint &pt, const SweepOptions &o,
+                            ModelMemo &memo) {
+    const ModelConfig cfg = pt.config();
+    const int D = cfg.embedding_dim;
+    const int out_shift = cfg.integer_width - 1 - cfg.output_vec.f;
+    int misses[NUM_MODEL_STAGES];
+    for (int s = 0; s < NUM_MODEL_STAGES; ++s) misses[s] = memo.misses(ModelStage(s));
+
+    SweepResult r;
+    double abs_sum = 0, sq_sum = 0;
+    size_t total = 0;
+    for (const auto &c : cases) {
+        vector<int8_t> O(c.Q.size());
+        MatrixView<const int8_t> Q(c.Q, D), K(c.K, D), V(c.V, D);
+        auto t0 = chrono::steady_clock::now();
+        if (o.memo) model_attention_memo(Q, K, V, MatrixView<int8_t>(O, D), cfg, memo, o.threads);
+        else model_attention(Q, K, V, MatrixView<int8_t>(O, D), cfg, o.threads);
+        r.secs += chrono::duration<double>(chrono::steady_clock::now() - t0).count();
+        if (o.verify && !matches_row_model(c, O, cfg, o.threads)) r.mismatch = true;
+
+        for (auto &x : O) x = int8_t(x * (1 << out_shift));  // back onto the Q0.7 grid
+        Metrics m = compare_outputs(c.O_ref, O);
+        abs_sum += m.mae * m.total_elements;
+        sq_sum += m.rmse * m.rmse * m.total_elements;
+        total += m.total_elements;
+        r.max_err = max(r.max_err, m.max_abs_error);
+        r.top1 += m.top1_match;
+        r.rows += m.rows;
+        r.passed += m.passed();
+    }
+    r.mae = abs_sum / total;
+    r.rmse = sqrt(sq_sum / total);
+    r.reran = NUM_MODEL_STAGES;
+    for (int s = NUM_MODEL_STAGES - 1; s >= 0; --s)
+        if (memo.misses(ModelStage(s)) != misses[s]) r.reran = s;
+    return r;
+}
+
+static string reran_name(const SweepOptions &o, int first) {
+    if (!o.memo || first == STAGE_SCORE) return "all";
+    if (first == NUM_MODEL_STAGES) return "normalize";
+    return string(model_stage_name(first)) + "+normalize";
+}
+
+int main(int argc, char **argv) {
+    stats_init(argc, argv);
+    ios::sync_with_stdio(false);
+
+    SweepOptions o;
+    try {
+        o = parse_args(argc, argv);
+    } catch (const exception &e) {
+        cerr << "ERROR: " << e.what() << "\n";
+        return 1;
+    }
+    if (o.help) {
+        usage(argv[0]);
+        return 0;
+    }
+
+    try {
+        vector<Case> cases;
+        for (const auto &t : o.tests) cases.push_back(load_case(o, t));
+        vector<SweepPoint> points = grid(o);
+        ModelMemo memo(o.memo_mb << 20);
+
+        cout << "===== Design-Space Sweep =====\n";
+        cout << "Corpus        : ";
+        for (size_t i = 0; i < o.tests.size(); ++i) cout << (i ? ", " : "") << o.tests[i];
+        cout << "\nReference     : fp64 attention of the Q0.7 inputs\n";
+        cout << "Points        : " << points.size() << (o.memo ? " (memoized)" : " (full evaluation)") << "\n\n";
+
+        cout << left << setw(5) << "R" << setw(7) << "EXP_I" << setw(7) << "guard" << setw(8) << "DIV_IN"
+             << setw(8) << "OUT" << setw(7) << "recip" << setw(10) << "MAE" << setw(10) << "RMSE" << setw(5)
+             << "max" << setw(9) << "top1" << setw(8) << "passed" << setw(18) << "reran" << "model (s)\n";
+        double first_secs = 0, tail_secs = 0;
+        int mismatches = 0;
+        for (size_t p = 0; p < points.size(); ++p) {
+            const SweepPoint &pt = points[p];
+            ModelConfig cfg = pt.config();
+            SweepResult r = evaluate(cases, pt, o, memo);
+            (p ? tail_secs : first_secs) += r.secs;
+            mismatches += r.mismatch;
+            string div_in = "Q" + to_string(cfg.div_input.i) + "." + to_string(cfg.div_input.f);
+            string out = "Q" + to_string(cfg.output_vec.i) + "." + to_string(cfg.output_vec.f);
+            cout << left << setw(5) << pt.rounding << setw(7) << pt.exp_i << setw(7) << pt.guard << setw(8)
+                 << div_in << setw(8) << out << setw(7) << (pt.recip ? to_string(pt.recip) : "-") << fixed
+                 << setprecision(5) << setw(10) << r.mae << setw(10) << r.rmse << setw(5) << r.max_err
+                 << setprecision(4) << setw(9) << (r.rows ? r.top1 / double(r.rows) : 0.0) << setw(8)
+                 << (to_string(r.passed) + "/" + to_string(cases.size())) << setw(18) << reran_name(o, r.reran)
+                 << setprecision(3) << r.secs << (r.mismatch ? "  MISMATCH" : "") << "\n" << defaultfloat;
+        }
+
+        cout << "\nModel time    : " << fixed << setprecision(3) << first_secs + tail_secs << " s (first point "
+             << first_secs << " s";
+        if (points.size() > 1) cout << ", then " << tail_secs / (points.size() - 1) << " s per point";
+        cout << ")\n" << defaultfloat;
+        if (o.memo) {
+            cout << "Memo          :";
+            for (int s = 0; s < NUM_MODEL_STAGES; ++s)
+                cout << " " << model_stage_name(s) << " " << memo.hits(ModelStage(s)) << " hits / "
+                     << memo.misses(ModelStage(s)) << " runs" << (s + 1 < NUM_MODEL_STAGES ? "," : "");
+            cout << "; " << memo.bytes() / (1 << 20) << " MB held\n";
+        }
+        if (o.verify) {
+            cout << "Verify        : " << (mismatches ? to_string(mismatches) + " points differ from the row model"
+                                                      : "every point matches the row model") << "\n";
+            if (mismatches) return 1;
+        }
+
+    } catch (const exception &e) {
+        cerr << "ERROR: " << e.what() << "\n";
+        return 1;
+    }
+    return 0;
+}
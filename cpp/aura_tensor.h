@@ -0,0 +1,426 @@
+// Binary tensor files (.bin) for inputs too large for the text .mem format.
+//
+// Layout: a 64 byte header followed by rows x cols elements, row-major,
+// starting at a 64 byte aligned offset so the data can be mmapped directly:
+//   char     magic[8]     "AURATNSR"
+//   uint32_t version      1 (raw) or 2 (compressed)
+//   uint32_t dtype        TensorDType
+//   uint64_t rows, cols
+//   uint64_t data_offset  64
+//   uint32_t codec        TensorCodec (0 for version 1)
+//   uint32_t block_rows   rows per compressed block (0 for version 1)
+//   (zero padding up to 64 bytes)
+// Values are little-endian; int8 tensors hold Q0.7 codes like the .mem files.
+//
+// A compressed tensor cuts the rows into blocks of block_rows, each encoded on
+// its own by aura_codec.h. At data_offset, nblocks + 1 uint64 file offsets
+// bound the blocks (block b is [index[b], index[b + 1])), so read_rows decodes
+// only the blocks it touches. view() and row_bytes() need the whole tensor
+// and decode it into memory once, on first use.
+
+#ifndef AURA_TENSOR_H
+#define AURA_TENSOR_H
+
+#include "aura_matrix.h"
+#include "aura_codec.h"
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+enum class TensorDType : uint32_t { INT8_Q07 = 0, FP32 = 1, FP64 = 2 };
+
+inline size_t dtype_size(TensorDType t) {
+    switch (t) {
+    case TensorDType::INT8_Q07: return 1;
+    case TensorDType::FP32: return 4;
+    case TensorDType::FP64: return 8;
+    }
+    throw runtime_error("Unknown tensor dtype");
+}
+
+inline const char *dtype_name(TensorDType t) {
+    switch (t) {
+    case TensorDType::INT8_Q07: return "int8";
+    case TensorDType::FP32: return "fp32";
+    case TensorDType::FP64: return "fp64";
+    }
+    return "?";
+}
+
+inline TensorDType parse_dtype(const string &s) {
+    if (s == "int8" || s == "q0.7") return TensorDType::INT8_Q07;
+    if (s == "fp32") return TensorDType::FP32;
+    if (s == "fp64") return TensorDType::FP64;
+    throw runtime_error("Unknown dtype '" + s + "' (expected int8, fp32 or fp64)");
+}
+
+enum class TensorCodec : uint32_t { NONE = 0, DELTA_BITPLANE = 1 };
+
+struct TensorHeader {
+    char magic[8] = {'A', 'U', 'R', 'A', 'T', 'N', 'S', 'R'};
+    uint32_t version = 1;
+    uint32_t dtype = 0;
+    uint64_t rows = 0;
+    uint64_t cols = 0;
+    uint64_t data_offset = 64;
+    uint32_t codec = 0;
+    uint32_t block_rows = 0;
+    uint8_t pad[16] = {};
+};
+static_assert(sizeof(TensorHeader) == 64, "tensor header layout");
+
+// rows * cols * elem_size in out; false on overflow (a crafted header)
+inline bool tensor_bytes(uint64_t rows, uint64_t cols, uint64_t elem_size, uint64_t &out) {
+    return !__builtin_mul_overflow(rows, cols, &out) && !__builtin_mul_overflow(out, elem_size, &out);
+}
+
+// ---------------------------
+// Read-only mmap of a .bin tensor
+// ---------------------------
+class MappedTensor {
+public:
+    explicit MappedTensor(const string &filename) {
+        int fd = open(filename.c_str(), O_RDONLY);
+        if (fd < 0) throw runtime_error("Cannot open " + filename);
+        struct stat st {};
+        if (fstat(fd, &st) != 0) {
+            close(fd);
+            throw runtime_error("Cannot stat " + filename);
+        }
+        size_ = (size_t)st.st_size;
+        if (size_ < sizeof(TensorHeader)) {
+            close(fd);
+            throw runtime_error("Truncated tensor header in " + filename);
+        }
+        base_ = mmap(nullptr, size_, PROT_READ, MAP_SHARED, fd, 0);
+        close(fd);
+        if (base_ == MAP_FAILED) throw runtime_error("Cannot mmap " + filename);
+
+        memcpy(&h_, base_, sizeof(h_));
+        if (memcmp(h_.magic, "AURATNSR", 8) != 0 || (h_.version != 1 && h_.version != 2))
+            fail(filename + " is not an AURA tensor file");
+        if (h_.dtype > (uint32_t)TensorDType::FP64) fail("Unknown tensor dtype in " + filename);
+        if (h_.data_offset < sizeof(TensorHeader)) fail("Bad data offset in " + filename);
+        if (!compressed()) {
+            uint64_t end;
+            if (!tensor_bytes(h_.rows, h_.cols, elem_size(), end) ||
+                __builtin_add_overflow(end, h_.data_offset, &end) || end > size_)
+                fail("Truncated tensor data in " + filename);
+            return;
+        }
+        if (h_.codec != (uint32_t)TensorCodec::DELTA_BITPLANE || h_.block_rows == 0)
+            fail("Unknown tensor codec in " + filename);
+        uint64_t decoded, index_end;
+        if (!tensor_bytes(h_.rows, h_.cols, elem_size(), decoded) ||
+            __builtin_add_overflow(num_blocks(), 1, &index_end) ||
+            __builtin_mul_overflow(index_end, sizeof(uint64_t), &index_end) ||
+            __builtin_add_overflow(index_end, h_.data_offset, &index_end) || index_end > size_)
+            fail("Truncated block index in " + filename);
+        index_ = (const uint64_t *)((const uint8_t *)base_ + h_.data_offset);
+        // blocks follow the index and never overlap it or the header
+        if (index_[0] < index_end) fail("Corrupt block index in " + filename);
+        for (size_t b = 0; b < num_blocks(); ++b)
+            if (index_[b] > index_[b + 1]) fail("Corrupt block index in " + filename);
+        if (index_[num_blocks()] > size_) fail("Truncated tensor data in " + filename);
+    }
+    ~MappedTensor() {
+        if (base_ && base_ != MAP_FAILED) munmap(base_, size_);
+    }
+    MappedTensor(const MappedTensor &) = delete;
+    MappedTensor &operator=(const MappedTensor &) = delete;
+
+    TensorDType dtype() const { return (TensorDType)h_.dtype; }
+    size_t elem_size() const { return dtype_size(dtype()); }
+    size_t rows() const { return h_.rows; }
+    size_t cols() const { return h_.cols; }
+    bool compressed() const { return h_.version == 2; }
+    size_t block_rows() const { return compressed() ? h_.block_rows : h_.rows; }
+    size_t num_blocks() const {
+        return compressed() ? h_.rows / h_.block_rows + (h_.rows % h_.block_rows != 0) : 1;
+    }
+    // bytes of tensor data in the file (the compressed blocks and their index)
+    size_t stored_bytes() const {
+        return compressed() ? index_[num_blocks()] - h_.data_offset : h_.rows * h_.cols * elem_size();
+    }
+
+    const uint8_t *row_bytes(size_t r) const {
+        const size_t row = h_.cols * elem_size();
+        if (compressed()) return decoded() + r * row;
+        return (const uint8_t *)base_ + h_.data_offset + r * row;
+    }
+
+    // Zero-copy view of the mapped data; T must be the stored type
+    // (int8_t for Q0.7 codes, float, double). Rows start 64-byte aligned
+    // whenever a row is a whole number of cache lines. A compressed tensor
+    // is decoded in full first.
+    template <class T>
+    MatrixView<const T> view() const {
+        if (sizeof(T) != elem_size() || is_integral_v<T> != (dtype() == TensorDType::INT8_Q07))
+            throw runtime_error(string("Cannot view a ") + dtype_name(dtype()) + " tensor as this type");
+        return MatrixView<const T>((const T *)row_bytes(0), h_.rows, h_.cols);
+    }
+
+    // block b of a compressed tensor, in the stored dtype, into out
+    // (block_rows() x cols() elements, fewer for the last block)
+    void decode_block(size_t b, void *out) const {
+        if (!compressed()) throw runtime_error("decode_block on an uncompressed tensor");
+        if (b >= num_blocks())
+            throw runtime_error("Tensor block " + to_string(b) + " out of range (" + to_string(num_blocks()) + " blocks)");
+        StatScope scope("decode");
+        const size_t r0 = b * h_.block_rows, n = min<size_t>(h_.block_rows, h_.rows - r0) * h_.cols;
+        const uint8_t *p = (const uint8_t *)base_ + index_[b];
+        const size_t len = index_[b + 1] - index_[b];
+        stats_count(STAT_BYTES_READ, len);
+        bool ok = false;
+        switch (elem_size()) {
+        case 1: ok = codec_decode_block(p, len, n, h_.cols, (uint8_t *)out); break;
+        case 4: ok = codec_decode_block(p, len, n, h_.cols, (uint32_t *)out); break;
+        case 8: ok = codec_decode_block(p, len, n, h_.cols, (uint64_t *)out); break;
+        }
+        if (!ok) throw runtime_error("Corrupt tensor block " + to_string(b));
+    }
+
+    // rows [begin, begin + n) in the stored dtype
+    void read_raw_rows(size_t begin, size_t n, void *out) const {
+        check_row_range(begin, n);
+        const size_t row = h_.cols * elem_size();
+        if (!compressed() || decoded_) {
+            if (!compressed()) stats_count(STAT_BYTES_READ, n * row);
+            memcpy(out, row_bytes(begin), n * row);
+            return;
+        }
+        for_blocks(begin, n, [&](const uint8_t *src, size_t r, size_t m) {
+            memcpy((uint8_t *)out + (r - begin) * row, src, m * row);
+        });
+    }
+
+    // rows [begin, begin + n) converted to real values (int8 -> Q0.7)
+    template <class T>
+    void read_rows(size_t begin, size_t n, T *out) const {
+        check_row_range(begin, n);
+        if (!compressed() || decoded_) {
+            if (!compressed()) stats_count(STAT_BYTES_READ, n * h_.cols * elem_size());
+            convert(row_bytes(begin), n * h_.cols, out);
+            return;
+        }
+        for_blocks(begin, n, [&](const uint8_t *src, size_t r, size_t m) {
+            convert(src, m * h_.cols, out + (r - begin) * h_.cols);
+        });
+    }
+
+    // tell the kernel the file is read front to back
+    void advise_sequential() const { madvise(base_, size_, MADV_SEQUENTIAL); }
+
+private:
+    TensorHeader h_;
+    void *base_ = nullptr;
+    size_t size_ = 0;
+    const uint64_t *index_ = nullptr;
+    mutable aligned_vector<uint8_t> decoded_buf_;
+    mutable atomic<bool> decoded_{false};
+    mutable once_flag decode_once_;
+
+    [[noreturn]] void fail(const string &msg) {
+        munmap(base_, size_);
+        base_ = nullptr;
+        throw runtime_error(msg);
+    }
+
+    void check_row_range(size_t begin, size_t n) const {
+        if (begin > h_.rows || n > h_.rows - begin)
+            throw runtime_error("Cannot read " + to_string(n) + " rows at row " + to_string(begin) + " of a " +
+                                to_string(h_.rows) + "-row tensor");
+    }
+
+    // the whole compressed tensor, decoded on first use
+    const uint8_t *decoded() const {
+        call_once(decode_once_, [&] {
+            const size_t block = h_.block_rows * h_.cols * elem_size();
+            decoded_buf_.resize(h_.rows * h_.cols * elem_size());
+            for (size_t b = 0; b < num_blocks(); ++b) decode_block(b, decoded_buf_.data() + b * block);
+            decoded_ = true;
+        });
+        return decoded_buf_.data();
+    }
+
+    // f(rows, first row, row count) for each block overlapping [begin, begin + n),
+    // decoded into the thread's scratch arena
+    template <class F>
+    void for_blocks(size_t begin, size_t n, F f) const {
+        if (n == 0) return;
+        const size_t br = h_.block_rows;
+        ScratchScope scratch;
+        uint8_t *buf = scratch.alloc<uint8_t>(br * h_.cols * elem_size());
+        for (size_t b = begin / br; b * br < begin + n; ++b) {
+            decode_block(b, buf);
+            const size_t r0 = max(begin, b * br), r1 = min(begin + n, (b + 1) * br);
+            f(buf + (r0 - b * br) * h_.cols * elem_size(), r0, r1 - r0);
+        }
+    }
+
+    template <class T>
+    void convert(const uint8_t *p, size_t count, T *out) const {
+        switch (dtype()) {
+        case TensorDType::INT8_Q07:
+            for (size_t i = 0; i < count; ++i) out[i] = T((int8_t)p[i]) / T(AURA_Q_FACTOR);
+            break;
+        case TensorDType::FP32:
+            for (size_t i = 0; i < count; ++i) {
+                float f;
+                memcpy(&f, p + 4 * i, 4);
+                out[i] = T(f);
+            }
+            break;
+        case TensorDType::FP64:
+            for (size_t i = 0; i < count; ++i) {
+                double d;
+                memcpy(&d, p + 8 * i, 8);
+                out[i] = T(d);
+            }
+            break;
+        }
+    }
+};
+
+// ---------------------------
+// Writer: header first, rows written at their offsets (safe from several threads)
+// ---------------------------
+class TensorWriter {
+public:
+    TensorWriter(const string &filename, TensorDType dtype, size_t rows, size_t cols)
+        : filename_(filename) {
+        h_.dtype = (uint32_t)dtype;
+        h_.rows = rows;
+        h_.cols = cols;
+        fd_ = open(filename.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+        if (fd_ < 0) throw runtime_error("Cannot open for writing " + filename);
+        if (ftruncate(fd_, h_.data_offset + rows * cols * dtype_size(dtype)) != 0 ||
+            pwrite(fd_, &h_, sizeof(h_), 0) != (ssize_t)sizeof(h_))
+            throw runtime_error("Cannot write " + filename);
+    }
+    ~TensorWriter() {
+        if (fd_ >= 0) close(fd_);
+    }
+    TensorWriter(const TensorWriter &) = delete;
+    TensorWriter &operator=(const TensorWriter &) = delete;
+
+    // rows [begin, begin + n) from values already in the file's dtype
+    void write_rows(size_t begin, size_t n, const void *data) {
+        size_t row = h_.cols * dtype_size((TensorDType)h_.dtype);
+        const char *p = (const char *)data;
+        size_t left = n * row;
+        off_t off = h_.data_offset + begin * row;
+        stats_count(STAT_BYTES_WRITTEN, left);
+        while (left > 0) {
+            ssize_t w = pwrite(fd_, p, left, off);
+            if (w <= 0) throw runtime_error("Cannot write " + filename_);
+            p += w;
+            off += w;
+            left -= (size_t)w;
+        }
+    }
+
+private:
+    string filename_;
+    TensorHeader h_;
+    int fd_ = -1;
+};
+
+// ---------------------------
+// Compressed writer: rows appended in order, each full block encoded and written
+// ---------------------------
+class CompressedTensorWriter {
+public:
+    CompressedTensorWriter(const string &filename, TensorDType dtype, size_t rows, size_t cols,
+                           size_t block_rows = 64)
+        : filename_(filename) {
+        if (block_rows == 0 || block_rows > UINT32_MAX) throw runtime_error("Bad block size for " + filename);
+        h_.version = 2;
+        h_.dtype = (uint32_t)dtype;
+        h_.rows = rows;
+        h_.cols = cols;
+        h_.codec = (uint32_t)TensorCodec::DELTA_BITPLANE;
+        h_.block_rows = (uint32_t)block_rows;
+        index_.push_back(h_.data_offset + ((rows + block_rows - 1) / block_rows + 1) * sizeof(uint64_t));
+        fd_ = open(filename.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+        if (fd_ < 0) throw runtime_error("Cannot open for writing " + filename);
+        if (pwrite(fd_, &h_, sizeof(h_), 0) != (ssize_t)sizeof(h_)) throw runtime_error("Cannot write " + filename);
+    }
+    ~CompressedTensorWriter() {
+        if (fd_ >= 0) close(fd_);
+    }
+    CompressedTensorWriter(const CompressedTensorWriter &) = delete;
+    CompressedTensorWriter &operator=(const CompressedTensorWriter &) = delete;
+
+    // the next n rows, in the file's dtype
+    void append_rows(size_t n, const void *data) {
+        const size_t row = h_.cols * dtype_size((TensorDType)h_.dtype);
+        if (written_ + n > h_.rows) throw runtime_error("Too many rows for " + filename_);
+        const uint8_t *p = (const uint8_t *)data;
+        while (n > 0) {
+            size_t take = min<size_t>(n, h_.block_rows - pending_rows_);
+            pending_.insert(pending_.end(), p, p + take * row);
+            pending_rows_ += take;
+            written_ += take;
+            p += take * row;
+            n -= take;
+            if (pending_rows_ == h_.block_rows || written_ == h_.rows) flush_block();
+        }
+    }
+
+    // writes the block index; every row must have been appended
+    void finish() {
+        if (written_ != h_.rows) throw runtime_error("Missing rows in " + filename_);
+        write_at(index_.data(), index_.size() * sizeof(uint64_t), h_.data_offset);
+    }
+
+    size_t bytes() const { return index_.back(); }
+
+private:
+    string filename_;
+    TensorHeader h_;
+    int fd_ = -1;
+    size_t written_ = 0, pending_rows_ = 0;
+    vector<uint8_t> pending_, encoded_;
+    vector<uint64_t> index_;   // block offsets, one past the last block at the end
+
+    void flush_block() {
+        StatScope scope("encode");
+        const size_t n = pending_rows_ * h_.cols;
+        encoded_.clear();
+        switch (dtype_size((TensorDType)h_.dtype)) {
+        case 1: codec_encode_block((const uint8_t *)pending_.data(), n, h_.cols, encoded_); break;
+        case 4: codec_encode_block((const uint32_t *)pending_.data(), n, h_.cols, encoded_); break;
+        case 8: codec_encode_block((const uint64_t *)pending_.data(), n, h_.cols, encoded_); break;
+        }
+        write_at(encoded_.data(), encoded_.size(), index_.back());
+        index_.push_back(index_.back() + encoded_.size());
+        pending_.clear();
+        pending_rows_ = 0;
+    }
+
+    void write_at(const void *data, size_t left, off_t off) {
+        const char *p = (const char *)data;
+        stats_count(STAT_BYTES_WRITTEN, left);
+        while (left > 0) {
+            ssize_t w = pwrite(fd_, p, left, off);
+            if (w <= 0) throw runtime_error("Cannot write " + filename_);
+            p += w;
+            off += w;
+            left -= (size_t)w;
+        }
+    }
+};
+
+// Whole tensor in one call (small files)
+template <class T>
+void write_tensor(const string &filename, TensorDType dtype, size_t rows, size_t cols,
+                  const vector<T> &data) {
+    if (data.size() != rows * cols || sizeof(T) != dtype_size(dtype))
+        throw runtime_error("Tensor size does not match " + filename);
+    TensorWriter(filename, dtype, rows, cols).write_rows(0, rows, data.data());
+}
+
+#endif // AURA_TENSOR_H
@@ -8,6 +8,7 @@
 #include <algorithm>
 #include <cstdint>
 #include <string.h>
+#include "aura_hex.h"
 
 using namespace std;
 
@@ -24,6 +25,8 @@ static constexpr double Q_FACTOR = 32768.0; // Q0.15 scaling
 // Read FP32 .mem (big-endian text → little endian bits → float)
 // ---------------------------
 vector<float> read_fp32_mem(const string &filename) {
+    StatScope scope("parse");
+    stats_count_file(filename);
     ifstream fin(filename);
     if (!fin) throw runtime_error("Cannot open " + filename);
 
@@ -57,6 +60,8 @@ vector<float> read_fp32_mem(const string &filename) {
 // Quantize FP32 → int16 (Q0.15)
 // ---------------------------
 vector<int16_t> quantize_fp32_to_int16(const vector<float>& data) {
+    StatScope scope("quantize");
+    stats_count(STAT_ELEMENTS, data.size());
     vector<int16_t> result(data.size());
 
     for (size_t i = 0; i < data.size(); i++) {
@@ -74,49 +79,43 @@ vector<int16_t> quantize_fp32_to_int16(const vector<float>& data) {
 // Write int16 .mem file (pack 8 × int16 = 16 bytes per line)
 // ---------------------------
 void write_int16_mem(const vector<int16_t>& data, const string &filename) {
-    ofstream fout(filename);
-    if (!fout) throw runtime_error("Cannot open for writing " + filename);
+    HexWriter out(filename, ROWS * LINES_PER_ROW * 17);
 
-    for (int r = 0; r < ROWS; ++r) {
-        for (int l = 0; l < LINES_PER_ROW; ++l) {
-
-            uint64_t packed = 0;
-
-            for (int e = 0; e < ELTS_PER_LINE; ++e) {
-                uint16_t val = uint16_t(data[r * COLS + l * ELTS_PER_LINE + e]);
-                packed |= (uint64_t(val) << (16 * e)); // little-endian packing
-            }
-
-            // Output 64 bits = 16 hex chars
-            ostringstream ss;
-            ss << uppercase << hex << setfill('0') << setw(16) << packed;
-            fout << ss.str() << "\n";
-        }
-    }
+    for (int r = 0; r < ROWS; ++r)
+        for (int l = 0; l < LINES_PER_ROW; ++l)
+            out.word64(pack_word(&data[r * COLS + l * ELTS_PER_LINE]));  // little-endian packing
+    out.close();
 }
 
 // ---------------------------
 // Main
 // ---------------------------
 int main(int argc, char **argv) {
+    stats_init(argc, argv);
 
     if (argc != 3) {
         cerr << "Usage: " << argv[0] << " <input_fp32.mem> <output_int16.mem>\n";
         return 1;
     }
 
-    string input = argv[1];
-    string output = argv[2];
+    try {
+        string input = argv[1];
+        string output = argv[2];
+
+        cout << "Reading: " << input << "\n";
+        auto fp32 = read_fp32_mem(input);
 
-    cout << "Reading: " << input << "\n";
-    auto fp32 = read_fp32_mem(input);
+        cout << "Quantizing to int16...\n";
+        auto int16data = quantize_fp32_to_int16(fp32);
 
-    cout << "Quantizing to int16...\n";
-    auto int16data = quantize_fp32_to_int16(fp32);
+        cout << "Writing: " << output << "\n";
+        write_int16_mem(int16data, output);
 
-    cout << "Writing: " << output << "\n";
-    write_int16_mem(int16data, output);
+        cout << "Done.\n";
+    } catch (const exception &e) {
+        cerr << "ERROR: " << e.what() << "\n";
+        return 1;
+    }
 
-    cout << "Done.\n";
     return 0;
 }
@@ -8,6 +8,7 @@
 #include <algorithm>
 #include <cstdint>
 #include <string.h>
+#include "aura_hex.h"
 
 using namespace std;
 
@@ -20,6 +21,8 @@ static constexpr double Q_FACTOR = 128;
 // Read FP32 .mem (big-endian text -> little endian bits -> float)
 // ---------------------------
 vector<float> read_fp32_mem(const string &filename) {
+    StatScope scope("parse");
+    stats_count_file(filename);
     ifstream fin(filename);
     if (!fin) throw runtime_error("Cannot open " + filename);
 
@@ -54,6 +57,8 @@ vector<float> read_fp32_mem(const string &filename) {
 // Quantize FP32 to int8 (Q0.7)
 // ---------------------------
 vector<int8_t> quantize_fp32_to_int8(const vector<float>& data) {
+    StatScope scope("quantize");
+    stats_count(STAT_ELEMENTS, data.size());
     vector<int8_t> result(data.size());
 
     for (size_t i = 0; i < data.size(); i++) {
@@ -69,47 +74,43 @@ vector<int8_t> quantize_fp32_to_int8(const vector<float>& data) {
 // Write int8 .mem file
 // ---------------------------
 void write_int8_mem(const vector<int8_t>& data, const string &filename) {
-    ofstream fout(filename);
-    if (!fout) throw runtime_error("Cannot open for writing " + filename);
+    HexWriter out(filename, ROWS * LINES_PER_ROW * 17);
 
-    for (int r = 0; r < ROWS; ++r) {
-        for (int l = 0; l < LINES_PER_ROW; ++l) {
-            uint64_t packed = 0;
-
-            for (int b = 0; b < 8; ++b) {
-                uint64_t byte = uint8_t(data[r * COLS + l * 8 + b]);
-                packed |= (byte << (8 * b)); // little-endian
-            }
-
-            ostringstream ss;
-            ss << uppercase << hex << setfill('0') << setw(16) << packed;
-            fout << ss.str() << "\n";
-        }
-    }
+    for (int r = 0; r < ROWS; ++r)
+        for (int l = 0; l < LINES_PER_ROW; ++l)
+            out.word64(pack_word(&data[r * COLS + l * 8]));  // little-endian
+    out.close();
 }
 
 // ---------------------------
 // Main
 // ---------------------------
 int main(int argc, char **argv) {
+    stats_init(argc, argv);
 
     if (argc != 3) {
         cerr << "Usage: " << argv[0] << " <input_fp32.mem> <output_int8.mem>\n";
         return 1;
     }
 
-    string input = argv[1];
-    string output = argv[2];
+    try {
+        string input = argv[1];
+        string output = argv[2];
 
-    cout << "Reading: " << input << "\n";
-    auto fp32 = read_fp32_mem(input);
+        cout << "Reading: " << input << "\n";
+        auto fp32 = read_fp32_mem(input);
 
-    cout << "Quantizing to int8...\n";
-    auto int8data = quantize_fp32_to_int8(fp32);
+        cout << "Quantizing to int8...\n";
+        auto int8data = quantize_fp32_to_int8(fp32);
 
-    cout << "Writing: " << output << "\n";
-    write_int8_mem(int8data, output);
+        cout << "Writing: " << output << "\n";
+        write_int8_mem(int8data, output);
+
+        cout << "Done.\n";
+    } catch (const exception &e) {
+        cerr << "ERROR: " << e.what() << "\n";
+        return 1;
+    }
 
-    cout << "Done.\n";
     return 0;
 }
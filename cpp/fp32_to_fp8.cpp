@@ -0,0 +1,149 @@
+#include <iostream>
+#include <fstream>
+#include <vector>
+#include <string>
+#include <sstream>
+#include <iomanip>
+#include <cmath>
+#include <algorithm>
+#include <cstdint>
+#include <string.h>
+
+#include "aura_fp8.h"
+#include "aura_hex.h"
+
+using namespace std;
+
+static constexpr int ROWS = 512;
+static constexpr int COLS = 64;
+static constexpr int LINES_PER_ROW = COLS / 8;
+static constexpr double Q_FACTOR = 128;
+
+// ---------------------------
+// Read FP32 .mem (big-endian text -> little endian bits -> float)
+// ---------------------------
+vector<float> read_fp32_mem(const string &filename) {
+    StatScope scope("parse");
+    stats_count_file(filename);
+    ifstream fin(filename);
+    if (!fin) throw runtime_error("Cannot open " + filename);
+
+    vector<float> data;
+    string line;
+
+    while (getline(fin, line)) {
+        line.erase(remove_if(line.begin(), line.end(), ::isspace), line.end());
+
+        for (size_t i = 0; i + 8 <= line.size(); i += 8) {
+            // text holds the float bytes in memory order -> swap after parsing
+            uint32_t bits = __builtin_bswap32(stoul(line.substr(i, 8), nullptr, 16));
+
+            float f;
+            memcpy(&f, &bits, sizeof(float));
+            data.push_back(f);
+        }
+    }
+
+    if (data.size() != ROWS * COLS)
+        throw runtime_error("Unexpected number of FP32 values in " + filename);
+
+    return data;
+}
+
+// ---------------------------
+// Write FP8 .mem file (same packing as the int8 files)
+// ---------------------------
+void write_fp8_mem(const vector<uint8_t>& data, const string &filename) {
+    HexWriter out(filename, ROWS * LINES_PER_ROW * 17);
+
+    for (int r = 0; r < ROWS; ++r)
+        for (int l = 0; l < LINES_PER_ROW; ++l)
+            out.word64(pack_word(&data[r * COLS + l * 8]));  // little-endian
+    out.close();
+}
+
+// ---------------------------
+// Encoding error of one 8-bit representation against the FP32 source
+// ---------------------------
+struct EncodeError {
+    double mae = 0.0;
+    double rmse = 0.0;
+    double max_abs = 0.0;
+    int clipped = 0;
+};
+
+EncodeError encode_error(const vector<float> &ref, const vector<float> &decoded, float limit) {
+    EncodeError e;
+    for (size_t i = 0; i < ref.size(); ++i) {
+        double err = fabs((double)decoded[i] - (double)ref[i]);
+        e.mae += err;
+        e.rmse += err * err;
+        e.max_abs = max(e.max_abs, err);
+        if (fabs(ref[i]) > limit) e.clipped++;
+    }
+    e.mae /= ref.size();
+    e.rmse = sqrt(e.rmse / ref.size());
+    return e;
+}
+
+// ---------------------------
+// Main
+// ---------------------------
+int main(int argc, char **argv) {
+    stats_init(argc, argv);
+
+    if (argc != 4) {
+        cerr << "Usage: " << argv[0] << " <e4m3|e5m2> <input_fp32.mem> <output_fp8.mem>\n";
+        return 1;
+    }
+
+    try {
+        Fp8Format fmt = parse_fp8_format(argv[1]);
+        string input = argv[2];
+        string output = argv[3];
+
+        cout << "Reading: " << input << "\n";
+        auto fp32 = read_fp32_mem(input);
+
+        cout << "Encoding to " << fp8_name(fmt) << "...\n";
+        vector<uint8_t> fp8data(fp32.size());
+        {
+            StatScope scope("quantize");
+            stats_count(STAT_ELEMENTS, fp32.size());
+            fp32_to_fp8_n(fp32.data(), fp8data.data(), fp32.size(), fmt);
+        }
+
+        cout << "Writing: " << output << "\n";
+        write_fp8_mem(fp8data, output);
+
+        // Compare every 8-bit representation at equal bandwidth
+        vector<float> decoded(fp32.size());
+        cout << "===== Input Encoding Error vs FP32 =====\n";
+        cout << left << setw(8) << "format" << setw(14) << "MAE" << setw(14) << "RMSE"
+             << setw(14) << "max abs" << "clipped\n";
+
+        for (size_t i = 0; i < fp32.size(); ++i) {
+            long q = lround(fp32[i] * Q_FACTOR);
+            q = min(127L, max(-128L, q));
+            decoded[i] = q / (float)Q_FACTOR;
+        }
+        auto print = [&](const char *name, const EncodeError &e) {
+            cout << left << setw(8) << name << setw(14) << e.mae << setw(14) << e.rmse
+                 << setw(14) << e.max_abs << e.clipped << "\n";
+        };
+        print("q0.7", encode_error(fp32, decoded, 127.0f / 128.0f));
+
+        for (Fp8Format f : {Fp8Format::E4M3, Fp8Format::E5M2}) {
+            vector<uint8_t> codes(fp32.size());
+            fp32_to_fp8_n(fp32.data(), codes.data(), fp32.size(), f);
+            fp8_to_fp32_n(codes.data(), decoded.data(), codes.size(), f);
+            print(fp8_name(f), encode_error(fp32, decoded, fp8_traits(f).max_value));
+        }
+
+        cout << "Done.\n";
+    } catch (const exception &e) {
+        cerr << "ERROR: " << e.what() << "\n";
+        return 1;
+    }
+    return 0;
+}
@@ -3,37 +3,38 @@
 #include <iomanip>
 #include <random>
 #include <filesystem>
+#include "aura_hex.h"
 
 void generate_mem(const std::string &filename, int rows) {
-    std::ofstream outfile(filename);
-    if (!outfile) {
-        std::cerr << "Error: could not create file " << filename << "\n";
-        return;
-    }
-
     std::random_device rd;
     std::mt19937_64 gen(rd());
     std::uniform_int_distribution<uint64_t> dist(0, UINT64_MAX);
 
-    for (int i = 0; i < rows; ++i) {
-        uint64_t value = dist(gen);
-        outfile << std::uppercase
-                << std::hex << std::setw(16) << std::setfill('0')
-                << value << std::endl;
+    try {
+        HexWriter outfile(filename, (size_t)rows * 17);
+        for (int i = 0; i < rows; ++i) outfile.word64(dist(gen));
+        outfile.close();
+    } catch (const std::exception &e) {
+        std::cerr << "Error: could not create file " << filename << "\n";
+        return;
     }
-
-    outfile.close();
     std::cout << "Generated " << filename << " with " << rows << " rows.\n";
 }
 
-int main() {
+int main(int argc, char **argv) {
+    stats_init(argc, argv);
     const int ROWS = 512*8;
 
-    std::filesystem::create_directories("../models/random");
+    try {
+        std::filesystem::create_directories("../models/random");
 
-    generate_mem("../models/random/Q.mem", ROWS);
-    generate_mem("../models/random/K.mem", ROWS);
-    generate_mem("../models/random/V.mem", ROWS);
+        generate_mem("../models/random/Q.mem", ROWS);
+        generate_mem("../models/random/K.mem", ROWS);
+        generate_mem("../models/random/V.mem", ROWS);
+    } catch (const std::exception &e) {
+        std::cerr << "ERROR: " << e.what() << "\n";
+        return 1;
+    }
 
     return 0;
 }
\ No newline at end of file
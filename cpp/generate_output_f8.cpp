@@ -1,5 +1,7 @@
 #include <bits/stdc++.h>
 #include <cmath>
+#include "aura_matrix.h"
+#include "aura_hex.h"
 using namespace std;
 
 static constexpr int ROWS = 512;
@@ -12,7 +14,9 @@ static constexpr int32_t DOT_SCALE = 1 << 8;  // adjust for precision
 // softmax scale factor (to keep sum <= 255)
 static constexpr int32_t SOFTMAX_SCALE = 1 << 8;
 
-vector<vector<int8_t>> read_mem_matrix_8(const string &filename) {
+Matrix<int8_t> read_mem_matrix_8(const string &filename) {
+    StatScope scope("parse");
+    stats_count_file(filename);
     ifstream ifs(filename);
     if (!ifs) throw runtime_error("Cannot open " + filename);
     vector<uint64_t> lines;
@@ -32,38 +36,39 @@ vector<vector<int8_t>> read_mem_matrix_8(const string &filename) {
     if ((int)lines.size() != ROWS * LINES_PER_ROW)
         throw runtime_error("Incorrect line count");
 
-    vector<vector<int8_t>> M(ROWS, vector<int8_t>(COLS));
+    Matrix<int8_t> M(ROWS, COLS);
     for (int r = 0; r < ROWS; ++r) {
         int base_line = r * LINES_PER_ROW;
+        int8_t *row = M.row(r);
         int out_index = 0;
         for (int l = 0; l < LINES_PER_ROW; ++l) {
             uint64_t val = lines[base_line + l];
             for (int b = 0; b < 8; ++b) {
                 int8_t byte = (int8_t)((val >> (8*b)) & 0xFF);
-                M[r][out_index++] = byte;
+                row[out_index++] = byte;
             }
         }
     }
     return M;
 }
 
-void write_mem_matrix(const string &filename, const vector<vector<int8_t>> &M) {
-    ofstream ofs(filename);
-    if (!ofs) throw runtime_error("Cannot open " + filename);
+void write_mem_matrix(const string &filename, const Matrix<int8_t> &M) {
+    HexWriter out(filename, ROWS * LINES_PER_ROW * 17);
     for (int r = 0; r < ROWS; ++r) {
         for (int l = 0; l < LINES_PER_ROW; ++l) {
             uint64_t packed = 0;
             for (int b = 0; b < 8; ++b) {
-                uint64_t byte = M[r][l*8 + b];
+                uint64_t byte = M(r, l*8 + b);
                 packed |= (byte & 0xFFULL) << (8*b);
             }
-            ofs << hex << uppercase << setw(16) << setfill('0') << packed << "\n";
+            out.word64(packed);
         }
     }
+    out.close();
 }
 
 // fixed-point dot product: Q[i]*K[j], accumulate in int32
-inline int32_t dot8(const vector<int8_t> &a, const vector<int8_t> &b) {
+inline int32_t dot8(const int8_t *a, const int8_t *b) {
     int32_t s = 0;
     for (int i = 0; i < COLS; ++i)
         s += ((int32_t)a[i]) * ((int32_t)b[i]);
@@ -92,34 +97,42 @@ void softmax_fixed(const vector<int32_t> &scores, vector<int16_t> &weights) {
 }
 
 
-int main() {
-    auto Q = read_mem_matrix_8("../mem/random_test1/Q.mem");
-    auto K = read_mem_matrix_8("../mem/random_test1/K.mem");
-    auto V = read_mem_matrix_8("../mem/random_test1/V.mem");
+int main(int argc, char **argv) {
+    stats_init(argc, argv);
+    try {
+        auto Q = read_mem_matrix_8("../mem/random_test1/Q.mem");
+        auto K = read_mem_matrix_8("../mem/random_test1/K.mem");
+        auto V = read_mem_matrix_8("../mem/random_test1/V.mem");
 
-    vector<vector<int8_t>> O_bytes(ROWS, vector<int8_t>(COLS,0));
+        Matrix<int8_t> O_bytes(ROWS, COLS);
 
-    vector<int32_t> scores(ROWS);  
-    vector<int16_t> weights(ROWS);
+        vector<int32_t> scores(ROWS);  
+        vector<int16_t> weights(ROWS);
 
-    for (int i = 0; i < ROWS; ++i) {
-        // compute Q*K dot
-        for (int j = 0; j < ROWS; ++j)
-            scores[j] = dot8(Q[i], K[j]);
+        for (int i = 0; i < ROWS; ++i) {
+            StatScope scope("reference");
+            stats_count(STAT_ROWS, 1);
+            // compute Q*K dot
+            for (int j = 0; j < ROWS; ++j)
+                scores[j] = dot8(Q.row(i), K.row(j));
 
-        softmax_fixed(scores, weights);
+            softmax_fixed(scores, weights);
 
-        // weighted sum V
-        for (int j = 0; j < ROWS; ++j) {
-            int w = weights[j]; // 0..255
-            for (int d = 0; d < COLS; ++d) {
-                int32_t tmp = w * V[j][d];
-                O_bytes[i][d] = min(255, O_bytes[i][d] + (tmp >> 8)); // scale back
+            // weighted sum V
+            for (int j = 0; j < ROWS; ++j) {
+                int w = weights[j]; // 0..255
+                for (int d = 0; d < COLS; ++d) {
+                    int32_t tmp = w * V(j, d);
+                    O_bytes(i, d) = min(255, O_bytes(i, d) + (tmp >> 8)); // scale back
+                }
             }
+
+            if ((i%64)==0) cerr<<"Row "<<i<<"\n";
         }
 
-        if ((i%64)==0) cerr<<"Row "<<i<<"\n";
+        write_mem_matrix("../mem/random_test1/O_correct.mem", O_bytes);
+    } catch (const exception &e) {
+        cerr << "ERROR: " << e.what() << "\n";
+        return 1;
     }
-
-    write_mem_matrix("../mem/random_test1/O_correct.mem", O_bytes);
 }
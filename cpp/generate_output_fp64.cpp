@@ -1,4 +1,7 @@
 #include <bits/stdc++.h>
+#include "aura_matrix.h"
+#include "aura_hex.h"
+#include "aura_cache.h"
 using namespace std;
 
 static constexpr int ROWS = 512;      // number of matrix rows
@@ -8,7 +11,9 @@ static constexpr double SCALE = 1.0 / sqrt((double)COLS);
 static constexpr double Q_FACTOR = 128;
 
 // read a mem file (lines of 16-hex chars) and return a ROWS x COLS matrix (float)
-vector<vector<double>> read_mem_matrix(const string &filename) {
+Matrix<double> read_mem_matrix(const string &filename) {
+    StatScope scope("parse");
+    stats_count_file(filename);
     ifstream ifs(filename);
     if (!ifs) throw runtime_error("Cannot open " + filename);
     // read all lines into vector<uint64_t>
@@ -37,16 +42,17 @@ vector<vector<double>> read_mem_matrix(const string &filename) {
     }
 
     // build matrix
-    vector<vector<double>> M(ROWS, vector<double>(COLS));
+    Matrix<double> M(ROWS, COLS);
     for (int r = 0; r < ROWS; ++r) {
         int base_line = r * LINES_PER_ROW;
+        double *row = M.row(r);
         int out_index = 0;
         for (int l = 0; l < LINES_PER_ROW; ++l) {
             uint64_t val = lines[base_line + l];
             // extract bytes little-endian: byte0 = LSB
             for (int b = 0; b < 8; ++b) {
                 int8_t byte = (int8_t)((val >> (8*b)) & 0xFF);
-                M[r][out_index++] = double(byte) / Q_FACTOR;
+                row[out_index++] = double(byte) / Q_FACTOR;
             }
         }
         if (out_index != COLS) throw runtime_error("internal indexing error");
@@ -55,37 +61,34 @@ vector<vector<double>> read_mem_matrix(const string &filename) {
 }
 
 // write a ROWS x COLS matrix of unsigned bytes into output file (same packed format)
-void write_mem_matrix(const string &filename, const vector<vector<double>> &M) {
-    ofstream ofs(filename);
-    if (!ofs) throw runtime_error("Cannot open for writing " + filename);
+void write_mem_matrix(const string &filename, const Matrix<double> &M) {
+    HexWriter out(filename, ROWS * LINES_PER_ROW * 17);
     // For each row, write LINES_PER_ROW lines, packing 8 bytes per line with LSB-first byte0
     for (int r = 0; r < ROWS; ++r) {
         int base = 0;
         for (int l = 0; l < LINES_PER_ROW; ++l) {
             uint64_t packed = 0;
             for (int b = 0; b < 8; ++b) {
-                long long iv = (long long)lround(M[r][l*8 + b] * Q_FACTOR);
+                long long iv = (long long)lround(M(r, l*8 + b) * Q_FACTOR);
                 if (iv < -128) iv = -128;
                 if (iv > 127) iv = 127;
                 uint64_t byte = (uint64_t(int8_t(iv)));
                 packed |= (byte & 0xFFULL) << (8*b); // LSB-first
             }
             // print as 16 hex chars uppercase
-            std::ostringstream ss;
-            ss << std::uppercase << std::hex << std::setfill('0') << std::setw(16) << packed;
-            ofs << ss.str() << '\n';
+            out.word64(packed);
         }
     }
-    ofs.close();
+    out.close();
 }
 
 // pretty-print a matrix in human readable format
-void print_matrix(const vector<vector<double>> &M, const string &name) {
-    cout << "===== Matrix: " << name << " (" << M.size() << " x " << M[0].size() << ") =====\n";
-    for (size_t r = 0; r < M.size(); ++r) {
-        for (size_t c = 0; c < M[r].size(); ++c) {
-            cout << (int)M[r][c];
-            if (c + 1 != M[r].size()) cout << ", ";
+void print_matrix(const Matrix<double> &M, const string &name) {
+    cout << "===== Matrix: " << name << " (" << M.rows() << " x " << M.cols() << ") =====\n";
+    for (size_t r = 0; r < M.rows(); ++r) {
+        for (size_t c = 0; c < M.cols(); ++c) {
+            cout << (int)M(r, c);
+            if (c + 1 != M.cols()) cout << ", ";
         }
         cout << "\n";
     }
@@ -93,13 +96,13 @@ void print_matrix(const vector<vector<double>> &M, const string &name) {
 }
 
 // pretty-print a matrix in hex (each entry is a byte 0..255)
-void print_matrix_hex(const vector<vector<double>> &M, const string &name) {
-    cout << "===== Matrix: " << name << " (" << M.size() << " x " << M[0].size() << ") =====\n";
-    for (size_t r = 0; r < M.size(); ++r) {
-        for (size_t c = 0; c < M[r].size(); ++c) {
-            int8_t v = (int8_t)M[r][c];       // convert back to byte
+void print_matrix_hex(const Matrix<double> &M, const string &name) {
+    cout << "===== Matrix: " << name << " (" << M.rows() << " x " << M.cols() << ") =====\n";
+    for (size_t r = 0; r < M.rows(); ++r) {
+        for (size_t c = 0; c < M.cols(); ++c) {
+            int8_t v = (int8_t)M(r, c);       // convert back to byte
             cout << "0x" << uppercase << hex << setw(2) << setfill('0') << (int)v;
-            if (c + 1 != M[r].size()) cout << ", ";
+            if (c + 1 != M.cols()) cout << ", ";
         }
         cout << "\n";
     }
@@ -107,13 +110,14 @@ void print_matrix_hex(const vector<vector<double>> &M, const string &name) {
 }
 
 // compute dot product of length COLS vectors
-inline double dot64(const vector<double> &a, const vector<double> &b) {
+inline double dot64(const double *a, const double *b) {
     double s = 0.0;
     for (int i = 0; i < COLS; ++i) s += a[i] * b[i];
     return s;
 }
 
 int main(int argc, char **argv) {
+    stats_init(argc, argv);
     ios::sync_with_stdio(false);
     cin.tie(nullptr);
 
@@ -143,21 +147,34 @@ int main(int argc, char **argv) {
 
         print_matrix_hex(Q, "Q");
 
+        // reuse a cached result when $AURA_CACHE_DIR is set
+        ResultCache cache;
+        CacheKey key("generate_output_fp64");
+        key.add(Q.flatten()).add(K.flatten()).add(V.flatten());
+        vector<double> cached;
+        if (cache.load(key, cached) && cached.size() == ROWS * COLS) {
+            cerr << "Using cached result " << key.hex() << "\n";
+            write_mem_matrix(outfile, Matrix<double>::from_flat(cached.data(), ROWS, COLS));
+            return 0;
+        }
 
         //fp64 output matrix
-        vector<vector<double>> O_floats(ROWS, vector<double>(COLS, 0));
+        Matrix<double> O_floats(ROWS, COLS);
         // Precompute nothing else; run attention: for each i in 0..ROWS-1
-        vector<vector<int8_t>> O_bytes(ROWS, vector<int8_t>(COLS, 0));
+        Matrix<int8_t> O_bytes(ROWS, COLS);
 
         // temp buffers
-        vector<double> scores(ROWS);
-        vector<double> weights(ROWS);
+        ScratchScope scratch;
+        double *scores = scratch.alloc<double>(ROWS);
+        double *weights = scratch.alloc<double>(ROWS);
 
         for (int i = 0; i < ROWS; ++i) {
+            StatScope scope("reference");
+            stats_count(STAT_ROWS, 1);
             // compute scores (Q[i] dot K[j]) * SCALE
             double max_score = -numeric_limits<double>::infinity();
             for (int j = 0; j < ROWS; ++j) {
-                double s = dot64(Q[i], K[j]) * SCALE;
+                double s = dot64(Q.row(i), K.row(j)) * SCALE;
                 scores[j] = s;
                 if (s > max_score) max_score = s;
             }
@@ -171,28 +188,22 @@ int main(int argc, char **argv) {
             if (sumexp == 0.0) sumexp = 1e-12;
             for (int j = 0; j < ROWS; ++j) weights[j] /= sumexp;
 
-            // weighted sum over V rows to form output vector of length COLS
-            vector<double> out(COLS, 0.0);
+            // weighted sum over V rows, straight into the (zeroed) output row
+            double *out = O_floats.row(i);
             for (int j = 0; j < ROWS; ++j) {
                 double w = weights[j];
                 if (w == 0.0) continue;
-                const auto &vj = V[j];
+                const double *vj = V.row(j);
                 for (int d = 0; d < COLS; ++d) out[d] += w * vj[d];
             }
 
-
-            //write to output float matrix
-            for (int d = 0; d < COLS; ++d) {
-                O_floats[i][d] = out[d];
-            }
-
             // quantize to [-128...127], round to nearest
             // for (int d = 0; d < COLS; ++d) {
             //     double v = out[d];
             //     long long iv = (long long)llround(v);
             //     if (iv < -128) iv = -128;
             //     if (iv > 127) iv = 127;
-            //     O_bytes[i][d] = (int8_t)iv;
+            //     O_bytes(i, d) = (int8_t)iv;
             // }
 
             if ((i % 64) == 0) cerr << "Computed row " << i << "/" << ROWS << "\n";
@@ -201,6 +212,7 @@ int main(int argc, char **argv) {
         cerr << "Writing " << outfile << " ...\n";
         write_mem_matrix(outfile, O_floats);
         // write_mem_matrix(outfile, O_bytes);
+        cache.store(key, O_floats.flatten());
         cerr << "Done. Output written to " << outfile << "\n";
     } catch (const exception &e) {
         cerr << "ERROR: " << e.what() << "\n";
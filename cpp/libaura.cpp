@@ -0,0 +1,175 @@
+#include "aura_capi.h"
+#include "aura_model.h"
+#include "aura_reference.h"
+#include "aura_metrics.h"
+#include "aura_fp8.h"
+
+// -----------------------------------------------------
+// C interface of the analysis library (see aura_capi.h).
+//
+// Thin wrappers over the header-only implementations the tools use, so a
+// caller holding tensors in memory (python/aura_lib.py over numpy / torch)
+// gets the same bits as the .mem round trip without the hex text. Exceptions
+// stop here and become AURA_ERROR plus a per-thread message.
+// -----------------------------------------------------
+
+static thread_local string last_error;
+
+template <class F>
+static int guarded(F fn) {
+    try {
+        fn();
+        return AURA_OK;
+    } catch (const exception &e) {
+        last_error = e.what();
+    } catch (...) {
+        last_error = "Unknown error";
+    }
+    return AURA_ERROR;
+}
+
+template <class T>
+static MatrixView<T> view(const aura_tensor &t, const char *name) {
+    if (!t.data && t.rows && t.cols) throw runtime_error(string(name) + " has no data");
+    if (t.stride && t.stride < t.cols) throw runtime_error(string(name) + " has a row stride below its width");
+    return MatrixView<T>((T *)t.data, t.rows, t.cols, t.stride);
+}
+
+// the fields of ABI 2 lie within the size the caller declared for its struct;
+// fields added later must be tested against s->size before use
+template <class S>
+static void check_struct(const S *s, size_t v2_size, const char *name) {
+    if (!s) throw runtime_error(string("No ") + name + " given");
+    if (s->size < v2_size)
+        throw runtime_error(string(name) + " size " + to_string(s->size) + " is below the " +
+                            to_string(v2_size) + " bytes of ABI version 2");
+}
+static const size_t MODEL_PARAMS_V2 = offsetof(aura_model_params, recip_iterations) + sizeof(int);
+static const size_t METRICS_V2 = offsetof(aura_metrics, passed) + sizeof(int);
+
+static void check_same_shape(const aura_tensor &a, const aura_tensor &b) {
+    if (a.rows != b.rows || a.cols != b.cols) throw runtime_error("Input and output shapes do not match");
+}
+
+// element-wise row by row; fn(in_row, out_row, cols)
+template <class In, class Out, class F>
+static void convert(const aura_tensor &in, const aura_tensor &out, F fn) {
+    check_same_shape(in, out);
+    auto src = view<const In>(in, "input");
+    auto dst = view<Out>(out, "output");
+    for (size_t i = 0; i < src.rows; ++i) fn(src.row(i), dst.row(i), src.cols);
+}
+
+static Fp8Format fp8_format(int format) {
+    if (format == AURA_FP8_E4M3) return Fp8Format::E4M3;
+    if (format == AURA_FP8_E5M2) return Fp8Format::E5M2;
+    throw runtime_error("Unknown FP8 format " + to_string(format));
+}
+
+template <class T>
+static void reference(const aura_tensor &Q, const aura_tensor &K, const aura_tensor &V, const aura_tensor &O,
+                      int threads) {
+    reference_attention<T>(view<const T>(Q, "Q"), view<const T>(K, "K"), view<const T>(V, "V"),
+                           view<T>(O, "O"), max(1, threads));
+}
+
+extern "C" {
+
+int aura_abi_version(void) { return AURA_ABI_VERSION; }
+
+const char *aura_last_error(void) { return last_error.c_str(); }
+
+int aura_model_defaults(aura_model_params *p) {
+    return guarded([&] {
+        check_struct(p, MODEL_PARAMS_V2, "model parameters");
+        ModelConfig d;
+        p->integer_width = d.integer_width;
+        p->embedding_dim = d.embedding_dim;
+        p->max_seq_length = d.max_seq_length;
+        p->rounding = d.rounding;
+        p->expmul_exp_i = d.expmul_exp_i;
+        p->log2e_guard_bits = d.log2e_guard_bits;
+        p->recip_bits = d.recip_bits;
+        p->recip_seed_bits = d.recip_seed_bits;
+        p->recip_iterations = d.recip_iterations;
+    });
+}
+
+int aura_quantize_q07(aura_tensor in_f32, aura_tensor out_i8) {
+    return guarded([&] {
+        convert<float, int8_t>(in_f32, out_i8, [](const float *a, int8_t *b, size_t n) {
+            for (size_t j = 0; j < n; ++j) b[j] = quantize_q07(a[j]);
+        });
+    });
+}
+
+int aura_dequantize_q07(aura_tensor in_i8, aura_tensor out_f32) {
+    return guarded([&] {
+        convert<int8_t, float>(in_i8, out_f32, [](const int8_t *a, float *b, size_t n) {
+            for (size_t j = 0; j < n; ++j) b[j] = float(a[j]) / float(AURA_Q_FACTOR);
+        });
+    });
+}
+
+int aura_fp32_to_fp8(aura_tensor in_f32, aura_tensor out_u8, int format) {
+    return guarded([&] {
+        Fp8Format fmt = fp8_format(format);
+        convert<float, uint8_t>(in_f32, out_u8,
+                                [&](const float *a, uint8_t *b, size_t n) { fp32_to_fp8_n(a, b, n, fmt); });
+    });
+}
+
+int aura_fp8_to_fp32(aura_tensor in_u8, aura_tensor out_f32, int format) {
+    return guarded([&] {
+        Fp8Format fmt = fp8_format(format);
+        convert<uint8_t, float>(in_u8, out_f32,
+                                [&](const uint8_t *a, float *b, size_t n) { fp8_to_fp32_n(a, b, n, fmt); });
+    });
+}
+
+int aura_reference_attention_f32(aura_tensor Q, aura_tensor K, aura_tensor V, aura_tensor O, int threads) {
+    return guarded([&] { reference<float>(Q, K, V, O, threads); });
+}
+
+int aura_reference_attention_f64(aura_tensor Q, aura_tensor K, aura_tensor V, aura_tensor O, int threads) {
+    return guarded([&] { reference<double>(Q, K, V, O, threads); });
+}
+
+int aura_model_attention(aura_tensor Q, aura_tensor K, aura_tensor V, aura_tensor O,
+                         const aura_model_params *params, int threads) {
+    return guarded([&] {
+        ModelConfig cfg;
+        if (params) {
+            check_struct(params, MODEL_PARAMS_V2, "model parameters");
+            cfg.integer_width = params->integer_width;
+            cfg.embedding_dim = params->embedding_dim;
+            cfg.max_seq_length = params->max_seq_length;
+            cfg.rounding = params->rounding;
+            cfg.expmul_exp_i = params->expmul_exp_i;
+            cfg.log2e_guard_bits = params->log2e_guard_bits;
+            cfg.recip_bits = params->recip_bits;
+            cfg.recip_seed_bits = params->recip_seed_bits;
+            cfg.recip_iterations = params->recip_iterations;
+            cfg.derive();
+        }
+        model_attention(view<const int8_t>(Q, "Q"), view<const int8_t>(K, "K"), view<const int8_t>(V, "V"),
+                        view<int8_t>(O, "O"), cfg, max(1, threads));
+    });
+}
+
+int aura_compare(aura_tensor ref, aura_tensor out, aura_metrics *m) {
+    return guarded([&] {
+        check_struct(m, METRICS_V2, "metrics");
+        Metrics r = compare_outputs(view<const int8_t>(ref, "reference"), view<const int8_t>(out, "output"));
+        m->total_elements = r.total_elements;
+        m->rows = r.rows;
+        m->mae = r.mae;
+        m->rmse = r.rmse;
+        m->max_abs_error = r.max_abs_error;
+        m->mean_rel_error = r.mean_rel_error;
+        m->top1_match = r.top1_match;
+        m->passed = r.passed();
+    });
+}
+
+} // extern "C"
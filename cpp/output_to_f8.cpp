@@ -9,6 +9,7 @@
 #include <cstdint>
 #include <stdio.h>
 #include <string.h>
+#include "aura_hex.h"
 
 using namespace std;
 
@@ -23,6 +24,8 @@ static constexpr double Q_FACTOR = 128;
 // Each FP32 is stored as 8 hex chars per value (big-endian)
 // ---------------------------
 std::vector<float> read_fp32_mem(const std::string &filename) {
+    StatScope scope("parse");
+    stats_count_file(filename);
     std::ifstream fin(filename);
     std::vector<float> data;
     std::string line;
@@ -55,6 +58,8 @@ std::vector<float> read_fp32_mem(const std::string &filename) {
 // Quantize FP32 -> int8 using symmetric quantization
 // ---------------------------
 std::vector<int8_t> quantize_fp32_to_int8(const std::vector<float>& data, float &scale_out) {
+    StatScope scope("quantize");
+    stats_count(STAT_ELEMENTS, data.size());
     
     // float max_abs = 0.0f;
     // for (float x : data) max_abs = std::max(max_abs, std::fabs(x));
@@ -82,7 +87,7 @@ std::vector<int8_t> quantize_fp32_to_int8(const std::vector<float>& data, float
 
 
 void write_int8_mem(const std::vector<int8_t>& data, const std::string &filename, size_t row_length = 8) {
-    std::ofstream fout(filename);
+    HexWriter out(filename, ROWS * LINES_PER_ROW * 17);
     // for (size_t i = 0; i < data.size(); i++) {
     //     fout << std::hex << std::uppercase << std::setw(2) << std::setfill('0') << (int)data[i];
     //     if ((i+1) % row_length == 0) fout << "\n";
@@ -96,33 +101,38 @@ void write_int8_mem(const std::vector<int8_t>& data, const std::string &filename
                 packed |= (byte & 0xFFULL) << (8*b); // LSB-first
             }
             // print as 16 hex chars uppercase
-            std::ostringstream ss;
-            ss << std::uppercase << std::hex << std::setfill('0') << std::setw(16) << packed;
-            fout << ss.str() << '\n';
+            out.word64(packed);
         }
     }
+    out.close();
 }
 
 // ---------------------------
 // Main pipeline
 // ---------------------------
-int main() {
-    struct FilePair { std::string fp32; std::string int8; };
-    std::vector<FilePair> files = {
-        {"../mem/O_32.mem", "../mem/O_8.mem"}
-    };
-
-    for (auto &fp : files) {
-        std::cout << "Processing " << fp.fp32 << " ..." << std::endl;
-        auto data_fp32 = read_fp32_mem(fp.fp32);
-        //printf("%f   ", data_fp32[0]);
-
-        float scale;
-        auto data_int8 = quantize_fp32_to_int8(data_fp32, scale);
-        std::cout << "Scale factor used: " << scale << std::endl;
-
-        write_int8_mem(data_int8, fp.int8);
-        std::cout << "Written " << fp.int8 << std::endl;
+int main(int argc, char **argv) {
+    stats_init(argc, argv);
+    try {
+        struct FilePair { std::string fp32; std::string int8; };
+        std::vector<FilePair> files = {
+            {"../mem/O_32.mem", "../mem/O_8.mem"}
+        };
+
+        for (auto &fp : files) {
+            std::cout << "Processing " << fp.fp32 << " ..." << std::endl;
+            auto data_fp32 = read_fp32_mem(fp.fp32);
+            //printf("%f   ", data_fp32[0]);
+
+            float scale;
+            auto data_int8 = quantize_fp32_to_int8(data_fp32, scale);
+            std::cout << "Scale factor used: " << scale << std::endl;
+
+            write_int8_mem(data_int8, fp.int8);
+            std::cout << "Written " << fp.int8 << std::endl;
+        }
+    } catch (const std::exception &e) {
+        std::cerr << "ERROR: " << e.what() << "\n";
+        return 1;
     }
 
     std::cout << "All files processed!" << std::endl;
@@ -1,4 +1,5 @@
 #include <bits/stdc++.h>
+#include "aura_matrix.h"
 using namespace std;
 
 static constexpr int ROWS = 512;
@@ -18,7 +19,9 @@ static constexpr double THRESHOLD_TOP1_MATCH = 0.95;
 // ======================================================
 // Read 16-bit packed .mem file → ROWS × COLS matrix
 // ======================================================
-vector<vector<int16_t>> read_mem_matrix(const string &filename) {
+Matrix<int16_t> read_mem_matrix(const string &filename) {
+    StatScope scope("parse");
+    stats_count_file(filename);
     ifstream ifs(filename);
     if (!ifs) throw runtime_error("Cannot open " + filename);
 
@@ -43,11 +46,11 @@ vector<vector<int16_t>> read_mem_matrix(const string &filename) {
     if ((int)lines.size() != ROWS * LINES_PER_ROW)
         throw runtime_error("Incorrect line count");
 
-    vector<vector<int16_t>> M(ROWS, vector<int16_t>(COLS));
+    Matrix<int16_t> M(ROWS, COLS);
 
     for (int r = 0; r < ROWS; ++r) {
         int base_line = r * LINES_PER_ROW;
-        int out_index = 0;
+        int16_t *out = M.row(r);
 
         for (int l = 0; l < LINES_PER_ROW; ++l) {
             uint64_t val = lines[base_line + l];
@@ -56,7 +59,7 @@ vector<vector<int16_t>> read_mem_matrix(const string &filename) {
             for (int e = 0; e < ELTS_PER_LINE; ++e) {
                 uint16_t raw = (val >> (16 * e)) & 0xFFFF;
                 int16_t signed_val = static_cast<int16_t>(raw);
-                M[r][out_index++] = signed_val;
+                *out++ = signed_val;
             }
         }
     }
@@ -67,10 +70,11 @@ vector<vector<int16_t>> read_mem_matrix(const string &filename) {
 // ======================================================
 // Compute precision/error metrics
 // ======================================================
-void compare_outputs(const vector<vector<int16_t>> &ref,
-                     const vector<vector<int16_t>> &asic)
+void compare_outputs(const Matrix<int16_t> &ref,
+                     const Matrix<int16_t> &asic)
 {
-    if (ref.size() != asic.size() || ref[0].size() != asic[0].size())
+    StatScope scope("compare");
+    if (ref.rows() != asic.rows() || ref.cols() != asic.cols())
         throw runtime_error("Matrix dimensions do not match");
 
     double mae = 0.0;
@@ -80,8 +84,8 @@ void compare_outputs(const vector<vector<int16_t>> &ref,
 
     for (int r = 0; r < ROWS; ++r) {
         for (int c = 0; c < COLS; ++c) {
-            int a = asic[r][c];
-            int f = ref[r][c];
+            int a = asic(r, c);
+            int f = ref(r, c);
             int err = abs(a - f);
             mae += err;
             rmse += err * err;
@@ -98,9 +102,9 @@ void compare_outputs(const vector<vector<int16_t>> &ref,
 
     for (int r = 0; r < ROWS; ++r) {
         for (int c = 0; c < COLS; ++c) {
-            int f = ref[r][c];
+            int f = ref(r, c);
             if (f != 0) {
-                int16_t a = asic[r][c];
+                int16_t a = asic(r, c);
                 sum_rel += abs(a - f) / abs(double(f)); //max(abs(f), abs(a));
                 count_rel++;
             }
@@ -112,8 +116,8 @@ void compare_outputs(const vector<vector<int16_t>> &ref,
     // top-1 match
     int top1_match = 0;
     for (int r = 0; r < ROWS; ++r) {
-        int ref_idx = max_element(ref[r].begin(), ref[r].end()) - ref[r].begin();
-        int asic_idx = max_element(asic[r].begin(), asic[r].end()) - asic[r].begin();
+        int ref_idx = max_element(ref.row(r), ref.row(r) + COLS) - ref.row(r);
+        int asic_idx = max_element(asic.row(r), asic.row(r) + COLS) - asic.row(r);
         if (ref_idx == asic_idx) top1_match++;
     }
     double top1_ratio = top1_match / double(ROWS);
@@ -138,13 +142,19 @@ void compare_outputs(const vector<vector<int16_t>> &ref,
 }
 
 int main(int argc, char** argv) {
+    stats_init(argc, argv);
     if (argc != 3) {
         cerr << "Usage: " << argv[0] << " reference.mem asic_output.mem\n";
         return 1;
     }
 
-    auto ref  = read_mem_matrix(argv[1]);
-    auto asic = read_mem_matrix(argv[2]);
+    try {
+        auto ref  = read_mem_matrix(argv[1]);
+        auto asic = read_mem_matrix(argv[2]);
 
-    compare_outputs(ref, asic);
+        compare_outputs(ref, asic);
+    } catch (const exception &e) {
+        cerr << "ERROR: " << e.what() << "\n";
+        return 1;
+    }
 }
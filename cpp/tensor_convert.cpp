@@ -0,0 +1,197 @@
+#include "aura_mem.h"
+#include "aura_tensor.h"
+#include "aura_import.h"
+
+// -----------------------------------------------------
+// Conversions between the text .mem files and binary .bin tensors, random
+// long-sequence inputs that would not fit in a .mem file, slices of
+// .npy / .safetensors activation dumps (aura_import.h), and the compressed
+// .bin variant (aura_codec.h).
+// -----------------------------------------------------
+
+static constexpr size_t CHUNK_ROWS = 16384;
+
+static void usage(const char *prog) {
+    cerr << "Usage:\n"
+         << "  " << prog << " mem2bin <fp32|int8> <input.mem> <output.bin>\n"
+         << "  " << prog << " bin2mem <input.bin> <output.mem>\n"
+         << "  " << prog << " random <fp32|int8> <rows> <seed> <output.bin>\n"
+         << "  " << prog << " import <fp32|int8> <FILE[:TENSOR][INDEX]> <output.bin|output.mem>\n"
+         << "  " << prog << " compress <input.bin> <output.bin> [block_rows]\n"
+         << "  " << prog << " decompress <input.bin> <output.bin>\n"
+         << "  " << prog << " info <input.bin|input.npy|input.safetensors>\n";
+}
+
+static void mem2bin(TensorDType dtype, const string &in, const string &out) {
+    if (dtype == TensorDType::INT8_Q07) {
+        auto data = read_int8_mem(in);
+        write_tensor(out, dtype, data.size() / AURA_DK, AURA_DK, data);
+    } else if (dtype == TensorDType::FP32) {
+        auto data = read_fp32_mem(in);
+        write_tensor(out, dtype, data.size() / AURA_DK, AURA_DK, data);
+    } else {
+        throw runtime_error("mem2bin supports int8 and fp32");
+    }
+}
+
+static void bin2mem(const string &in, const string &out) {
+    MappedTensor t(in);
+    if (t.cols() != (size_t)AURA_DK) throw runtime_error(".mem files need 64 columns");
+    if (t.dtype() == TensorDType::INT8_Q07) {
+        vector<int8_t> data(t.rows() * t.cols());
+        t.read_raw_rows(0, t.rows(), data.data());
+        write_int8_mem(out, data);
+    } else {
+        vector<float> data(t.rows() * t.cols());
+        t.read_rows(0, t.rows(), data.data());
+        write_fp32_mem(out, data);
+    }
+}
+
+// a .npy / .safetensors slice to a .bin tensor, or to a .mem file when 64 wide
+static void import_tensor(TensorDType dtype, const string &spec, const string &out) {
+    size_t cols;
+    auto data = read_tensor_spec<float>(spec, &cols);
+    const size_t rows = data.size() / cols;
+    const bool mem = TensorFile::ends_with(out, ".mem");
+    if (mem && cols != (size_t)AURA_DK) throw runtime_error(".mem files need 64 columns");
+    if (dtype == TensorDType::INT8_Q07) {
+        auto q = quantize_q07(data);
+        if (mem) write_int8_mem(out, q);
+        else write_tensor(out, dtype, rows, cols, q);
+    } else if (dtype == TensorDType::FP32) {
+        if (mem) write_fp32_mem(out, data);
+        else write_tensor(out, dtype, rows, cols, data);
+    } else {
+        throw runtime_error("import supports int8 and fp32");
+    }
+}
+
+static void info(const string &in) {
+    if (!is_tensor_spec(in)) {
+        MappedTensor t(in);
+        cout << in << ": " << dtype_name(t.dtype()) << " " << t.rows() << " x " << t.cols();
+        if (t.compressed())
+            cout << ", compressed, " << t.num_blocks() << " blocks of " << t.block_rows() << " rows, "
+                 << fixed << setprecision(3) << (double)(t.rows() * t.cols() * t.elem_size()) / t.stored_bytes()
+                 << "x" << defaultfloat;
+        cout << "\n";
+        return;
+    }
+    TensorFile f(in);
+    for (const auto &t : f.tensors()) {
+        cout << (t.name.empty() ? in : t.name) << ": " << import_dtype_name(t.dtype) << " [";
+        for (size_t d = 0; d < t.shape.size(); ++d) cout << (d ? ", " : "") << t.shape[d];
+        cout << "]\n";
+    }
+}
+
+// Re-encodes a .bin tensor with the block codec, checks that it decodes back
+// exactly, and reports the ratio and the single-core decode throughput.
+static void compress(const string &in, const string &out, size_t block_rows) {
+    MappedTensor t(in);
+    const size_t row = t.cols() * t.elem_size(), raw = t.rows() * row;
+    {
+        CompressedTensorWriter w(out, t.dtype(), t.rows(), t.cols(), block_rows);
+        vector<uint8_t> buf;
+        for (size_t r = 0; r < t.rows(); r += CHUNK_ROWS) {
+            size_t n = min(CHUNK_ROWS, t.rows() - r);
+            buf.resize(n * row);
+            t.read_raw_rows(r, n, buf.data());
+            w.append_rows(n, buf.data());
+        }
+        w.finish();
+    }
+
+    MappedTensor c(out);
+    aligned_vector<uint8_t> orig(block_rows * row), dec(block_rows * row);
+    for (size_t b = 0; b < c.num_blocks(); ++b) {
+        size_t r0 = b * block_rows, n = min(block_rows, t.rows() - r0);
+        t.read_raw_rows(r0, n, orig.data());
+        c.decode_block(b, dec.data());
+        if (memcmp(orig.data(), dec.data(), n * row) != 0)
+            throw runtime_error("Block " + to_string(b) + " of " + out + " does not decode to the input");
+    }
+
+    // decode throughput: whole passes over the tensor until 0.2 s have passed
+    int passes = 0;
+    auto start = chrono::steady_clock::now();
+    double seconds = 0;
+    do {
+        for (size_t b = 0; b < c.num_blocks(); ++b) c.decode_block(b, dec.data());
+        ++passes;
+        seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+    } while (seconds < 0.2);
+
+    cout << out << ": " << raw << " -> " << c.stored_bytes() << " bytes (" << fixed << setprecision(3)
+         << (double)raw / max<size_t>(c.stored_bytes(), 1) << "x), decode " << setprecision(2)
+         << (double)raw * passes / seconds / 1e9 << " GB/s on one core (" << codec_isa_name(codec_isa()) << ")\n" << defaultfloat;
+}
+
+static void decompress(const string &in, const string &out) {
+    MappedTensor t(in);
+    TensorWriter w(out, t.dtype(), t.rows(), t.cols());
+    vector<uint8_t> buf;
+    for (size_t r = 0; r < t.rows(); r += CHUNK_ROWS) {
+        size_t n = min(CHUNK_ROWS, t.rows() - r);
+        buf.resize(n * t.cols() * t.elem_size());
+        t.read_raw_rows(r, n, buf.data());
+        w.write_rows(r, n, buf.data());
+    }
+}
+
+// N(0, 0.25) values, roughly the spread of the extracted BERT Q/K/V
+static void random_tensor(TensorDType dtype, size_t rows, uint64_t seed, const string &out) {
+    TensorWriter w(out, dtype, rows, AURA_DK);
+    mt19937_64 rng(seed);
+    normal_distribution<float> dist(0.0f, 0.25f);
+    vector<float> f32;
+    vector<int8_t> i8;
+    for (size_t r = 0; r < rows; r += CHUNK_ROWS) {
+        size_t n = min(CHUNK_ROWS, rows - r);
+        f32.resize(n * AURA_DK);
+        for (auto &x : f32) x = dist(rng);
+        if (dtype == TensorDType::INT8_Q07) {
+            i8 = quantize_q07(f32);
+            w.write_rows(r, n, i8.data());
+        } else if (dtype == TensorDType::FP32) {
+            w.write_rows(r, n, f32.data());
+        } else {
+            throw runtime_error("random supports int8 and fp32");
+        }
+    }
+}
+
+int main(int argc, char **argv) {
+    stats_init(argc, argv);
+    if (argc < 3) {
+        usage(argv[0]);
+        return 1;
+    }
+
+    try {
+        string cmd = argv[1];
+        if (cmd == "mem2bin" && argc == 5) {
+            mem2bin(parse_dtype(argv[2]), argv[3], argv[4]);
+        } else if (cmd == "bin2mem" && argc == 4) {
+            bin2mem(argv[2], argv[3]);
+        } else if (cmd == "random" && argc == 6) {
+            random_tensor(parse_dtype(argv[2]), stoull(argv[3]), stoull(argv[4]), argv[5]);
+        } else if (cmd == "import" && argc == 5) {
+            import_tensor(parse_dtype(argv[2]), argv[3], argv[4]);
+        } else if (cmd == "compress" && (argc == 4 || argc == 5)) {
+            compress(argv[2], argv[3], argc == 5 ? max<size_t>(1, stoull(argv[4])) : 64);
+        } else if (cmd == "decompress" && argc == 4) {
+            decompress(argv[2], argv[3]);
+        } else if (cmd == "info" && argc == 3) {
+            info(argv[2]);
+        } else {
+            usage(argv[0]);
+            return 1;
+        }
+    } catch (const exception &e) {
+        cerr << "ERROR: " << e.what() << "\n";
+        return 1;
+    }
+    return 0;
+}
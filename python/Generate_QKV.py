@@ -17,6 +17,12 @@ parser.add_argument("--seq", type=int, default=512,
                     help="Sequence length (default: 512)")
 parser.add_argument("--head", type=int, default=0,
                     help="Attention head index (default: 0)")
+parser.add_argument("--evaluate", action="store_true",
+                    help="run every head of --layers through cpp/libaura.so in memory instead of writing files")
+parser.add_argument("--layers", type=str, default="0",
+                    help="comma-separated encoder layers for --evaluate (default: 0)")
+parser.add_argument("--guard-bits", type=int, default=0,
+                    help="extra Log2Exp fraction bits of the model for --evaluate (default: 0)")
 args = parser.parse_args()
 
 MODEL_NAME = args.model
@@ -24,7 +30,6 @@ SEQ_LEN = args.seq
 HEAD_IDX = args.head
 
 OUT_DIR = f"models/{MODEL_NAME}"
-os.makedirs(OUT_DIR, exist_ok=True)
 
 OUTPUT_FILES = [
     f"{OUT_DIR}/Q32.mem",
@@ -32,8 +37,13 @@ OUTPUT_FILES = [
     f"{OUT_DIR}/V32.mem"
 ]
 
-print(f"[INFO] Generating Q/K/V for test '{MODEL_NAME}' into directory: {OUT_DIR}")
-print(f"[INFO] Model: {MODEL_NAME}, Seq Len: {SEQ_LEN}, Head: {HEAD_IDX}")
+if args.evaluate:
+    print(f"[INFO] Evaluating every head of layers {args.layers} of '{MODEL_NAME}' in memory")
+    print(f"[INFO] Model: {MODEL_NAME}, Seq Len: {SEQ_LEN}")
+else:
+    os.makedirs(OUT_DIR, exist_ok=True)
+    print(f"[INFO] Generating Q/K/V for test '{MODEL_NAME}' into directory: {OUT_DIR}")
+    print(f"[INFO] Model: {MODEL_NAME}, Seq Len: {SEQ_LEN}, Head: {HEAD_IDX}")
 
 # -----------------------------
 # Helper: write FP32 values as hex
@@ -70,11 +80,10 @@ tokens = tokenizer(text, return_tensors="pt",
 input_ids = tokens["input_ids"]
 
 # -----------------------------
-# Extract Q/K/V from first encoder layer
+# Extract Q/K/V from an encoder layer
 # -----------------------------
-attn_layer = model.encoder.layer[0].attention.self
-
-def extract_qkv(x):
+def extract_qkv(x, layer=0):
+    attn_layer = model.encoder.layer[layer].attention.self
     B, T, H = x.shape
     head_dim = attn_layer.query.out_features // attn_layer.num_attention_heads
 
@@ -83,6 +92,26 @@ def extract_qkv(x):
     V = attn_layer.value(x).view(B, T, attn_layer.num_attention_heads, head_dim)
     return Q, K, V
 
+# -----------------------------
+# In-memory evaluation: [T, heads, head_dim] tensors go to the library as
+# strided views, one head at a time, without files or copies
+# -----------------------------
+if args.evaluate:
+    import aura_lib
+
+    params = aura_lib.default_params(log2e_guard_bits=args.guard_bits)
+    print("[INFO] Running model forward pass...")
+    with torch.no_grad():
+        hidden = model(input_ids, output_hidden_states=True).hidden_states
+        print(f"{'layer':>5} {'head':>4} {'MAE':>8} {'RMSE':>8} {'max':>4} {'top-1':>6}  result")
+        for layer in (int(l) for l in args.layers.split(",")):
+            Q, K, V = (t[0].cpu().numpy() for t in extract_qkv(hidden[layer], layer))
+            for h in range(Q.shape[1]):
+                m = aura_lib.evaluate(Q[:, h, :], K[:, h, :], V[:, h, :], params, os.cpu_count() or 1)
+                print(f"{layer:>5} {h:>4} {m['mae']:>8.4f} {m['rmse']:>8.4f} {m['max_abs_error']:>4} "
+                      f"{m['top1_ratio']:>6.3f}  {'PASS' if m['passed'] else 'FAIL'}")
+    raise SystemExit(0)
+
 print("[INFO] Running model forward pass...")
 with torch.no_grad():
     embeddings = model.embeddings(input_ids)
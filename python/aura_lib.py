@@ -0,0 +1,175 @@
+#!/usr/bin/env python3
+# ctypes binding of cpp/libaura.so (cpp/aura_capi.h), build it with 'make cpp_tools'.
+#
+# Every function takes 2-D numpy arrays and hands their memory to the library
+# as is: any row stride works, so one head of a [tokens, heads, dk] activation
+# (x[:, h, :], or torch_tensor[0, :, h, :].numpy()) is passed without a copy.
+# Only the element stride has to be 1. Outputs are allocated here unless given.
+
+import ctypes
+import os
+
+import numpy as np
+
+ABI_VERSION = 2
+
+FP8_E4M3 = 0
+FP8_E5M2 = 1
+
+
+class _Tensor(ctypes.Structure):
+    _fields_ = [("data", ctypes.c_void_p),
+                ("rows", ctypes.c_size_t),
+                ("cols", ctypes.c_size_t),
+                ("stride", ctypes.c_size_t)]
+
+
+class _Sized(ctypes.Structure):
+    # the leading size field of the library's structs, set to this layout's size
+    def __init__(self, *args, **kwargs):
+        super().__init__(ctypes.sizeof(type(self)), *args, **kwargs)
+
+
+class ModelParams(_Sized):
+    _fields_ = [("size", ctypes.c_size_t)] + [(name, ctypes.c_int) for name in (
+        "integer_width", "embedding_dim", "max_seq_length", "rounding", "expmul_exp_i",
+        "log2e_guard_bits", "recip_bits", "recip_seed_bits", "recip_iterations")]
+
+
+class _Metrics(_Sized):
+    _fields_ = [("size", ctypes.c_size_t),
+                ("total_elements", ctypes.c_int),
+                ("rows", ctypes.c_int),
+                ("mae", ctypes.c_double),
+                ("rmse", ctypes.c_double),
+                ("max_abs_error", ctypes.c_int),
+                ("mean_rel_error", ctypes.c_double),
+                ("top1_match", ctypes.c_int),
+                ("passed", ctypes.c_int)]
+
+
+def _load():
+    here = os.path.dirname(os.path.abspath(__file__))
+    path = os.environ.get("AURA_LIB", os.path.join(here, "..", "cpp", "libaura.so"))
+    lib = ctypes.CDLL(path)
+    if lib.aura_abi_version() != ABI_VERSION:
+        raise RuntimeError(f"{path}: ABI version {lib.aura_abi_version()}, expected {ABI_VERSION}")
+    lib.aura_last_error.restype = ctypes.c_char_p
+    T = _Tensor
+    for name, args in (("aura_quantize_q07", [T, T]),
+                       ("aura_dequantize_q07", [T, T]),
+                       ("aura_fp32_to_fp8", [T, T, ctypes.c_int]),
+                       ("aura_fp8_to_fp32", [T, T, ctypes.c_int]),
+                       ("aura_reference_attention_f32", [T, T, T, T, ctypes.c_int]),
+                       ("aura_reference_attention_f64", [T, T, T, T, ctypes.c_int]),
+                       ("aura_model_attention", [T, T, T, T, ctypes.POINTER(ModelParams), ctypes.c_int]),
+                       ("aura_compare", [T, T, ctypes.POINTER(_Metrics)]),
+                       ("aura_model_defaults", [ctypes.POINTER(ModelParams)])):
+        fn = getattr(lib, name)
+        fn.argtypes = args
+        fn.restype = ctypes.c_int
+    return lib
+
+
+_lib = _load()
+
+
+def _check(status):
+    if status != 0:
+        raise RuntimeError(_lib.aura_last_error().decode())
+
+
+def _tensor(a, dtype, name):
+    if not isinstance(a, np.ndarray) or a.ndim != 2:
+        raise ValueError(f"{name} must be a 2-D numpy array")
+    if a.dtype != dtype:
+        raise ValueError(f"{name} must be {np.dtype(dtype).name}, got {a.dtype.name}")
+    item = a.itemsize
+    if a.shape[0] and a.shape[1] and (a.strides[1] != item or a.strides[0] < 0 or a.strides[0] % item):
+        raise ValueError(f"{name} rows must be contiguous (take a copy with np.ascontiguousarray)")
+    stride = a.strides[0] // item if a.shape[0] > 1 else a.shape[1]
+    return _Tensor(a.ctypes.data, a.shape[0], a.shape[1], stride)
+
+
+def _output(out, shape, dtype):
+    if out is None:
+        return np.empty(shape, dtype=dtype)
+    if not out.flags.writeable:
+        raise ValueError("output array is read-only")
+    return out
+
+
+def default_params(**overrides):
+    """ModelParams with the RTL defaults, any field overridden by keyword."""
+    p = ModelParams()
+    _check(_lib.aura_model_defaults(ctypes.byref(p)))
+    for key, value in overrides.items():
+        if key == "size" or not hasattr(p, key):
+            raise ValueError(f"unknown model parameter '{key}'")
+        setattr(p, key, value)
+    return p
+
+
+def quantize(x, out=None):
+    """fp32 -> Q0.7 int8 (round, clamp), what fp32_to_f8 writes to Q.mem."""
+    out = _output(out, x.shape, np.int8)
+    _check(_lib.aura_quantize_q07(_tensor(x, np.float32, "input"), _tensor(out, np.int8, "output")))
+    return out
+
+
+def dequantize(q, out=None):
+    out = _output(out, q.shape, np.float32)
+    _check(_lib.aura_dequantize_q07(_tensor(q, np.int8, "input"), _tensor(out, np.float32, "output")))
+    return out
+
+
+def to_fp8(x, fmt=FP8_E4M3, out=None):
+    out = _output(out, x.shape, np.uint8)
+    _check(_lib.aura_fp32_to_fp8(_tensor(x, np.float32, "input"), _tensor(out, np.uint8, "output"), fmt))
+    return out
+
+
+def from_fp8(c, fmt=FP8_E4M3, out=None):
+    out = _output(out, c.shape, np.float32)
+    _check(_lib.aura_fp8_to_fp32(_tensor(c, np.uint8, "input"), _tensor(out, np.float32, "output"), fmt))
+    return out
+
+
+def reference(Q, K, V, threads=1, out=None):
+    """Floating point attention in the precision of Q (float32 or float64)."""
+    dtype = Q.dtype
+    fn = {np.dtype(np.float32): _lib.aura_reference_attention_f32,
+          np.dtype(np.float64): _lib.aura_reference_attention_f64}.get(dtype)
+    if fn is None:
+        raise ValueError(f"reference needs float32 or float64 inputs, got {dtype.name}")
+    out = _output(out, Q.shape, dtype)
+    _check(fn(_tensor(Q, dtype, "Q"), _tensor(K, dtype, "K"), _tensor(V, dtype, "V"),
+              _tensor(out, dtype, "O"), threads))
+    return out
+
+
+def model(Q, K, V, params=None, threads=1, out=None):
+    """Bit-accurate fixed-point attention of Q0.7 inputs (ModelParams, None = RTL)."""
+    out = _output(out, Q.shape, np.int8)
+    _check(_lib.aura_model_attention(_tensor(Q, np.int8, "Q"), _tensor(K, np.int8, "K"),
+                                     _tensor(V, np.int8, "V"), _tensor(out, np.int8, "O"),
+                                     ctypes.byref(params) if params is not None else None, threads))
+    return out
+
+
+def compare(ref, out):
+    """precision_measure metrics of out against ref (both Q0.7), as a dict."""
+    m = _Metrics()
+    _check(_lib.aura_compare(_tensor(ref, np.int8, "reference"), _tensor(out, np.int8, "output"),
+                             ctypes.byref(m)))
+    result = {name: getattr(m, name) for name, _ in _Metrics._fields_ if name != "size"}
+    result["top1_ratio"] = m.top1_match / m.rows if m.rows else 0.0
+    result["passed"] = bool(m.passed)
+    return result
+
+
+def evaluate(Q, K, V, params=None, threads=1):
+    """aura_pipeline on fp32 Q/K/V: the model against the quantized fp32 reference."""
+    Qq, Kq, Vq = quantize(Q), quantize(K), quantize(V)
+    O_ref = quantize(reference(Q, K, V, threads))
+    return compare(O_ref, model(Qq, Kq, Vq, params, threads))